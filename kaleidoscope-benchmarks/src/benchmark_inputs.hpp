@@ -0,0 +1,196 @@
+#pragma once
+
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+
+// Deterministic generators of synthetic Kaleidoscope sources.
+// Every generator appends fragments until the requested size is reached.
+
+[[nodiscard]] inline std::string MakeIdentifier(std::mt19937& rng)
+{
+    constexpr std::string_view head_chars = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ_";
+    constexpr std::string_view tail_chars = "abcdefghijklmnopqrstuvwxyz_0123456789";
+
+    std::string identifier;
+    identifier.push_back(head_chars[rng() % head_chars.size()]);
+    const size_t length = rng() % 12;
+    for (size_t i = 0; i != length; ++i)
+    {
+        identifier.push_back(tail_chars[rng() % tail_chars.size()]);
+    }
+
+    return identifier;
+}
+
+// Mostly identifiers and keywords separated by operators and spaces
+[[nodiscard]] inline std::string MakeIdentifierHeavySource(size_t size, uint32_t seed = 42)
+{
+    constexpr std::array<std::string_view, 4> keywords{"def", "extern", "def", "extern"};
+    constexpr std::string_view separators = " +-*/\n";
+
+    std::mt19937 rng(seed);
+    std::string source;
+    source.reserve(size + 32);
+    while (source.size() < size)
+    {
+        if (rng() % 8 == 0)
+        {
+            source += keywords[rng() % keywords.size()];
+        }
+        else
+        {
+            source += MakeIdentifier(rng);
+        }
+
+        source.push_back(' ');
+        source.push_back(separators[rng() % separators.size()]);
+        source.push_back(' ');
+    }
+
+    return source;
+}
+
+// Identifiers mixed with numbers, string literals and comments of various lengths
+[[nodiscard]] inline std::string MakeMixedSource(size_t size, uint32_t seed = 42)
+{
+    constexpr std::array<std::string_view, 8> fragments{
+        "42 ",
+        "0x1F ",
+        "1.5e3 ",
+        " + ",
+        "\"string \\\" literal\" ",
+        "// line comment\n",
+        "/* block\n comment */ ",
+        "\n",
+    };
+
+    std::mt19937 rng(seed);
+    std::string source;
+    source.reserve(size + 32);
+    while (source.size() < size)
+    {
+        if (rng() % 2 == 0)
+        {
+            source += MakeIdentifier(rng);
+            source.push_back(' ');
+        }
+        else
+        {
+            source += fragments[rng() % fragments.size()];
+        }
+    }
+
+    return source;
+}
+
+inline void AppendInteger(std::string& out, uint32_t value, int base = 10)
+{
+    std::array<char, 32> buffer{};
+    const auto result = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value, base);
+    out.append(buffer.data(), result.ptr);
+}
+
+// Numeric literals of all kinds separated by operators and spaces
+[[nodiscard]] inline std::string MakeNumberHeavySource(size_t size, uint32_t seed = 42)
+{
+    constexpr std::string_view separators = " +-*/\n";
+
+    std::mt19937 rng(seed);
+    std::string source;
+    source.reserve(size + 64);
+    while (source.size() < size)
+    {
+        const uint32_t value = rng();
+        switch (rng() % 8)
+        {
+        case 0:
+            source += "0x";
+            AppendInteger(source, value, 16);
+            break;
+        case 1:
+            source += "0b";
+            AppendInteger(source, value & 0xFFFF, 2);
+            break;
+        case 2:
+            source += "0";
+            AppendInteger(source, value, 8);
+            break;
+        case 3:
+            AppendInteger(source, value % 1000);
+            source += ".";
+            AppendInteger(source, value % 97);
+            break;
+        case 4:
+            AppendInteger(source, value % 1000);
+            source += "e-";
+            AppendInteger(source, value % 30);
+            break;
+        default:
+            AppendInteger(source, value);
+            break;
+        }
+
+        source.push_back(' ');
+        source.push_back(separators[rng() % separators.size()]);
+        source.push_back(' ');
+    }
+
+    return source;
+}
+
+// Long license-like block comments and line comments with a little code in between
+[[nodiscard]] inline std::string MakeCommentHeavySource(size_t size, uint32_t seed = 42)
+{
+    constexpr std::string_view license_line = " * Permission is hereby granted, free of charge, to any person (x * y)\n";
+
+    std::mt19937 rng(seed);
+    std::string source;
+    source.reserve(size + 4096);
+    while (source.size() < size)
+    {
+        source += "/*\n";
+        const size_t lines = 10 + rng() % 30;
+        for (size_t i = 0; i != lines; ++i) source += license_line;
+        source += " */\n";
+
+        const size_t line_comments = rng() % 8;
+        for (size_t i = 0; i != line_comments; ++i)
+        {
+            source += "// ";
+            source.append(20 + rng() % 60, 'c');
+            source += '\n';
+            source += MakeIdentifier(rng);
+            source += " + 1\n";
+        }
+    }
+
+    return source;
+}
+
+// Long string literals with occasional escaped quotes, like embedded data
+[[nodiscard]] inline std::string MakeStringHeavySource(size_t size, uint32_t seed = 42)
+{
+    constexpr std::string_view payload = "SGVsbG8sIFdvcmxkIQ0KVGhpcyBpcyBiYXNlNjQgZGF0YQ==";
+
+    std::mt19937 rng(seed);
+    std::string source;
+    source.reserve(size + 4096);
+    while (source.size() < size)
+    {
+        source += MakeIdentifier(rng);
+        source += " + \"";
+        const size_t chunks = 1 + rng() % 40;
+        for (size_t i = 0; i != chunks; ++i)
+        {
+            source += payload;
+            if (rng() % 4 == 0) source += "\\\"";
+        }
+        source += "\"\n";
+    }
+
+    return source;
+}
@@ -0,0 +1,113 @@
+#include <sys/wait.h>
+
+#include <cstdio>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "kaleidoscope/codegen/bytecode_vm.hpp"
+#include "kaleidoscope/codegen/llvm_ir_codegen.hpp"
+#include "kaleidoscope/parser/parser.hpp"
+
+using namespace kaleidoscope;  // NOLINT
+
+namespace
+{
+
+// Same expression as in orc_jit_benchmarks.cpp and x86_64_codegen_benchmarks.cpp
+constexpr std::string_view kSource = "(1 + 2) * (3 + 4) - 10 / (2 + 3)";
+
+// Interpreter used by IRExpressionExecutor in tests. The program reads the module from stdin.
+constexpr const char* kLLICommand = "lli-18 > /dev/null 2>&1";
+
+class ParsedExpression
+{
+public:
+    explicit ParsedExpression(std::string_view source)
+    {
+        Lexer l(source);
+        LookaheadLexer<2> lexer(l);
+        const auto r = parser.ParseExpression(lexer);
+        if (!r.has_value()) std::abort();
+        root = *r;
+    }
+
+    Parser parser;
+    ExprId root{};
+};
+
+[[nodiscard]] std::string MakeLargeSource(size_t terms)
+{
+    std::string source = "1";
+    for (size_t i = 0; i != terms; ++i) source += i % 3 == 0 ? " * (2 + 3)" : " - 4 / 5";
+    return source;
+}
+
+// Lowering, verification and the run: what one evaluation of a new expression costs
+void BM_BytecodeExec(benchmark::State& state)
+{
+    const ParsedExpression expression(kSource);
+    BytecodeProgram program;
+    BytecodeCompiler compiler;
+    BytecodeVerifier verifier;
+    BytecodeVM vm;
+
+    for ([[maybe_unused]] auto _ : state)
+    {
+        if (!compiler.Compile(expression.parser.GetExprs(), expression.root, program)) std::abort();
+        if (!verifier.Verify(program)) std::abort();
+        benchmark::DoNotOptimize(vm.Run(program));
+    }
+}
+
+// Interpreter throughput on a long program
+void BM_BytecodeRun(benchmark::State& state)
+{
+    const ParsedExpression expression(MakeLargeSource(size_t{1} << 16));
+    BytecodeProgram program;
+    BytecodeCompiler compiler;
+    if (!compiler.Compile(expression.parser.GetExprs(), expression.root, program)) std::abort();
+    BytecodeVM vm;
+
+    for ([[maybe_unused]] auto _ : state)
+    {
+        benchmark::DoNotOptimize(vm.Run(program));
+    }
+
+    state.SetItemsProcessed(state.iterations() * std::ssize(program.instructions));
+}
+
+// The same evaluation with a new lli process, as IRExpressionExecutor does it
+void BM_LLIExec(benchmark::State& state)
+{
+    const ParsedExpression expression(kSource);
+    const GeneratedIR ir = GenerateIRString(expression.parser.GetExprs(), expression.root, {.first_variable_index = 1});
+    const std::string module =
+        "define i32 @main() {\n" + ir.text + "ret i32 %" + std::to_string(ir.variable_index) + "\n}\n";
+
+    for ([[maybe_unused]] auto _ : state)
+    {
+        FILE* lli = popen(kLLICommand, "w");  // NOLINT
+        if (lli == nullptr)
+        {
+            state.SkipWithError("Could not start lli");
+            break;
+        }
+
+        std::fwrite(module.data(), 1, module.size(), lli);
+
+        // The exit code is the value of the expression, 127 is the one of the shell when lli is not found
+        const int status = pclose(lli);
+        if (status == -1 || !WIFEXITED(status) || WEXITSTATUS(status) == 127)  // NOLINT
+        {
+            state.SkipWithError("Could not run lli");
+            break;
+        }
+    }
+}
+
+}  // namespace
+
+BENCHMARK(BM_BytecodeExec);
+BENCHMARK(BM_BytecodeRun);
+// Most of the time is spent in the child process, so CPU time of this one means little
+BENCHMARK(BM_LLIExec)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,92 @@
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "kaleidoscope/codegen/llvm_ir_codegen.hpp"
+#include "kaleidoscope/parser/parser.hpp"
+
+using namespace kaleidoscope;  // NOLINT
+
+namespace
+{
+
+// Appends to a string that grows as needed, the way generators usually build their output
+class StringSink
+{
+public:
+    void Write(std::string_view text) { text_ += text; }
+
+    std::string text_;
+};
+
+class ParsedExpression
+{
+public:
+    Parser parser;
+    ExprId root;
+};
+
+// Produces a module of a few megabytes
+[[nodiscard]] ParsedExpression ParseLargeExpression()
+{
+    std::string source = "1";
+    for (size_t i = 0; i != size_t{1} << 16; ++i) source += i % 3 == 0 ? " * (2 + 3)" : " - 4 / 5";
+
+    ParsedExpression parsed;
+    Lexer l(source);
+    LookaheadLexer<2> lexer(l);
+    const auto root = parsed.parser.ParseExpression(lexer);
+    if (!root.has_value()) std::abort();
+    parsed.root = *root;
+    return parsed;
+}
+
+void BM_GenerateIR_String(benchmark::State& state)
+{
+    const auto [parser, root] = ParseLargeExpression();
+
+    size_t size = 0;
+    for ([[maybe_unused]] auto _ : state)
+    {
+        StringSink sink;
+        benchmark::DoNotOptimize(CodeGen_LLVM_IR{parser.GetExprs(), sink}.Gen(root));
+        size = sink.text_.size();
+    }
+
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(size));
+}
+
+void BM_GenerateIR_ExactSize(benchmark::State& state)
+{
+    const auto [parser, root] = ParseLargeExpression();
+
+    size_t size = 0;
+    for ([[maybe_unused]] auto _ : state)
+    {
+        const GeneratedIR ir = GenerateIRString(parser.GetExprs(), root);
+        size = ir.text.size();
+        benchmark::DoNotOptimize(ir.text.data());
+    }
+
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(size));
+}
+
+void BM_GenerateIR_Rope(benchmark::State& state)
+{
+    const auto [parser, root] = ParseLargeExpression();
+
+    size_t size = 0;
+    for ([[maybe_unused]] auto _ : state)
+    {
+        RopeSink sink;
+        benchmark::DoNotOptimize(CodeGen_LLVM_IR{parser.GetExprs(), sink}.Gen(root));
+        size = sink.Size();
+    }
+
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(size));
+}
+
+}  // namespace
+
+BENCHMARK(BM_GenerateIR_String);
+BENCHMARK(BM_GenerateIR_ExactSize);
+BENCHMARK(BM_GenerateIR_Rope);
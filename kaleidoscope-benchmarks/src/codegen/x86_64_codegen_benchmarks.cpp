@@ -0,0 +1,74 @@
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "kaleidoscope/codegen/x86_64_codegen.hpp"
+#include "kaleidoscope/parser/parser.hpp"
+
+using namespace kaleidoscope;  // NOLINT
+
+namespace
+{
+
+// Same expression as in orc_jit_benchmarks.cpp, so compile latency can be compared with BM_OrcJitExec
+constexpr std::string_view kSource = "(1 + 2) * (3 + 4) - 10 / (2 + 3)";
+
+class ParsedExpression
+{
+public:
+    explicit ParsedExpression(std::string_view source)
+    {
+        Lexer l(source);
+        LookaheadLexer<2> lexer(l);
+        const auto r = parser.ParseExpression(lexer);
+        if (!r.has_value()) std::abort();
+        root = *r;
+    }
+
+    Parser parser;
+    ExprId root{};
+};
+
+// Code generation only
+void BM_X86_64CodeGen(benchmark::State& state)
+{
+    const ParsedExpression expression(kSource);
+    X86_64CodeGen codegen;
+
+    for ([[maybe_unused]] auto _ : state)
+    {
+        benchmark::DoNotOptimize(codegen.Gen(expression.parser.GetExprs(), expression.root));
+        benchmark::DoNotOptimize(codegen.GetCode().data());
+    }
+}
+
+// Code generation, mapping of executable memory and the call
+void BM_X86_64Exec(benchmark::State& state)
+{
+    const ParsedExpression expression(kSource);
+
+    for ([[maybe_unused]] auto _ : state)
+    {
+        const auto memory = CompileX86_64(expression.parser.GetExprs(), expression.root);
+        if (!memory.has_value()) std::abort();
+        benchmark::DoNotOptimize(memory->GetFunction<int32_t()>()());
+    }
+}
+
+void BM_X86_64Call(benchmark::State& state)
+{
+    const ParsedExpression expression(kSource);
+    const auto memory = CompileX86_64(expression.parser.GetExprs(), expression.root);
+    if (!memory.has_value()) std::abort();
+    auto* function = memory->GetFunction<int32_t()>();
+
+    for ([[maybe_unused]] auto _ : state)
+    {
+        benchmark::DoNotOptimize(function());
+    }
+}
+
+}  // namespace
+
+BENCHMARK(BM_X86_64CodeGen);
+BENCHMARK(BM_X86_64Exec)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_X86_64Call);
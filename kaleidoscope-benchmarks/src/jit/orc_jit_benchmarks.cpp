@@ -0,0 +1,66 @@
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "kaleidoscope/codegen/llvm_ir_codegen.hpp"
+#include "kaleidoscope/jit/orc_jit.hpp"
+#include "kaleidoscope/parser/parser.hpp"
+
+using namespace kaleidoscope;  // NOLINT
+
+namespace
+{
+
+constexpr std::string_view kSource = "(1 + 2) * (3 + 4) - 10 / (2 + 3)";
+
+[[nodiscard]] GeneratedIR GenerateIR(std::string_view source)
+{
+    Lexer l(source);
+    LookaheadLexer<2> lexer(l);
+    Parser parser;
+    const auto root = parser.ParseExpression(lexer);
+    if (!root.has_value()) std::abort();
+    return GenerateIRString(parser.GetExprs(), *root, {.first_variable_index = 1, .mode = IRCodeGenMode::SSA});
+}
+
+[[nodiscard]] OrcJit CreateJit(OrcJitOptions options)
+{
+    auto jit = OrcJit::Create(options);
+    if (!jit.has_value()) std::abort();
+    return std::move(*jit);
+}
+
+// Parsing, compilation and the call: what one evaluation of a new expression costs
+void BM_OrcJitExec(benchmark::State& state)
+{
+    const GeneratedIR ir = GenerateIR(kSource);
+    const std::string variable_name = "%" + std::to_string(ir.variable_index);
+    OrcJit jit = CreateJit({.optimize = state.range(0) != 0});
+
+    for ([[maybe_unused]] auto _ : state)
+    {
+        benchmark::DoNotOptimize(jit.Exec<int32_t>(ir.text, variable_name));
+    }
+}
+
+// Calls of a function that is already compiled
+void BM_OrcJitCall(benchmark::State& state)
+{
+    const GeneratedIR ir = GenerateIR(kSource);
+    const std::string variable_name = "%" + std::to_string(ir.variable_index);
+    OrcJit jit = CreateJit({});
+
+    const std::string module_ir = OrcJit::MakeExpressionModule("i32", ir.text, variable_name);
+    const auto module = jit.Compile(module_ir, OrcJit::kExpressionFunctionName);
+    if (!module.has_value()) std::abort();
+    auto* function = module->GetFunction<int32_t()>();
+
+    for ([[maybe_unused]] auto _ : state)
+    {
+        benchmark::DoNotOptimize(function());
+    }
+}
+
+}  // namespace
+
+BENCHMARK(BM_OrcJitExec)->ArgName("optimize")->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_OrcJitCall);
@@ -0,0 +1,29 @@
+#include "benchmark/benchmark.h"
+#include "benchmark_inputs.hpp"
+#include "kaleidoscope/lexer/lexer.hpp"
+
+using namespace kaleidoscope;  // NOLINT
+
+namespace
+{
+
+template <auto make_source>
+void BM_LexSource(benchmark::State& state)
+{
+    const std::string source = make_source(static_cast<size_t>(state.range(0)), 42);
+
+    for ([[maybe_unused]] auto _ : state)
+    {
+        Lexer lexer(source);
+        size_t tokens = 0;
+        for (auto r = lexer.GetToken(); !r || r->GetType() != TokenType::EndOfFile; r = lexer.GetToken()) ++tokens;
+        benchmark::DoNotOptimize(tokens);
+    }
+
+    state.SetBytesProcessed(state.iterations() * std::ssize(source));
+}
+
+}  // namespace
+
+BENCHMARK(BM_LexSource<MakeCommentHeavySource>)->Name("BM_LexCommentHeavySource")->Arg(1 << 22);
+BENCHMARK(BM_LexSource<MakeStringHeavySource>)->Name("BM_LexStringHeavySource")->Arg(1 << 22);
@@ -0,0 +1,86 @@
+#include <vector>
+
+#include "ass/fixed_unordered_map.hpp"
+#include "benchmark/benchmark.h"
+#include "benchmark_inputs.hpp"
+#include "kaleidoscope/lexer/lexer.hpp"
+#include "kaleidoscope/lexer/perfect_hash.hpp"
+#include "test_data/extended_keywords.hpp"
+
+using namespace kaleidoscope;  // NOLINT
+
+namespace
+{
+
+// The table the lexer used before perfect hashing: hash is the first byte of the identifier
+inline constexpr auto kFirstByteKeywordLookup = []
+{
+    auto hasher = [](const std::string_view s) -> size_t
+    {
+        return s.empty() ? 0 : std::bit_cast<uint8_t>(s.front());
+    };
+
+    ass::FixedUnorderedMap<10, std::string_view, int, decltype(hasher)> m;
+    for (const auto& [key, value] : kExtendedKeywords) m.Add(key, value);
+    return m;
+}();
+
+inline constexpr auto kPerfectHashKeywordLookup = MakePerfectHashMap<SampledStringHasher, kExtendedKeywords>();
+
+[[nodiscard]] std::vector<std::string_view> CollectIdentifiers(std::string_view source)
+{
+    std::vector<std::string_view> identifiers;
+    Lexer lexer(source);
+    for (auto r = lexer.GetToken(); !r || r->GetType() != TokenType::EndOfFile; r = lexer.GetToken())
+    {
+        if (r && r->GetType() == TokenType::Identifier) identifiers.push_back(lexer.GetTokenView(*r));
+    }
+
+    // Put the extended keywords back in, the lexer reports only its own keywords separately
+    for (size_t i = 0; i < identifiers.size(); i += 8)
+    {
+        identifiers[i] = kExtendedKeywords[i % kExtendedKeywords.size()].first;
+    }
+
+    return identifiers;
+}
+
+template <const auto& lookup>
+void BM_KeywordLookup(benchmark::State& state)
+{
+    const std::string source = MakeIdentifierHeavySource(1 << 20);
+    const std::vector<std::string_view> identifiers = CollectIdentifiers(source);
+
+    for ([[maybe_unused]] auto _ : state)
+    {
+        size_t found = 0;
+        for (const std::string_view identifier : identifiers)
+        {
+            found += lookup.Find(identifier) != nullptr;
+        }
+        benchmark::DoNotOptimize(found);
+    }
+
+    state.SetItemsProcessed(state.iterations() * std::ssize(identifiers));
+}
+
+void BM_LexIdentifierHeavySource(benchmark::State& state)
+{
+    const std::string source = MakeIdentifierHeavySource(static_cast<size_t>(state.range(0)));
+
+    for ([[maybe_unused]] auto _ : state)
+    {
+        Lexer lexer(source);
+        size_t tokens = 0;
+        for (auto r = lexer.GetToken(); !r || r->GetType() != TokenType::EndOfFile; r = lexer.GetToken()) ++tokens;
+        benchmark::DoNotOptimize(tokens);
+    }
+
+    state.SetBytesProcessed(state.iterations() * std::ssize(source));
+}
+
+}  // namespace
+
+BENCHMARK(BM_KeywordLookup<kFirstByteKeywordLookup>)->Name("BM_KeywordLookup/FirstByteHash");
+BENCHMARK(BM_KeywordLookup<kPerfectHashKeywordLookup>)->Name("BM_KeywordLookup/PerfectHash");
+BENCHMARK(BM_LexIdentifierHeavySource)->Arg(1 << 16)->Arg(1 << 22);
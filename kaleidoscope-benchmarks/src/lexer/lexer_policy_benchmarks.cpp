@@ -0,0 +1,59 @@
+#include "benchmark/benchmark.h"
+#include "benchmark_inputs.hpp"
+#include "kaleidoscope/lexer/lookahead_lexer.hpp"
+
+using namespace kaleidoscope;  // NOLINT
+
+namespace
+{
+
+using NoTriviaLexer = BasicLexer<WithTrivia<CompactLexerTraits, false>>;
+using LineColumnLexer = BasicLexer<WithLineColumnTracking<CompactLexerTraits, true>>;
+
+// Consumes tokens the way the parser does: through the lookahead ring, ignoring comments
+template <typename LexerType>
+void BM_LookaheadWithoutComments(benchmark::State& state)
+{
+    const std::string source = MakeCommentHeavySource(static_cast<size_t>(state.range(0)), 42);
+
+    for ([[maybe_unused]] auto _ : state)
+    {
+        LexerType lexer(source);
+        LookaheadLexer<2, LexerType> lookahead(lexer);
+        size_t tokens = 0;
+        while (true)
+        {
+            const auto r = lookahead.Take();
+            if (r && r->GetType() == TokenType::EndOfFile) break;
+            if (r && (r->GetType() == TokenType::Comment || r->GetType() == TokenType::BlockComment)) continue;
+            ++tokens;
+        }
+
+        benchmark::DoNotOptimize(tokens);
+    }
+
+    state.SetBytesProcessed(state.iterations() * std::ssize(source));
+}
+
+template <typename LexerType>
+void BM_LexMixedSource(benchmark::State& state)
+{
+    const std::string source = MakeMixedSource(static_cast<size_t>(state.range(0)), 42);
+
+    for ([[maybe_unused]] auto _ : state)
+    {
+        LexerType lexer(source);
+        size_t tokens = 0;
+        for (auto r = lexer.GetToken(); !r || r->GetType() != TokenType::EndOfFile; r = lexer.GetToken()) ++tokens;
+        benchmark::DoNotOptimize(tokens);
+    }
+
+    state.SetBytesProcessed(state.iterations() * std::ssize(source));
+}
+
+}  // namespace
+
+BENCHMARK(BM_LookaheadWithoutComments<Lexer>)->Name("BM_LookaheadWithoutComments/EmitTrivia")->Arg(1 << 22);
+BENCHMARK(BM_LookaheadWithoutComments<NoTriviaLexer>)->Name("BM_LookaheadWithoutComments/DropTrivia")->Arg(1 << 22);
+BENCHMARK(BM_LexMixedSource<Lexer>)->Name("BM_LexMixedSource/Default")->Arg(1 << 22);
+BENCHMARK(BM_LexMixedSource<LineColumnLexer>)->Name("BM_LexMixedSource/TrackLineColumn")->Arg(1 << 22);
@@ -0,0 +1,83 @@
+#include "benchmark/benchmark.h"
+#include "benchmark_inputs.hpp"
+#include "kaleidoscope/lexer/block_lookahead_lexer.hpp"
+#include "kaleidoscope/lexer/lookahead_lexer.hpp"
+
+using namespace kaleidoscope;  // NOLINT
+
+namespace
+{
+
+// Takes every token and peeks at the whole horizon before that, like a parser deciding what comes next
+template <typename LookaheadType, size_t horizon_size>
+void BM_Lookahead(benchmark::State& state)
+{
+    const std::string source = MakeMixedSource(size_t{1} << 22, 42);
+
+    for ([[maybe_unused]] auto _ : state)
+    {
+        Lexer lexer(source);
+        LookaheadType lookahead(lexer);
+        size_t operators = 0;
+        while (true)
+        {
+            for (size_t i = 0; i != horizon_size; ++i)
+            {
+                const auto& r = lookahead.Peek(i);
+                operators += r && r->GetType() == TokenType::Plus;
+            }
+
+            const auto r = lookahead.Take();
+            if (r && r->GetType() == TokenType::EndOfFile) break;
+        }
+
+        benchmark::DoNotOptimize(operators);
+    }
+
+    state.SetBytesProcessed(state.iterations() * std::ssize(source));
+}
+
+// Parses the same statement twice: once speculatively, then again after rewinding
+void BM_BlockLookaheadBacktracking(benchmark::State& state)
+{
+    const std::string source = MakeMixedSource(size_t{1} << 22, 42);
+    const auto distance = static_cast<size_t>(state.range(0));
+
+    for ([[maybe_unused]] auto _ : state)
+    {
+        Lexer lexer(source);
+        BlockLookaheadLexer<2> lookahead(lexer);
+        size_t tokens = 0;
+        bool eof = false;
+        while (!eof)
+        {
+            const LookaheadCheckpoint checkpoint = lookahead.Save();
+            for (size_t i = 0; i != distance; ++i) std::ignore = lookahead.Take();
+            lookahead.Rewind(checkpoint);
+            lookahead.Release(checkpoint);
+
+            for (size_t i = 0; i != distance && !eof; ++i)
+            {
+                const auto r = lookahead.Take();
+                eof = r && r->GetType() == TokenType::EndOfFile;
+                ++tokens;
+            }
+        }
+
+        benchmark::DoNotOptimize(tokens);
+    }
+
+    state.SetBytesProcessed(state.iterations() * std::ssize(source));
+}
+
+}  // namespace
+
+#define KALEIDOSCOPE_LOOKAHEAD_BENCHMARKS(horizon)                                                       \
+    BENCHMARK(BM_Lookahead<LookaheadLexer<horizon>, horizon>)->Name("BM_LookaheadLexer/" #horizon);      \
+    BENCHMARK(BM_Lookahead<BlockLookaheadLexer<horizon>, horizon>)->Name("BM_BlockLookaheadLexer/" #horizon)
+
+KALEIDOSCOPE_LOOKAHEAD_BENCHMARKS(2);
+KALEIDOSCOPE_LOOKAHEAD_BENCHMARKS(3);
+KALEIDOSCOPE_LOOKAHEAD_BENCHMARKS(5);
+KALEIDOSCOPE_LOOKAHEAD_BENCHMARKS(8);
+BENCHMARK(BM_BlockLookaheadBacktracking)->Arg(4)->Arg(64)->Arg(1024);
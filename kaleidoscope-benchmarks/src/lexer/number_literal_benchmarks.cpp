@@ -0,0 +1,86 @@
+#include <variant>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "benchmark_inputs.hpp"
+#include "kaleidoscope/lexer/lexer.hpp"
+
+using namespace kaleidoscope;  // NOLINT
+
+namespace
+{
+
+template <NumberLiteralEngine engine>
+void BM_LexNumberHeavySource(benchmark::State& state)
+{
+    using LexerType = BasicLexer<WithNumberLiteralEngine<CompactLexerTraits, engine>>;
+    const std::string source = MakeNumberHeavySource(static_cast<size_t>(state.range(0)));
+
+    for ([[maybe_unused]] auto _ : state)
+    {
+        LexerType lexer(source);
+        size_t tokens = 0;
+        for (auto r = lexer.GetToken(); !r || r->GetType() != TokenType::EndOfFile; r = lexer.GetToken()) ++tokens;
+        benchmark::DoNotOptimize(tokens);
+    }
+
+    state.SetBytesProcessed(state.iterations() * std::ssize(source));
+}
+
+// Lexes the source and then decodes every literal from the token text
+void BM_LexAndDecodeSeparately(benchmark::State& state)
+{
+    const std::string source = MakeNumberHeavySource(static_cast<size_t>(state.range(0)));
+
+    for ([[maybe_unused]] auto _ : state)
+    {
+        Lexer lexer(source);
+        std::vector<Lexer::Token> literals;
+        for (auto r = lexer.GetToken(); !r || r->GetType() != TokenType::EndOfFile; r = lexer.GetToken())
+        {
+            if (r && IsNumericLiteral(r->GetType())) literals.push_back(*r);
+        }
+
+        uint64_t checksum = 0;
+        for (const auto& token : literals)
+        {
+            const auto value = DecodeNumericLiteral(token.GetType(), lexer.GetTokenView(token));
+            if (value.has_value()) checksum += std::visit([](auto v) { return static_cast<uint64_t>(v); }, *value);
+        }
+
+        benchmark::DoNotOptimize(checksum);
+    }
+
+    state.SetBytesProcessed(state.iterations() * std::ssize(source));
+}
+
+void BM_LexWithDecoding(benchmark::State& state)
+{
+    const std::string source = MakeNumberHeavySource(static_cast<size_t>(state.range(0)));
+
+    for ([[maybe_unused]] auto _ : state)
+    {
+        DecodingLexer lexer(source);
+        uint64_t checksum = 0;
+        for (auto r = lexer.GetToken(); !r || r->GetType() != TokenType::EndOfFile; r = lexer.GetToken())
+        {
+            if (r && IsNumericLiteral(r->GetType()))
+            {
+                checksum += std::visit([](auto v) { return static_cast<uint64_t>(v); }, lexer.GetLiteralValue());
+            }
+        }
+
+        benchmark::DoNotOptimize(checksum);
+    }
+
+    state.SetBytesProcessed(state.iterations() * std::ssize(source));
+}
+
+}  // namespace
+
+BENCHMARK(BM_LexNumberHeavySource<NumberLiteralEngine::HandWritten>)
+    ->Name("BM_LexNumberHeavySource/HandWritten")
+    ->Arg(1 << 20);
+BENCHMARK(BM_LexNumberHeavySource<NumberLiteralEngine::Dfa>)->Name("BM_LexNumberHeavySource/Dfa")->Arg(1 << 20);
+BENCHMARK(BM_LexAndDecodeSeparately)->Arg(1 << 20);
+BENCHMARK(BM_LexWithDecoding)->Arg(1 << 20);
@@ -0,0 +1,61 @@
+#include <bit>
+
+#include "benchmark/benchmark.h"
+#include "benchmark_inputs.hpp"
+#include "kaleidoscope/lexer/lookahead_lexer.hpp"
+#include "kaleidoscope/lexer/pipelined_lexer.hpp"
+
+using namespace kaleidoscope;  // NOLINT
+
+namespace
+{
+
+// Stands in for the parser: consumes tokens through the lookahead ring and does some work per token
+template <typename LexerType>
+[[nodiscard]] uint64_t Consume(LexerType& lexer)
+{
+    LookaheadLexer<2, LexerType> lookahead(lexer);
+    uint64_t hash = 0;
+    while (true)
+    {
+        const auto r = lookahead.Take();
+        if (r && r->GetType() == TokenType::EndOfFile) break;
+        if (r)
+        {
+            for (const char c : lookahead.GetTokenView(*r)) hash = (hash ^ std::bit_cast<uint8_t>(c)) * 0x100000001B3;
+        }
+    }
+
+    return hash;
+}
+
+void BM_SerialLexAndConsume(benchmark::State& state)
+{
+    const std::string source = MakeMixedSource(static_cast<size_t>(state.range(0)), 42);
+
+    for ([[maybe_unused]] auto _ : state)
+    {
+        Lexer lexer(source);
+        benchmark::DoNotOptimize(Consume(lexer));
+    }
+
+    state.SetBytesProcessed(state.iterations() * std::ssize(source));
+}
+
+void BM_PipelinedLexAndConsume(benchmark::State& state)
+{
+    const std::string source = MakeMixedSource(static_cast<size_t>(state.range(0)), 42);
+
+    for ([[maybe_unused]] auto _ : state)
+    {
+        PipelinedLexer<> lexer(source);
+        benchmark::DoNotOptimize(Consume(lexer));
+    }
+
+    state.SetBytesProcessed(state.iterations() * std::ssize(source));
+}
+
+}  // namespace
+
+BENCHMARK(BM_SerialLexAndConsume)->Arg(1 << 22)->UseRealTime();
+BENCHMARK(BM_PipelinedLexAndConsume)->Arg(1 << 22)->UseRealTime();
@@ -0,0 +1,64 @@
+#include <string>
+#include <unordered_map>
+
+#include "benchmark/benchmark.h"
+#include "benchmark_inputs.hpp"
+#include "kaleidoscope/lexer/lexer.hpp"
+
+using namespace kaleidoscope;  // NOLINT
+
+namespace
+{
+
+// Baseline: what a later pass would do without interning
+void BM_LexThenLookupInHashMap(benchmark::State& state)
+{
+    const std::string source = MakeMixedSource(size_t{1} << 22, 42);
+
+    for ([[maybe_unused]] auto _ : state)
+    {
+        std::unordered_map<std::string, uint32_t> ids;
+        Lexer lexer(source);
+        uint64_t sum = 0;
+        for (auto r = lexer.GetToken(); !r || r->GetType() != TokenType::EndOfFile; r = lexer.GetToken())
+        {
+            if (r && r->GetType() == TokenType::Identifier)
+            {
+                const auto [it, inserted] =
+                    ids.try_emplace(std::string(lexer.GetTokenView(*r)), static_cast<uint32_t>(ids.size()));
+                sum += it->second;
+            }
+        }
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetBytesProcessed(state.iterations() * std::ssize(source));
+}
+
+template <typename SymbolTableType>
+void BM_LexWithInterning(benchmark::State& state)
+{
+    const std::string source = MakeMixedSource(size_t{1} << 22, 42);
+
+    for ([[maybe_unused]] auto _ : state)
+    {
+        SymbolTableType symbols;
+        BasicLexer<WithSymbolTable<CompactLexerTraits, SymbolTableType>> lexer(source, symbols);
+        uint64_t sum = 0;
+        for (auto r = lexer.GetToken(); !r || r->GetType() != TokenType::EndOfFile; r = lexer.GetToken())
+        {
+            if (r && r->GetType() == TokenType::Identifier) sum += lexer.GetSymbolId();
+        }
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetBytesProcessed(state.iterations() * std::ssize(source));
+}
+
+}  // namespace
+
+BENCHMARK(BM_LexThenLookupInHashMap);
+BENCHMARK(BM_LexWithInterning<SymbolTable>);
+BENCHMARK(BM_LexWithInterning<ConcurrentSymbolTable>);
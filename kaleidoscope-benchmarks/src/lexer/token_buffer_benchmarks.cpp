@@ -0,0 +1,70 @@
+#include "benchmark/benchmark.h"
+#include "benchmark_inputs.hpp"
+#include "kaleidoscope/lexer/token_buffer.hpp"
+
+using namespace kaleidoscope;  // NOLINT
+
+namespace
+{
+
+void BM_TokenBufferTokenize(benchmark::State& state)
+{
+    const std::string source = MakeMixedSource(static_cast<size_t>(state.range(0)));
+    TokenBuffer buffer;
+
+    for ([[maybe_unused]] auto _ : state)
+    {
+        buffer.Tokenize(source);
+        benchmark::DoNotOptimize(buffer.Size());
+    }
+
+    state.SetBytesProcessed(state.iterations() * std::ssize(source));
+}
+
+// range(0) is the source size, range(1) is the thread count
+void BM_TokenBufferTokenizeParallel(benchmark::State& state)
+{
+    const std::string source = MakeMixedSource(static_cast<size_t>(state.range(0)));
+    const auto thread_count = static_cast<size_t>(state.range(1));
+    TokenBuffer buffer;
+
+    for ([[maybe_unused]] auto _ : state)
+    {
+        buffer.TokenizeParallel(source, thread_count);
+        benchmark::DoNotOptimize(buffer.Size());
+    }
+
+    state.SetBytesProcessed(state.iterations() * std::ssize(source));
+}
+
+// Types and erases a character in the middle of the source, one edit per iteration
+void BM_TokenBufferApplyEdit(benchmark::State& state)
+{
+    std::string source = MakeMixedSource(static_cast<size_t>(state.range(0)));
+    const size_t offset = source.find(' ', source.size() / 2);
+    TokenBuffer buffer(source);
+
+    bool inserted = false;
+    for ([[maybe_unused]] auto _ : state)
+    {
+        if (inserted)
+        {
+            source.erase(offset, 1);
+            buffer.ApplyEdit(source, {.offset = offset, .removed_length = 1, .inserted_length = 0});
+        }
+        else
+        {
+            source.insert(offset, 1, 'x');
+            buffer.ApplyEdit(source, {.offset = offset, .removed_length = 0, .inserted_length = 1});
+        }
+
+        inserted = !inserted;
+        benchmark::DoNotOptimize(buffer.Size());
+    }
+}
+
+}  // namespace
+
+BENCHMARK(BM_TokenBufferTokenize)->Arg(1 << 24);
+BENCHMARK(BM_TokenBufferTokenizeParallel)->ArgsProduct({{1 << 24}, {1, 2, 4, 8}})->UseRealTime();
+BENCHMARK(BM_TokenBufferApplyEdit)->Arg(1 << 16)->Arg(1 << 24);
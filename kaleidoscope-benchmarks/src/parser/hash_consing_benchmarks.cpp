@@ -0,0 +1,40 @@
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "kaleidoscope/parser/parser.hpp"
+
+using namespace kaleidoscope;  // NOLINT
+
+namespace
+{
+
+// Generated sources repeat the same few subexpressions
+[[nodiscard]] std::string MakeRedundantExpression(size_t terms)
+{
+    std::string expression = "1";
+    for (size_t i = 0; i != terms; ++i) expression += i % 2 == 0 ? " + (2 * 3 - 4)" : " + (5 / 6)";
+    return expression;
+}
+
+void BM_ParseRedundantExpression(benchmark::State& state)
+{
+    const std::string source = MakeRedundantExpression(size_t{1} << 16);
+    const ParserOptions options{.hash_consing = state.range(0) != 0};
+
+    size_t nodes = 0;
+    for ([[maybe_unused]] auto _ : state)
+    {
+        Parser parser(std::pmr::get_default_resource(), options);
+        Lexer l(source);
+        LookaheadLexer<2> lexer(l);
+        benchmark::DoNotOptimize(parser.ParseExpression(lexer));
+        nodes = parser.GetExprs().Size();
+    }
+
+    state.counters["nodes"] = static_cast<double>(nodes);
+    state.SetBytesProcessed(state.iterations() * std::ssize(source));
+}
+
+}  // namespace
+
+BENCHMARK(BM_ParseRedundantExpression)->ArgName("hash_consing")->Arg(0)->Arg(1);
@@ -0,0 +1,66 @@
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "kaleidoscope/parser/parser_context.hpp"
+
+using namespace kaleidoscope;  // NOLINT
+
+namespace
+{
+
+// Many small compilations, as a service compiling one expression per request would do
+[[nodiscard]] std::vector<std::string> MakeSmallExpressions()
+{
+    std::vector<std::string> expressions;
+    for (size_t i = 0; i != 1000; ++i)
+    {
+        std::string expression = std::to_string(i);
+        for (size_t j = 0; j != 8 + i % 24; ++j) expression += j % 3 == 0 ? " * (2 + 3)" : " - 4 / 5";
+        expressions.push_back(std::move(expression));
+    }
+
+    return expressions;
+}
+
+void BM_CompileWithNewParser(benchmark::State& state)
+{
+    const std::vector<std::string> expressions = MakeSmallExpressions();
+
+    for ([[maybe_unused]] auto _ : state)
+    {
+        for (const std::string& expression : expressions)
+        {
+            Parser parser;
+            Lexer l(expression);
+            LookaheadLexer<2> lexer(l);
+            benchmark::DoNotOptimize(parser.ParseExpression(lexer));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * std::ssize(expressions));
+}
+
+void BM_CompileWithParserContext(benchmark::State& state)
+{
+    const std::vector<std::string> expressions = MakeSmallExpressions();
+    ParserContext context(static_cast<size_t>(state.range(0)));
+
+    for ([[maybe_unused]] auto _ : state)
+    {
+        for (const std::string& expression : expressions)
+        {
+            Parser& parser = context.StartCompilation();
+            Lexer l(expression);
+            LookaheadLexer<2> lexer(l);
+            benchmark::DoNotOptimize(parser.ParseExpression(lexer));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * std::ssize(expressions));
+}
+
+}  // namespace
+
+BENCHMARK(BM_CompileWithNewParser);
+BENCHMARK(BM_CompileWithParserContext)->Arg(0)->Arg(1 << 16);
@@ -0,0 +1,198 @@
+#include <format>
+
+#include "ir_expression_executor.hpp"
+#include "kaleidoscope/codegen/bytecode_vm.hpp"
+#include "kaleidoscope/codegen/llvm_ir_codegen.hpp"
+#include "util.hpp"
+
+namespace
+{
+
+[[nodiscard]] BytecodeProgram Compile(const ParsedExpression& parsed)
+{
+    BytecodeProgram program;
+    BytecodeCompiler compiler;
+    EXPECT_TRUE(compiler.Compile(parsed.parser.GetExprs(), parsed.root, program).has_value());
+
+    BytecodeVerifier verifier;
+    EXPECT_TRUE(verifier.Verify(program).has_value());
+    return program;
+}
+
+[[nodiscard]] BytecodeVerificationErrorType GetVerificationError(const BytecodeProgram& program)
+{
+    BytecodeVerifier verifier;
+    const auto r = verifier.Verify(program);
+    EXPECT_FALSE(r.has_value());
+    return r.has_value() ? BytecodeVerificationErrorType::MissingRet : r.error().type;
+}
+
+}  // namespace
+
+TEST(BytecodeTest, MatchesLLVM)
+{
+    constexpr std::array<std::string_view, 6> kSources{
+        "7",
+        "42 - 21",
+        "(1 + 2) * (3 + 4) - 10 / (2 + 3)",
+        "0 - 7 / 2",
+        "1000000 * 1000000 * 7",
+        "2147483647 + 1",
+    };
+
+    BytecodeVM vm;
+    for (const uint8_t bits : {uint8_t{32}, uint8_t{64}})
+    {
+        for (const std::string_view src : kSources)
+        {
+            const ParsedExpression parsed = ParseWithLiteralBits(src, bits);
+            const BytecodeProgram program = Compile(parsed);
+            const auto value = vm.Run(program);
+            ASSERT_TRUE(value.has_value()) << src;
+
+            const GeneratedIR ir = GenerateIRString(parsed.parser.GetExprs(), parsed.root, {.first_variable_index = 1});
+            const std::string variable_name = std::format("%{}", ir.variable_index);
+            if (bits == 32)
+            {
+                ASSERT_EQ(program.result_type, BytecodeType::I32);
+                ASSERT_EQ(value->i32, IRExpressionExecutor::ExecI32(ir.text, variable_name)) << src;
+            }
+            else
+            {
+                ASSERT_EQ(program.result_type, BytecodeType::I64);
+                ASSERT_EQ(value->i64, IRExpressionExecutor::ExecI64(ir.text, variable_name)) << src;
+            }
+        }
+    }
+}
+
+TEST(BytecodeTest, DeepExpression)
+{
+    // Lowering does not recurse, so depth is limited by the number of registers only
+    std::string src;
+    constexpr size_t kDepth = 10'001;
+    for (size_t i = 0; i != kDepth - 1; ++i) src += "1 - (";
+    src += "1";
+    src.append(kDepth - 1, ')');
+
+    const BytecodeProgram program = Compile(ParseWithLiteralBits(src));
+    ASSERT_EQ(program.register_count, kDepth);
+
+    BytecodeVM vm;
+    const auto value = vm.Run(program);
+    ASSERT_TRUE(value.has_value());
+    ASSERT_EQ(value->i32, 1);
+}
+
+TEST(BytecodeTest, FloatingPoint)
+{
+    // (1.5 + 2.25) * 4 / 0.5 - 1
+    BytecodeProgram program;
+    program.EmitLoad(0, 1.5);
+    program.EmitLoad(1, 2.25);
+    program.EmitBinary(BinaryOperatorType::Plus, BytecodeType::F64, 0, 0, 1);
+    program.EmitLoad(1, 4.0);
+    program.EmitBinary(BinaryOperatorType::Multiply, BytecodeType::F64, 0, 0, 1);
+    program.EmitLoad(1, 0.5);
+    program.EmitBinary(BinaryOperatorType::Divide, BytecodeType::F64, 0, 0, 1);
+    program.EmitLoad(1, 1.0);
+    program.EmitBinary(BinaryOperatorType::Minus, BytecodeType::F64, 0, 0, 1);
+    program.EmitRet(0, BytecodeType::F64);
+
+    BytecodeVerifier verifier;
+    ASSERT_TRUE(verifier.Verify(program).has_value());
+
+    BytecodeVM vm;
+    const auto value = vm.Run(program);
+    ASSERT_TRUE(value.has_value());
+    ASSERT_DOUBLE_EQ(value->f64, 29.0);
+}
+
+TEST(BytecodeTest, RuntimeErrors)
+{
+    BytecodeVM vm;
+
+    const auto r1 = vm.Run(Compile(ParseWithLiteralBits("1 / (2 - 2)")));
+    ASSERT_FALSE(r1.has_value());
+    ASSERT_EQ(r1.error(), BytecodeVMError::DivisionByZero);
+
+    BytecodeProgram program;
+    program.EmitLoad(0, std::numeric_limits<int64_t>::min());
+    program.EmitLoad(1, int64_t{-1});
+    program.EmitBinary(BinaryOperatorType::Divide, BytecodeType::I64, 0, 0, 1);
+    program.EmitRet(0, BytecodeType::I64);
+
+    BytecodeVerifier verifier;
+    ASSERT_TRUE(verifier.Verify(program).has_value());
+    const auto r2 = vm.Run(program);
+    ASSERT_FALSE(r2.has_value());
+    ASSERT_EQ(r2.error(), BytecodeVMError::IntegerOverflow);
+}
+
+TEST(BytecodeTest, Verifier)
+{
+    const auto make_valid = []
+    {
+        BytecodeProgram program;
+        program.EmitLoad(0, 1);
+        program.EmitLoad(1, 2);
+        program.EmitBinary(BinaryOperatorType::Plus, BytecodeType::I32, 0, 0, 1);
+        program.EmitRet(0, BytecodeType::I32);
+        return program;
+    };
+
+    BytecodeVerifier verifier;
+    ASSERT_TRUE(verifier.Verify(make_valid()).has_value());
+
+    {
+        BytecodeProgram program = make_valid();
+        program.instructions[2].opcode = static_cast<Opcode>(kOpcodeCount);
+        ASSERT_EQ(GetVerificationError(program), BytecodeVerificationErrorType::InvalidOpcode);
+    }
+    {
+        BytecodeProgram program = make_valid();
+        program.instructions[2].b = 2;
+        ASSERT_EQ(GetVerificationError(program), BytecodeVerificationErrorType::InvalidRegister);
+    }
+    {
+        BytecodeProgram program = make_valid();
+        program.instructions[1].a = 5;
+        ASSERT_EQ(GetVerificationError(program), BytecodeVerificationErrorType::InvalidConstant);
+    }
+    {
+        BytecodeProgram program = make_valid();
+        program.instructions[1].dst = 0;
+        ASSERT_EQ(GetVerificationError(program), BytecodeVerificationErrorType::UndefinedRegister);
+    }
+    {
+        BytecodeProgram program = make_valid();
+        program.instructions[2].opcode = Opcode::AddI64;
+        ASSERT_EQ(GetVerificationError(program), BytecodeVerificationErrorType::TypeMismatch);
+    }
+    {
+        BytecodeProgram program = make_valid();
+        program.result_type = BytecodeType::F64;
+        ASSERT_EQ(GetVerificationError(program), BytecodeVerificationErrorType::TypeMismatch);
+    }
+    {
+        BytecodeProgram program = make_valid();
+        program.instructions.pop_back();
+        ASSERT_EQ(GetVerificationError(program), BytecodeVerificationErrorType::MissingRet);
+    }
+    {
+        BytecodeProgram program = make_valid();
+        program.EmitRet(1, BytecodeType::I32);
+        ASSERT_EQ(GetVerificationError(program), BytecodeVerificationErrorType::CodeAfterRet);
+    }
+}
+
+TEST(BytecodeTest, UnsupportedTypes)
+{
+    BytecodeProgram program;
+    BytecodeCompiler compiler;
+
+    const ParsedExpression parsed = ParseWithLiteralBits("1 + 2", 16);
+    const auto r = compiler.Compile(parsed.parser.GetExprs(), parsed.root, program);
+    ASSERT_FALSE(r.has_value());
+    ASSERT_EQ(r.error(), BytecodeCompilerError::UnsupportedType);
+}
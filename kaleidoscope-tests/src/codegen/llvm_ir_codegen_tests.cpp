@@ -0,0 +1,198 @@
+#include <format>
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wfloat-equal"
+#include "fmt/compile.h"
+#pragma clang diagnostic pop
+#include "ir_expression_executor.hpp"
+#include "kaleidoscope/codegen/llvm_ir_codegen.hpp"
+#include "kaleidoscope/parser/constant_folder.hpp"
+#include "kaleidoscope/parser/parser.hpp"
+#include "util.hpp"
+
+namespace
+{
+
+struct FixedBufferOutIt
+{
+    explicit constexpr FixedBufferOutIt(std::span<char> buffer)
+        : size{buffer.size()},
+          out{buffer.data()},
+          end{out + buffer.size()}  // NOLINT
+    {
+    }
+
+    constexpr FixedBufferOutIt& operator=(char c)
+    {
+        if (out != end)
+        {
+            *out = c;
+            std::advance(out, 1);
+        }
+
+        size += 1;
+
+        return *this;
+    }
+
+    constexpr FixedBufferOutIt& operator*() { return *this; }
+    constexpr FixedBufferOutIt& operator++() { return *this; }
+    constexpr FixedBufferOutIt operator++(int) { return *this; }
+
+    size_t size = 0;
+    char *out, *end{};
+};
+
+static_assert(
+    []
+    {
+        std::array<char, 2048> buffer{};
+        constexpr auto f = FMT_COMPILE("{}");
+        fmt::format_to(FixedBufferOutIt{std::span{buffer}}, f, 123);
+        return true;
+    }());
+
+[[nodiscard]] ParsedExpression Parse(std::string_view src, ParserOptions options = {})
+{
+    Lexer l(src);
+    LookaheadLexer<2> lexer(l);
+
+    ParsedExpression parsed{.parser = Parser(std::pmr::get_default_resource(), options), .root = {}};
+    const auto root = parsed.parser.ParseExpression(lexer);
+    EXPECT_TRUE(root.has_value());
+    if (root.has_value()) parsed.root = *root;
+    return parsed;
+}
+
+// Registers of the expression must start from %1: %0 is the entry block of main
+[[nodiscard]] int32_t Execute(std::string_view ir, size_t variable_index)
+{
+    auto eval_result = IRExpressionExecutor::ExecI32(ir, std::format("%{}", variable_index));
+    EXPECT_TRUE(eval_result.has_value());
+    return eval_result.value_or(0);
+}
+
+}  // namespace
+
+TEST(LLVMIRCodeGenTest, Gen)
+{
+    const Parser parser = Parse("42 - 21").parser;
+    const auto* opt_ast = parser.GetExprAst<ExprType::BinaryOperator>(0);
+    ASSERT_NE(opt_ast, nullptr);
+    ASSERT_EQ(opt_ast->type, BinaryOperatorType::Minus);
+
+    std::vector<char> data(2048, 0);
+    FixedBufferSink sink(data);
+    CodeGen_LLVM_IR g{parser.GetExprs(), sink, {.first_variable_index = 1}};
+    const size_t variable_index = g.Gen(*opt_ast);
+    ASSERT_FALSE(sink.Overflowed());
+
+    ASSERT_EQ(Execute(sink.GetText(), variable_index), 21);
+}
+
+TEST(LLVMIRCodeGenTest, HashConsing)
+{
+    constexpr std::string_view kSource = "(1 + 2) * (1 + 2) + (1 + 2) * (1 + 2)";
+
+    std::array<size_t, 2> ir_sizes{};
+    for (const bool hash_consing : {false, true})
+    {
+        const ParsedExpression parsed = Parse(kSource, {.hash_consing = hash_consing});
+        const ExprAstStorage& exprs = parsed.parser.GetExprs();
+        ASSERT_EQ(exprs.GetNodes<IntegralLiteralExprAST>().size(), hash_consing ? 2 : 8);
+        ASSERT_EQ(exprs.GetNodes<BinaryOperatorExpression>().size(), hash_consing ? 3 : 7);
+
+        const GeneratedIR ir = GenerateIRString(exprs, parsed.root, {.first_variable_index = 1});
+        ir_sizes[hash_consing ? 1 : 0] = ir.text.size();
+        ASSERT_EQ(Execute(ir.text, ir.variable_index), 18);
+    }
+
+    ASSERT_LT(ir_sizes[1] * 2, ir_sizes[0]);
+}
+
+TEST(LLVMIRCodeGenTest, SSA)
+{
+    constexpr std::array<std::pair<std::string_view, int32_t>, 4> kCases{{
+        {"7", 7},
+        {"42 - 21", 21},
+        {"(1 + 2) * (3 + 4) - 10 / (2 + 3)", 19},
+        {"((((1 - 2) - 3) - 4) * (5 + (6 * (7 - 8))))", 8},
+    }};
+
+    for (const auto& [src, expected] : kCases)
+    {
+        const ParsedExpression parsed = Parse(src);
+
+        std::array<size_t, 2> ir_sizes{};
+        for (const IRCodeGenMode mode : {IRCodeGenMode::Memory, IRCodeGenMode::SSA})
+        {
+            const GeneratedIR ir =
+                GenerateIRString(parsed.parser.GetExprs(), parsed.root, {.first_variable_index = 1, .mode = mode});
+            ir_sizes[static_cast<size_t>(mode)] = ir.text.size();
+            ASSERT_EQ(Execute(ir.text, ir.variable_index), expected) << src;
+        }
+
+        ASSERT_LT(ir_sizes[1] * 3, ir_sizes[0]) << src;
+    }
+}
+
+TEST(LLVMIRCodeGenTest, ConstantFolding)
+{
+    auto [parser, root] = Parse("(42 - 21) * 3 - 70");
+    const GeneratedIR unfolded = GenerateIRString(parser.GetExprs(), root, {.first_variable_index = 1});
+
+    ConstantFolder folder;
+    const ExprId folded = folder.Fold(parser.GetExprs(), root);
+    ASSERT_EQ(folded.type, ExprType::IntegralLiteral);
+    ASSERT_TRUE(folder.GetErrors().empty());
+
+    const GeneratedIR ir = GenerateIRString(parser.GetExprs(), folded, {.first_variable_index = 1});
+    ASSERT_LT(ir.text.size() * 4, unfolded.text.size());
+    ASSERT_EQ(Execute(ir.text, ir.variable_index), -7);
+}
+
+TEST(LLVMIRCodeGenTest, SinksProduceSameText)
+{
+    std::string src = "1";
+    for (size_t i = 0; i != 20'000; ++i) src += i % 3 == 0 ? " * (2 + 3)" : " - 4 / 5";
+    const auto [parser, root] = Parse(src);
+
+    const GeneratedIR exact = GenerateIRString(parser.GetExprs(), root);
+    ASSERT_GT(exact.text.size(), 4 * RopeSink::kChunkSize);
+
+    RopeSink rope;
+    const size_t rope_variable_index = CodeGen_LLVM_IR{parser.GetExprs(), rope}.Gen(root);
+    ASSERT_EQ(rope_variable_index, exact.variable_index);
+    ASSERT_EQ(rope.Size(), exact.text.size());
+    ASSERT_EQ(rope.ToString(), exact.text);
+}
+
+TEST(LLVMIRCodeGenTest, DeepExpression)
+{
+    // Would overflow the native stack with one recursive call per operator
+    constexpr size_t kTerms = 1'000'000;
+
+    std::string flat = "1";
+    for (size_t i = 1; i != kTerms; ++i) flat += i % 2 == 0 ? " + 1" : " * 1";
+
+    std::string nested(kTerms, '(');
+    nested += "1";
+    for (size_t i = 0; i != kTerms; ++i) nested += " + 1)";
+
+    for (const std::string& src : {flat, nested})
+    {
+        Lexer l(src);
+        LookaheadLexer<2> lexer(l);
+        Parser parser;
+        const auto root = parser.ParseExpression(lexer);
+        ASSERT_TRUE(root.has_value());
+
+        // One instruction per operator: literals are immediate operands
+        const size_t operators = parser.GetExprs().GetNodes<BinaryOperatorExpression>().size();
+        const GeneratedIR ir =
+            GenerateIRString(parser.GetExprs(), *root, {.first_variable_index = 1, .mode = IRCodeGenMode::SSA});
+        ASSERT_EQ(ir.variable_index, operators);
+        ASSERT_EQ(std::ranges::count(ir.text, '\n'), operators);
+        ASSERT_TRUE(ir.text.starts_with("%1 = "));
+    }
+}
@@ -0,0 +1,128 @@
+#include <array>
+#include <cerrno>
+#include <cstdio>
+#include <string>
+
+#include "kaleidoscope/codegen/output_sink.hpp"
+#include "util.hpp"
+
+namespace
+{
+
+// Reads everything written to a temporary file
+class TempFile
+{
+public:
+    TempFile() : file_(std::tmpfile()) {}
+    ~TempFile() { std::fclose(file_); }  // NOLINT
+
+    TempFile(const TempFile&) = delete;
+    TempFile& operator=(const TempFile&) = delete;
+
+#ifdef _WIN32
+    [[nodiscard]] int GetFd() const { return _fileno(file_); }
+#else
+    [[nodiscard]] int GetFd() const { return fileno(file_); }
+#endif
+
+    // The sinks write to the descriptor, so the stream has nothing buffered and can be read from the start
+    [[nodiscard]] std::string ReadAll() const
+    {
+        std::string text;
+        std::array<char, 4096> buffer{};
+        std::rewind(file_);
+        while (const size_t n = std::fread(buffer.data(), 1, buffer.size(), file_)) text.append(buffer.data(), n);
+        return text;
+    }
+
+private:
+    FILE* file_ = nullptr;
+};
+
+[[nodiscard]] std::string MakeText(size_t size)
+{
+    std::string text;
+    for (size_t i = 0; text.size() < size; ++i) text += std::to_string(i) + (i % 7 == 0 ? "\n" : " ");
+    text.resize(size);
+    return text;
+}
+
+}  // namespace
+
+TEST(OutputSinkTest, FixedBufferCountsDroppedText)
+{
+    std::array<char, 8> buffer{};
+    FixedBufferSink sink(buffer);
+    sink.Write("abc");
+    sink.Write("defgh");
+    ASSERT_FALSE(sink.Overflowed());
+    sink.Write("ijk");
+    ASSERT_TRUE(sink.Overflowed());
+    ASSERT_EQ(sink.GetText(), "abcdefgh");
+    ASSERT_EQ(sink.GetRequiredSize(), 11);
+
+    FixedBufferSink counter;
+    counter.Write("abc");
+    ASSERT_EQ(counter.GetRequiredSize(), 3);
+    ASSERT_EQ(counter.GetText(), "");
+}
+
+TEST(OutputSinkTest, RopeKeepsChunks)
+{
+    const std::string text = MakeText(3 * RopeSink::kChunkSize + 123);
+
+    RopeSink sink;
+    ASSERT_EQ(sink.Size(), 0);
+    ASSERT_EQ(sink.ToString(), "");
+
+    // Writes that cross chunk boundaries and one larger than a chunk
+    sink.Write(std::string_view(text).substr(0, 100));
+    sink.Write(std::string_view(text).substr(100, RopeSink::kChunkSize));
+    const char* first_chunk = sink.GetChunk(0).data();
+    sink.Write(std::string_view(text).substr(100 + RopeSink::kChunkSize));
+
+    ASSERT_EQ(sink.GetChunkCount(), 4);
+    ASSERT_EQ(sink.GetChunk(0).data(), first_chunk);
+    ASSERT_EQ(sink.Size(), text.size());
+    ASSERT_EQ(sink.ToString(), text);
+
+    TempFile file;
+    ASSERT_EQ(sink.WriteTo(file.GetFd()), 0);
+    ASSERT_EQ(file.ReadAll(), text);
+}
+
+TEST(OutputSinkTest, FdSink)
+{
+    const std::string text = MakeText(5 * FdSink::kBufferSize);
+
+    TempFile file;
+    {
+        FdSink sink(file.GetFd());
+        for (size_t i = 0; i < text.size(); i += 77) sink.Write(std::string_view(text).substr(i, 77));
+    }
+
+    ASSERT_EQ(file.ReadAll(), text);
+
+    // A large write goes directly after the buffered text
+    TempFile large;
+    {
+        FdSink sink(large.GetFd());
+        sink.Write("head ");
+        sink.Write(text);
+        sink.Write(" tail");
+        sink.Flush();
+        ASSERT_EQ(sink.GetError(), 0);
+    }
+
+    ASSERT_EQ(large.ReadAll(), "head " + text + " tail");
+}
+
+// The Windows CRT treats an invalid descriptor as an invalid parameter and terminates the process
+#ifndef _WIN32
+TEST(OutputSinkTest, FdSinkReportsErrors)
+{
+    FdSink sink(-1);
+    sink.Write(MakeText(2 * FdSink::kBufferSize));
+    ASSERT_EQ(sink.GetError(), EBADF);
+}
+#endif
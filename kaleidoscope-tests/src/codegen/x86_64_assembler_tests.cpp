@@ -0,0 +1,37 @@
+#include <algorithm>
+#include <array>
+
+#include "kaleidoscope/codegen/x86_64_assembler.hpp"
+#include "util.hpp"
+
+TEST(X86_64AssemblerTest, Encoding)
+{
+    X86_64Assembler a;
+    a.MovImmediate(X86Register::R9, -5, 32);
+    a.MovImmediate(X86Register::RSI, -5, 64);
+    a.MovImmediate(X86Register::R11, 0x123456789, 64);
+    a.Add(X86Register::R8, X86Register::R9, 64);
+    a.Sub(X86Register::RDI, X86Register::R11, 32);
+    a.IMul(X86Register::R10, X86Register::RCX, 64);
+    a.SignExtendAccumulator(64);
+    a.IDiv(X86Register::R9, 32);
+    a.Push(X86Register::R11);
+    a.Pop(X86Register::RDI);
+    a.Ret();
+
+    constexpr std::array<uint8_t, 42> kExpected{
+        0x41, 0xB9, 0xFB, 0xFF, 0xFF, 0xFF,                          // mov r9d, -5
+        0x48, 0xC7, 0xC6, 0xFB, 0xFF, 0xFF, 0xFF,                    // mov rsi, -5
+        0x49, 0xBB, 0x89, 0x67, 0x45, 0x23, 0x01, 0x00, 0x00, 0x00,  // movabs r11, 0x123456789
+        0x4D, 0x01, 0xC8,                                            // add r8, r9
+        0x44, 0x29, 0xDF,                                            // sub edi, r11d
+        0x4C, 0x0F, 0xAF, 0xD1,                                      // imul r10, rcx
+        0x48, 0x99,                                                  // cqo
+        0x41, 0xF7, 0xF9,                                            // idiv r9d
+        0x41, 0x53,                                                  // push r11
+        0x5F,                                                        // pop rdi
+        0xC3,                                                        // ret
+    };
+
+    ASSERT_TRUE(std::ranges::equal(a.GetCode(), kExpected));
+}
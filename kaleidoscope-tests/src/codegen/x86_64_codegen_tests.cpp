@@ -0,0 +1,127 @@
+#include <format>
+#include <random>
+
+#include "ir_expression_executor.hpp"
+#include "kaleidoscope/codegen/llvm_ir_codegen.hpp"
+#include "kaleidoscope/codegen/x86_64_codegen.hpp"
+#include "util.hpp"
+
+namespace
+{
+
+// Evaluates the expression with the native code and with LLVM (lli) and expects the same result
+void ExpectSameAsLLVM(std::string_view src, uint8_t bits)
+{
+    const ParsedExpression parsed = ParseWithLiteralBits(src, bits);
+
+    const auto memory = CompileX86_64(parsed.parser.GetExprs(), parsed.root);
+    ASSERT_TRUE(memory.has_value()) << src;
+
+    const GeneratedIR ir = GenerateIRString(parsed.parser.GetExprs(), parsed.root, {.first_variable_index = 1});
+    const std::string variable_name = std::format("%{}", ir.variable_index);
+    if (bits == 32)
+    {
+        const auto expected = IRExpressionExecutor::ExecI32(ir.text, variable_name);
+        ASSERT_TRUE(expected.has_value()) << src;
+        ASSERT_EQ(memory->GetFunction<int32_t()>()(), *expected) << src;
+    }
+    else
+    {
+        const auto expected = IRExpressionExecutor::ExecI64(ir.text, variable_name);
+        ASSERT_TRUE(expected.has_value()) << src;
+        ASSERT_EQ(memory->GetFunction<int64_t()>()(), *expected) << src;
+    }
+}
+
+// Random expression without division by anything but positive literals, so it is always defined
+[[nodiscard]] std::string MakeRandomExpression(std::mt19937& random, size_t depth)
+{
+    std::uniform_int_distribution<uint32_t> literal(0, 100'000);
+    if (depth == 0 || random() % 4 == 0) return std::to_string(literal(random));
+
+    constexpr std::array<std::string_view, 4> kOperators{" + ", " - ", " * ", " / "};
+    const std::string_view op = kOperators[random() % kOperators.size()];
+    std::string right = op == " / " ? std::to_string(literal(random) % 9 + 1) : MakeRandomExpression(random, depth - 1);
+    return "(" + MakeRandomExpression(random, depth - 1) + std::string(op) + right + ")";
+}
+
+}  // namespace
+
+TEST(X86_64CodeGenTest, MatchesLLVM)
+{
+    constexpr std::array<std::string_view, 6> kSources{
+        "7",
+        "42 - 21",
+        "(1 + 2) * (3 + 4) - 10 / (2 + 3)",
+        "0 - 7 / 2",
+        "1000000 * 1000000 * 7",
+        "2147483647 + 1",
+    };
+
+    for (const uint8_t bits : {uint8_t{32}, uint8_t{64}})
+    {
+        for (const std::string_view src : kSources) ExpectSameAsLLVM(src, bits);
+    }
+}
+
+TEST(X86_64CodeGenTest, SpillsDeepExpressions)
+{
+    // Right operands nest, so every level keeps one more value on the evaluation stack
+    std::string src = "100";
+    for (size_t i = 0; i != 20; ++i) src = std::format("{} - ({} * {})", i + 1, src, i % 3 + 1);
+    for (size_t i = 0; i != 20; ++i) src = std::format("{} + ({} / {})", i * 7, src, i % 4 + 1);
+
+    const ParsedExpression parsed = ParseWithLiteralBits(src, 32);
+    const auto memory = CompileX86_64(parsed.parser.GetExprs(), parsed.root);
+    ASSERT_TRUE(memory.has_value());
+
+    ExpectSameAsLLVM(src, 32);
+    ExpectSameAsLLVM(src, 64);
+}
+
+TEST(X86_64CodeGenTest, DeepExpressions)
+{
+    // Would overflow the native stack of the generator with one recursive call per operator
+    constexpr size_t kTerms = 1'000'000;
+
+    // Pairs of products: 1 * 1 + 1 * 1 + ...
+    std::string flat = "1";
+    for (size_t i = 1; i != kTerms; ++i) flat += i % 2 == 0 ? " + 1" : " * 1";
+
+    std::string nested(kTerms, '(');
+    nested += "1";
+    for (size_t i = 0; i != kTerms; ++i) nested += " + 1)";
+
+    for (const auto& [src, expected] : {std::pair{flat, kTerms / 2}, std::pair{nested, kTerms + 1}})
+    {
+        const ParsedExpression parsed = ParseWithLiteralBits(src, 64);
+        const auto memory = CompileX86_64(parsed.parser.GetExprs(), parsed.root);
+        ASSERT_TRUE(memory.has_value());
+        ASSERT_EQ(memory->GetFunction<int64_t()>()(), static_cast<int64_t>(expected));
+    }
+}
+
+TEST(X86_64CodeGenTest, RandomExpressions)
+{
+    std::mt19937 random(12345);  // NOLINT
+    for (size_t i = 0; i != 20; ++i)
+    {
+        const std::string src = MakeRandomExpression(random, 12);
+        ExpectSameAsLLVM(src, i % 2 == 0 ? 32 : 64);
+    }
+}
+
+TEST(X86_64CodeGenTest, UnsupportedTypes)
+{
+    ParsedExpression parsed = ParseWithLiteralBits("1 + 2", 16);
+    auto result = CompileX86_64(parsed.parser.GetExprs(), parsed.root);
+    ASSERT_FALSE(result.has_value());
+    ASSERT_EQ(result.error().type, X86_64CodeGenErrorType::UnsupportedType);
+
+    // Literals of different types
+    parsed.parser.GetExprs().GetNodes<IntegralLiteralExprAST>()[0].type.bits = 32;
+    parsed.parser.GetExprs().GetNodes<IntegralLiteralExprAST>()[1].type.bits = 64;
+    result = CompileX86_64(parsed.parser.GetExprs(), parsed.root);
+    ASSERT_FALSE(result.has_value());
+    ASSERT_EQ(result.error().type, X86_64CodeGenErrorType::UnsupportedType);
+}
@@ -106,13 +106,31 @@ struct IRExpressionExecutor
     [[nodiscard]] static std::expected<int32_t, ExprEvalError> ExecI32(
         std::string_view expression,
         std::string_view variable_name)
+    {
+        return ExecInteger<int32_t>(expression, variable_name, "i32", R"(%d\00)", "3");
+    }
+
+    [[nodiscard]] static std::expected<int64_t, ExprEvalError> ExecI64(
+        std::string_view expression,
+        std::string_view variable_name)
+    {
+        return ExecInteger<int64_t>(expression, variable_name, "i64", R"(%lld\00)", "5");
+    }
+
+    template <std::integral T>
+    [[nodiscard]] static std::expected<T, ExprEvalError> ExecInteger(
+        std::string_view expression,
+        std::string_view variable_name,
+        std::string_view type,
+        std::string_view format,
+        std::string_view format_length)
     {
         auto proc_result = Exec({
             .expr = expression,
-            .type = "i32",
+            .type = type,
             .var_name = variable_name,
-            .format = R"(%d\00)",
-            .format_length = "3",
+            .format = format,
+            .format_length = format_length,
         });
 
         if (!proc_result.has_value()) return std::unexpected(proc_result.error());
@@ -132,7 +150,7 @@ struct IRExpressionExecutor
         char* begin = const_cast<char*>(stdout_view.data());        // NOLINT
         char* end = const_cast<char*>(begin + stdout_view.size());  // NOLINT
 
-        int32_t v = 0;
+        T v = 0;
         auto parse_result = fast_float::from_chars(begin, end, v, 10);
         if (parse_result.ec != std::errc())
         {
@@ -0,0 +1,124 @@
+#include <format>
+
+#include "ir_expression_executor.hpp"
+#include "kaleidoscope/codegen/llvm_ir_codegen.hpp"
+#include "kaleidoscope/jit/orc_jit.hpp"
+#include "kaleidoscope/parser/parser.hpp"
+#include "util.hpp"
+
+namespace
+{
+
+[[nodiscard]] OrcJit CreateJit(OrcJitOptions options = {})
+{
+    auto jit = OrcJit::Create(options);
+    EXPECT_TRUE(jit.has_value()) << jit.error();
+    return std::move(*jit);
+}
+
+}  // namespace
+
+TEST(OrcJitTest, MatchesLLI)
+{
+    constexpr std::array<std::string_view, 5> kSources{
+        "7",
+        "42 - 21",
+        "(1 + 2) * (3 + 4) - 10 / (2 + 3)",
+        "((((1 - 2) - 3) - 4) * (5 + (6 * (7 - 8))))",
+        "1000000 * 1000000",
+    };
+
+    for (const bool optimize : {false, true})
+    {
+        OrcJit jit = CreateJit({.optimize = optimize});
+        for (const std::string_view src : kSources)
+        {
+            Lexer l(src);
+            LookaheadLexer<2> lexer(l);
+            Parser parser;
+            const auto root = parser.ParseExpression(lexer);
+            ASSERT_TRUE(root.has_value()) << src;
+
+            for (const IRCodeGenMode mode : {IRCodeGenMode::Memory, IRCodeGenMode::SSA})
+            {
+                const GeneratedIR ir =
+                    GenerateIRString(parser.GetExprs(), *root, {.first_variable_index = 1, .mode = mode});
+                const std::string variable_name = std::format("%{}", ir.variable_index);
+
+                const auto expected = IRExpressionExecutor::ExecI32(ir.text, variable_name);
+                ASSERT_TRUE(expected.has_value()) << src;
+
+                const auto actual = jit.Exec<int32_t>(ir.text, variable_name);
+                ASSERT_TRUE(actual.has_value()) << actual.error();
+                ASSERT_EQ(*actual, *expected) << src;
+            }
+        }
+    }
+}
+
+TEST(OrcJitTest, TypedResults)
+{
+    OrcJit jit = CreateJit();
+
+    const auto i64 = jit.Exec<int64_t>("%1 = mul i64 4000000000, -3\n", "%1");
+    ASSERT_TRUE(i64.has_value()) << i64.error();
+    ASSERT_EQ(*i64, -12'000'000'000);
+
+    const auto f64 = jit.Exec<double>("%1 = fadd double 1.5, 2.25\n%2 = fdiv double %1, 2.0\n", "%2");
+    ASSERT_TRUE(f64.has_value()) << f64.error();
+    ASSERT_DOUBLE_EQ(*f64, 1.875);
+}
+
+TEST(OrcJitTest, CompiledModuleCanBeCalledRepeatedly)
+{
+    OrcJit jit = CreateJit();
+
+    const auto module = jit.Compile(
+        R"(
+            define i64 @muladd(i64 %a, i64 %b, i64 %c) {
+                %1 = mul i64 %a, %b
+                %2 = add i64 %1, %c
+                ret i64 %2
+            }
+        )",
+        "muladd");
+    ASSERT_TRUE(module.has_value()) << module.error();
+
+    auto* muladd = module->GetFunction<int64_t(int64_t, int64_t, int64_t)>();
+    for (int64_t i = 0; i != 100; ++i) ASSERT_EQ(muladd(i, 3, 4), i * 3 + 4);
+}
+
+TEST(OrcJitTest, ModulesAreUnloaded)
+{
+    OrcJit jit = CreateJit();
+
+    constexpr std::string_view kModule = "define i32 @f() {\n ret i32 1\n}\n";
+    for (size_t i = 0; i != 3; ++i)
+    {
+        const auto module = jit.Compile(kModule, "f");
+        ASSERT_TRUE(module.has_value()) << module.error();
+        ASSERT_EQ(module->GetFunction<int32_t()>()(), 1);
+    }
+}
+
+TEST(OrcJitTest, Errors)
+{
+    OrcJit jit = CreateJit();
+
+    // Syntax error
+    ASSERT_FALSE(jit.Exec<int32_t>("%1 = add i32 1\n", "%1").has_value());
+
+    // Type mismatch is found by the verifier or the parser
+    ASSERT_FALSE(jit.Exec<int64_t>("%1 = add i32 1, 2\n", "%1").has_value());
+
+    // Registers of a function without arguments start from %1
+    ASSERT_FALSE(jit.Exec<int32_t>("%0 = add i32 1, 2\n", "%0").has_value());
+
+    // No such function
+    ASSERT_FALSE(jit.Compile("define i32 @f() {\n ret i32 1\n}\n", "g").has_value());
+
+    // The engine is still usable
+    const auto result = jit.Exec<int32_t>("%1 = add i32 1, 2\n", "%1");
+    ASSERT_TRUE(result.has_value()) << result.error();
+    ASSERT_EQ(*result, 3);
+}
@@ -0,0 +1,129 @@
+#include <random>
+
+#include "util.hpp"
+
+namespace
+{
+
+template <size_t horizon_size, size_t block_size>
+using BlockLookahead = BlockLookaheadLexer<horizon_size, Lexer, block_size>;
+
+using InterningLexer = BasicLexer<WithSymbolTable<CompactLexerTraits, SymbolTable>>;
+
+}  // namespace
+
+TEST(BlockLookaheadLexerTest, SameAsLookaheadLexer)
+{
+    constexpr std::string_view src = "def foo x - x + 0x1F * 1.5e3 // comment\n extern bar / 08 \"str\" /* block */ 1e";
+    const std::initializer_list<ExpectedResult> expected{
+        Tok("def", TokenType::Def),
+        Tok("foo", kIdentifier),
+        Tok("x", kIdentifier),
+        Tok("-", TokenType::Minus),
+        Tok("x", kIdentifier),
+        Tok("+", TokenType::Plus),
+        Tok("0x1F", kHexLiteral),
+        Tok("*", TokenType::Asterisk),
+        Tok("1.5e3", kFloatLiteral),
+        Tok("// comment", TokenType::Comment),
+        Tok("extern", TokenType::Extern),
+        Tok("bar", kIdentifier),
+        Tok("/", TokenType::ForwardSlash),
+        Err("08", LexerErrorType::UnexpectedSymbol),
+        Tok("\"str\"", TokenType::StringLiteral),
+        Tok("/* block */", TokenType::BlockComment),
+        Err("1e", LexerErrorType::ZeroLengthExponentInScientificNotation),
+        Tok("", kEOF),
+        Tok("", kEOF),
+    };
+
+    CheckLookaheadOutput<2>(std::source_location::current(), src, expected);
+    CheckLookaheadOutput<2, BlockLookahead<2, 1>>(std::source_location::current(), src, expected);
+    CheckLookaheadOutput<3, BlockLookahead<3, 4>>(std::source_location::current(), src, expected);
+    CheckLookaheadOutput<5, BlockLookahead<5, 64>>(std::source_location::current(), src, expected);
+}
+
+TEST(BlockLookaheadLexerTest, Checkpoints)
+{
+    std::string src;
+    for (size_t i = 0; i != 1000; ++i) src += "a" + std::to_string(i) + " ";
+
+    // Results of a plain lexer, indexed by token number
+    std::vector<LexerResult> reference;
+    {
+        Lexer lexer(src);
+        for (size_t i = 0; i != 1010; ++i) reference.push_back(lexer.GetToken());
+    }
+
+    Lexer lexer(src);
+    BlockLookahead<4, 8> lookahead(lexer);
+    std::mt19937 rnd(42);  // NOLINT
+    std::vector<LookaheadCheckpoint> checkpoints;
+
+    for (size_t step = 0; step != 20'000 && lookahead.GetTokenIndex() < 1000; ++step)
+    {
+        const size_t index = lookahead.GetTokenIndex();
+        for (size_t i = 0; i != 4; ++i)
+        {
+            ASSERT_EQ(lookahead.Peek(i), reference[index + i]) << "step " << step << ", peek " << i;
+        }
+
+        switch (rnd() % 8)
+        {
+        case 0:
+            checkpoints.push_back(lookahead.Save());
+            break;
+        case 1:
+            if (!checkpoints.empty())
+            {
+                lookahead.Rewind(checkpoints[rnd() % checkpoints.size()]);
+            }
+            break;
+        case 2:
+            if (!checkpoints.empty())
+            {
+                lookahead.Release(checkpoints.back());
+                checkpoints.pop_back();
+            }
+            break;
+        default:
+            ASSERT_EQ(lookahead.Take(), reference[index]);
+            break;
+        }
+    }
+}
+
+TEST(BlockLookaheadLexerTest, DecodingLexer)
+{
+    constexpr std::string_view src = "1 0x10 2.5 x";
+    DecodingLexer lexer(src);
+    BlockLookaheadLexer<2, DecodingLexer, 2> lookahead(lexer);
+
+    ASSERT_EQ(lookahead.PeekLiteralValue(1), LiteralValue{uint64_t{16}});
+    ASSERT_EQ(lookahead.PeekLiteralValue(0), LiteralValue{uint64_t{1}});
+    std::ignore = lookahead.Take();
+    std::ignore = lookahead.Take();
+    ASSERT_EQ(lookahead.PeekLiteralValue(0), LiteralValue{2.5});
+}
+
+TEST(BlockLookaheadLexerTest, InterningLexer)
+{
+    constexpr std::string_view src = "a b a c";
+    SymbolTable symbols;
+    InterningLexer lexer(src, symbols);
+    BlockLookaheadLexer<2, InterningLexer, 1> lookahead(lexer);
+
+    ASSERT_EQ(lookahead.PeekSymbolId(0), 0u);
+    ASSERT_EQ(lookahead.PeekSymbolId(1), 1u);
+
+    // Symbols are kept with their tokens when the ring grows for a checkpoint
+    const LookaheadCheckpoint start = lookahead.Save();
+    std::ignore = lookahead.Take();
+    std::ignore = lookahead.Take();
+    ASSERT_EQ(lookahead.PeekSymbolId(0), 0u);
+    ASSERT_EQ(lookahead.PeekSymbolId(1), 2u);
+
+    lookahead.Rewind(start);
+    lookahead.Release(start);
+    ASSERT_EQ(lookahead.PeekSymbolId(1), 1u);
+}
@@ -0,0 +1,104 @@
+#include <array>
+#include <random>
+#include <string>
+
+#include "kaleidoscope/lexer/char_class_scan.hpp"
+#include "util.hpp"
+
+namespace
+{
+
+[[nodiscard]] std::string MakeCharClassScanInput(std::mt19937& rng)
+{
+    // Mix members of all classes with bytes just outside of their ranges, delimiters and non-ASCII bytes
+    constexpr std::string_view alphabet = " \t\n\v\f\rabzAZ09_@[`{/+-*\"\\\x80\xff\x08\x0e";
+
+    std::string s;
+    const size_t groups = rng() % 32;
+    for (size_t i = 0; i != groups; ++i)
+    {
+        const char c = alphabet[rng() % alphabet.size()];
+        s.append(rng() % 80, c);
+        s.push_back(alphabet[rng() % alphabet.size()]);
+    }
+
+    return s;
+}
+
+inline constexpr std::array kAllCharClasses{
+    CharClass::Space,
+    CharClass::IdentifierTail,
+    CharClass::LineCommentBody,
+    CharClass::BlockCommentBody,
+    CharClass::StringLiteralBody,
+};
+
+}  // namespace
+
+static_assert(ScanCharClass("  \t\n x", 0, CharClass::Space) == 5);
+static_assert(ScanCharClass("abc_123 ", 0, CharClass::IdentifierTail) == 7);
+static_assert(ScanCharClass("a \"\\*\n", 0, CharClass::LineCommentBody) == 5);
+static_assert(ScanCharClass("a \"\\*\n", 0, CharClass::BlockCommentBody) == 4);
+static_assert(ScanCharClass("a \"\\*\n", 0, CharClass::StringLiteralBody) == 2);
+
+TEST(CharClassScanTest, VectorPathsMatchScalar)
+{
+    std::mt19937 rng(42);  // NOLINT
+    for (size_t iteration = 0; iteration != 500; ++iteration)
+    {
+        const std::string s = MakeCharClassScanInput(rng);
+        for (size_t pos = 0; pos <= s.size(); ++pos)
+        {
+            for (const CharClass char_class : kAllCharClasses)
+            {
+                const size_t expected = ScanCharClassScalar(s, pos, char_class);
+                ASSERT_EQ(ScanCharClass(s, pos, char_class), expected);
+                ASSERT_EQ(ScanCharClassVectorized(s, pos, char_class), expected);
+#if KALEIDOSCOPE_LEXER_X86_SIMD
+                ASSERT_EQ(ScanCharClassSSE2(s, pos, char_class), expected);
+                if (IsAVX2Supported())
+                {
+                    ASSERT_EQ(ScanCharClassAVX2(s, pos, char_class), expected);
+                }
+#endif
+            }
+        }
+    }
+}
+
+TEST(CharClassScanTest, LongRuns)
+{
+    const std::string spaces(100, ' ');
+    const std::string identifier = "a" + std::string(70, '_') + "0123456789";
+    const std::string src = spaces + identifier + "\t\n" + spaces + "+" + identifier + spaces;
+
+    CheckLexerOutput(
+        std::source_location::current(),
+        src,
+        {
+            Tok(identifier, kIdentifier),
+            Tok("+", TokenType::Plus),
+            Tok(identifier, kIdentifier),
+            Tok("", kEOF),
+        });
+}
+
+TEST(CharClassScanTest, LongCommentsAndStrings)
+{
+    const std::string text(100, 'x');
+    const std::string line_comment = "// " + text + " /* \" */";
+    const std::string block_comment = "/* " + text + " * / ** // \n \" " + text + "**/";
+    const std::string string_literal = "\"" + text + " \\\" \\ * /* " + text + "\"";
+
+    CheckLexerOutput(
+        std::source_location::current(),
+        line_comment + "\n" + block_comment + string_literal + " \"" + text + "\n" + "/* " + text,
+        {
+            Tok(line_comment, TokenType::Comment),
+            Tok(block_comment, TokenType::BlockComment),
+            Tok(string_literal, TokenType::StringLiteral),
+            Err("\"" + text, LexerErrorType::MissingTerminatingCharacterForStringLiteral),
+            Err("/* " + text, LexerErrorType::UnterminatedBlockComment),
+            Tok("", kEOF),
+        });
+}
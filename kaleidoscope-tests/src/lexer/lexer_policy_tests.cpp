@@ -0,0 +1,100 @@
+#include "util.hpp"
+
+namespace
+{
+
+using NoTriviaLexer = BasicLexer<WithTrivia<CompactLexerTraits, false>>;
+using LineColumnLexer = BasicLexer<WithLineColumnTracking<CompactLexerTraits, true>>;
+using FastFailLexer = BasicLexer<WithErrorMode<CompactLexerTraits, LexerErrorMode::FastFail>>;
+
+}  // namespace
+
+// Disabled options take no space
+static_assert(sizeof(Lexer) == sizeof(NoTriviaLexer));
+static_assert(sizeof(Lexer) == sizeof(FastFailLexer));
+static_assert(sizeof(Lexer) < sizeof(LineColumnLexer));
+
+TEST(LexerPolicyTest, DropTrivia)
+{
+    CheckLexerOutput<NoTriviaLexer>(
+        std::source_location::current(),
+        "a // line\nb /* block\n */ c/**/d // end",
+        {
+            Tok("a", kIdentifier),
+            Tok("b", kIdentifier),
+            Tok("c", kIdentifier),
+            Tok("d", kIdentifier),
+            Tok("", kEOF),
+        });
+}
+
+TEST(LexerPolicyTest, DropTriviaUnterminatedBlockComment)
+{
+    CheckLexerOutput<NoTriviaLexer>(
+        std::source_location::current(),
+        "a /* b",
+        {
+            Tok("a", kIdentifier),
+            Err("/* b", LexerErrorType::UnterminatedBlockComment),
+            Tok("", kEOF),
+        });
+}
+
+TEST(LexerPolicyTest, DropTriviaLongComment)
+{
+    // Skipped comments are not tokens, so their length is not limited
+    std::string src = "a /*";
+    src.append(LexerToken::kMaxLength + 10, 'x');
+    src += "*/ b";
+
+    NoTriviaLexer lexer(src);
+    ASSERT_EQ(lexer.GetToken()->GetType(), kIdentifier);
+    const LexerResult b = lexer.GetToken();
+    ASSERT_TRUE(b.has_value());
+    ASSERT_EQ(b->GetBegin(), src.size() - 1);
+    ASSERT_EQ(lexer.GetToken()->GetType(), kEOF);
+}
+
+TEST(LexerPolicyTest, LineColumn)
+{
+    constexpr std::string_view src = "a bc\n  d /* x\n\n */ e\n\n\"s\" // z\n$";
+
+    const std::vector<LineColumn> expected{
+        {.line = 1, .column = 1},  // a
+        {.line = 1, .column = 3},  // bc
+        {.line = 2, .column = 3},  // d
+        {.line = 2, .column = 5},  // block comment
+        {.line = 4, .column = 5},  // e
+        {.line = 6, .column = 1},  // "s"
+        {.line = 6, .column = 5},  // line comment
+        {.line = 7, .column = 1},  // $
+        {.line = 7, .column = 2},  // EndOfFile
+    };
+
+    LineColumnLexer lexer(src);
+    for (const LineColumn& location : expected)
+    {
+        std::ignore = lexer.GetToken();
+        ASSERT_EQ(lexer.GetLineColumn(), location) << "at offset " << lexer.GetPosition();
+    }
+}
+
+TEST(LexerPolicyTest, LineColumnFromStartPosition)
+{
+    constexpr std::string_view src = "a\nb\n  c";
+    LineColumnLexer lexer(src, 4);
+    ASSERT_EQ(lexer.GetToken()->GetType(), kIdentifier);
+    ASSERT_EQ(lexer.GetLineColumn(), (LineColumn{.line = 3, .column = 3}));
+}
+
+TEST(LexerPolicyTest, FastFail)
+{
+    CheckLexerOutput<FastFailLexer>(
+        std::source_location::current(),
+        "a 0x b",
+        {
+            Tok("a", kIdentifier),
+            Err("0x", LexerErrorType::UnexpectedSymbol),
+            Tok("", kEOF),
+        });
+}
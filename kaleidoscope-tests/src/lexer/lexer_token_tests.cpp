@@ -0,0 +1,67 @@
+#include "util.hpp"
+
+static_assert(sizeof(LexerToken) == 8);
+static_assert(sizeof(LexerResult) == 12);
+static_assert(LexerToken{}.GetType() == TokenType::EndOfFile);
+static_assert(LargeLexerToken{}.GetType() == TokenType::EndOfFile);
+static_assert(LexerToken{}.GetLength() == 0);
+static_assert(sizeof(LookaheadLexer<4>) <= sizeof(void*) + 4 * sizeof(LexerResult) + sizeof(size_t));
+
+TEST(LexerTokenTest, CompactRoundTrip)
+{
+    constexpr LexerToken token(TokenType::BlockComment, 0xFFFF'0000, 0xFFFF'0000 + LexerToken::kMaxLength);
+    static_assert(token.GetType() == TokenType::BlockComment);
+    static_assert(token.GetBegin() == 0xFFFF'0000);
+    static_assert(token.GetLength() == LexerToken::kMaxLength);
+    static_assert(token.GetEnd() == 0xFFFF'0000 + LexerToken::kMaxLength);
+
+    for (const TokenType type : magic_enum::enum_values<TokenType>())
+    {
+        const LexerToken t(type, 1, 3);
+        ASSERT_EQ(t.GetType(), type);
+        ASSERT_EQ(t.GetBegin(), 1uz);
+        ASSERT_EQ(t.GetEnd(), 3uz);
+    }
+}
+
+TEST(LexerTokenTest, TokenTooLong)
+{
+    const std::string identifier(LexerToken::kMaxLength + 1, 'a');
+    const std::string src = identifier + " b";
+
+    Lexer lexer(src);
+    auto r = lexer.GetToken();
+    ASSERT_FALSE(r.has_value());
+    ASSERT_EQ(r.error().GetType(), LexerErrorType::TokenTooLong);
+    ASSERT_EQ(r.error().GetBegin(), 0uz);
+    ASSERT_EQ(r.error().GetLength(), LexerError::kMaxLength);
+
+    r = lexer.GetToken();
+    ASSERT_TRUE(r.has_value());
+    ASSERT_EQ(lexer.GetTokenView(*r), "b");
+}
+
+TEST(LexerTokenTest, LargeFileLexer)
+{
+    const std::string identifier(LexerToken::kMaxLength + 1, 'a');
+    const std::string src = identifier + " 0x1F";
+
+    CheckLexerOutput<LargeFileLexer>(
+        std::source_location::current(),
+        src,
+        {
+            Tok(identifier, kIdentifier),
+            Tok("0x1F", kHexLiteral),
+            Tok("", kEOF),
+        });
+
+    CheckLexerOutput<LargeFileLexer>(
+        std::source_location::current(),
+        "def x 0..",
+        {
+            Tok("def", TokenType::Def),
+            Tok("x", kIdentifier),
+            Err("0..", LexerErrorType::MultipleDotsInFloatingPointLiteral),
+            Tok("", kEOF),
+        });
+}
@@ -0,0 +1,149 @@
+#include <limits>
+#include <random>
+
+#include "kaleidoscope/lexer/literal_decoder.hpp"
+#include "kaleidoscope/lexer/lookahead_lexer.hpp"
+#include "util.hpp"
+
+namespace
+{
+
+// One digit at a time, used as a reference for SWAR decoding
+[[nodiscard]] uint64_t DecodeSlow(std::string_view digits, uint64_t base)
+{
+    uint64_t value = 0;
+    for (const char c : digits)
+    {
+        const auto lower = static_cast<char>(c | 0x20);
+        value = value * base + static_cast<uint64_t>(lower >= 'a' ? lower - 'a' + 10 : c - '0');
+    }
+
+    return value;
+}
+
+}  // namespace
+
+static_assert(ParseEightDecimalDigits(LoadEightChars("12345678")) == 12345678);
+static_assert(PackEightDigits<4>(GetDigitValues<4>(LoadEightChars("DeadBeef"))) == 0xDEADBEEF);
+static_assert(PackEightDigits<3>(GetDigitValues<3>(LoadEightChars("01234567"))) == 01234567);
+static_assert(PackEightDigits<1>(GetDigitValues<1>(LoadEightChars("10000001"))) == 0b10000001);
+static_assert(DecodeIntegerLiteral(TokenType::DecimalLiteral, "18446744073709551615") == UINT64_MAX);
+static_assert(DecodeIntegerLiteral(TokenType::HexadecimalLiteral, "0x00000000ffffFFFFffffFFFF") == UINT64_MAX);
+
+static_assert(CheckedMultiplyAdd(UINT64_MAX / 10, 10, 5) == UINT64_MAX);
+static_assert(!CheckedMultiplyAdd(UINT64_MAX / 10, 10, 6).has_value());
+static_assert(!CheckedMultiplyAdd(UINT64_MAX / 100'000'000 + 1, 100'000'000, 0).has_value());
+static_assert(CheckedAdd(INT64_MAX, INT64_MIN) == -1);
+static_assert(!CheckedAdd(INT64_MAX, 1).has_value());
+static_assert(!CheckedAdd(INT64_MIN, -1).has_value());
+static_assert(CheckedSubtract(-1, INT64_MAX) == INT64_MIN);
+static_assert(!CheckedSubtract(INT64_MIN, 1).has_value());
+static_assert(!CheckedSubtract(0, INT64_MIN).has_value());
+static_assert(CheckedMultiply(INT64_MIN, 1) == INT64_MIN);
+static_assert(CheckedMultiply(-3'037'000'499, 3'037'000'499) == -9'223'372'030'926'249'001);
+static_assert(!CheckedMultiply(INT64_MIN, -1).has_value());
+static_assert(!CheckedMultiply(-1, INT64_MIN).has_value());
+static_assert(!CheckedMultiply(3'037'000'500, 3'037'000'500).has_value());
+static_assert(!CheckedMultiply(-3'037'000'500, -3'037'000'500).has_value());
+static_assert(!CheckedMultiply(-3'037'000'500, 3'037'000'500).has_value());
+
+TEST(LiteralDecoderTest, IntegerLiterals)
+{
+    ASSERT_EQ(DecodeIntegerLiteral(TokenType::DecimalLiteral, "0"), 0u);
+    ASSERT_EQ(DecodeIntegerLiteral(TokenType::DecimalLiteral, "1234567890123"), 1234567890123u);
+    ASSERT_EQ(DecodeIntegerLiteral(TokenType::HexadecimalLiteral, "0x1F"), 0x1Fu);
+    ASSERT_EQ(DecodeIntegerLiteral(TokenType::HexadecimalLiteral, "0X123456789abcdef"), 0x123456789ABCDEFu);
+    ASSERT_EQ(DecodeIntegerLiteral(TokenType::BinaryLiteral, "0b"), 0u);
+    ASSERT_EQ(DecodeIntegerLiteral(TokenType::BinaryLiteral, "0b1011001110001111"), 0b1011001110001111u);
+    ASSERT_EQ(DecodeIntegerLiteral(TokenType::OctalLiteral, "017"), 017u);
+    ASSERT_EQ(DecodeIntegerLiteral(TokenType::OctalLiteral, "01777777777777777777777"), UINT64_MAX);
+}
+
+TEST(LiteralDecoderTest, IntegerOverflow)
+{
+    constexpr auto kOverflow = std::unexpected(LexerErrorType::IntegerLiteralOverflow);
+    ASSERT_EQ(DecodeIntegerLiteral(TokenType::DecimalLiteral, "18446744073709551616"), kOverflow);
+    ASSERT_EQ(DecodeIntegerLiteral(TokenType::DecimalLiteral, "99999999999999999999"), kOverflow);
+    ASSERT_EQ(DecodeIntegerLiteral(TokenType::DecimalLiteral, "100000000000000000000"), kOverflow);
+    ASSERT_EQ(DecodeIntegerLiteral(TokenType::HexadecimalLiteral, "0x10000000000000000"), kOverflow);
+    ASSERT_EQ(DecodeIntegerLiteral(TokenType::OctalLiteral, "02000000000000000000000"), kOverflow);
+    ASSERT_EQ(DecodeIntegerLiteral(TokenType::BinaryLiteral, "0b1" + std::string(64, '0')), kOverflow);
+}
+
+TEST(LiteralDecoderTest, MatchesDigitByDigit)
+{
+    constexpr std::string_view hex_digits = "0123456789abcdefABCDEF";
+
+    std::mt19937 rng(42);  // NOLINT
+    for (size_t iteration = 0; iteration != 10'000; ++iteration)
+    {
+        const size_t length = 1 + rng() % 16;
+        std::string hex = "0x";
+        std::string octal = "0";
+        std::string decimal;
+        for (size_t i = 0; i != length; ++i)
+        {
+            hex.push_back(hex_digits[rng() % hex_digits.size()]);
+            octal.push_back(static_cast<char>('0' + rng() % 8));
+            decimal.push_back(static_cast<char>('0' + rng() % 10));
+        }
+
+        ASSERT_EQ(DecodeIntegerLiteral(TokenType::HexadecimalLiteral, hex), DecodeSlow(hex.substr(2), 16)) << hex;
+        ASSERT_EQ(DecodeIntegerLiteral(TokenType::OctalLiteral, octal), DecodeSlow(octal, 8)) << octal;
+        ASSERT_EQ(DecodeIntegerLiteral(TokenType::DecimalLiteral, decimal), DecodeSlow(decimal, 10)) << decimal;
+    }
+}
+
+TEST(LiteralDecoderTest, FloatLiterals)
+{
+    ASSERT_EQ(DecodeFloatLiteral("1.5"), 1.5);
+    ASSERT_EQ(DecodeFloatLiteral(".25"), 0.25);
+    ASSERT_EQ(DecodeFloatLiteral("0."), 0.0);
+    ASSERT_EQ(DecodeFloatLiteral("2E-3"), 2e-3);
+    ASSERT_EQ(DecodeFloatLiteral("1e-400"), 0.0);
+    ASSERT_EQ(DecodeFloatLiteral("1e400"), std::unexpected(LexerErrorType::FloatLiteralOutOfRange));
+    ASSERT_EQ(DecodeFloatLiteral("12a"), std::unexpected(LexerErrorType::UnexpectedSymbol));
+}
+
+TEST(LiteralDecoderTest, DecodingLexer)
+{
+    constexpr std::string_view src = "42 0x1F 1.5 abc 18446744073709551616 1e400 12a";
+    DecodingLexer lexer(src);
+
+    auto next_value = [&]
+    {
+        const auto r = lexer.GetToken();
+        EXPECT_TRUE(r.has_value());
+        return lexer.GetLiteralValue();
+    };
+
+    ASSERT_EQ(next_value(), LiteralValue{uint64_t{42}});
+    ASSERT_EQ(next_value(), LiteralValue{uint64_t{0x1F}});
+    ASSERT_EQ(next_value(), LiteralValue{1.5});
+    ASSERT_EQ(lexer.GetToken()->GetType(), kIdentifier);
+
+    CheckLexerOutput<DecodingLexer>(
+        std::source_location::current(),
+        "18446744073709551615 18446744073709551616 1e400 12a",
+        {
+            Tok("18446744073709551615", kDecimalLiteral),
+            Err("18446744073709551616", LexerErrorType::IntegerLiteralOverflow),
+            Err("1e400", LexerErrorType::FloatLiteralOutOfRange),
+            Err("12a", LexerErrorType::UnexpectedSymbol),
+            Tok("", kEOF),
+        });
+}
+
+TEST(LiteralDecoderTest, LookaheadKeepsValues)
+{
+    DecodingLexer lexer("1 + 0b11 * 2.5");
+    LookaheadLexer<3, DecodingLexer> lookahead(lexer);
+
+    ASSERT_EQ(lookahead.PeekLiteralValue(0), LiteralValue{uint64_t{1}});
+    ASSERT_EQ(lookahead.PeekLiteralValue(2), LiteralValue{uint64_t{3}});
+    [[maybe_unused]] auto r = lookahead.Take();
+    r = lookahead.Take();
+    r = lookahead.Take();
+    r = lookahead.Take();
+    ASSERT_EQ(lookahead.PeekLiteralValue(), LiteralValue{2.5});
+}
@@ -0,0 +1,76 @@
+#include <random>
+
+#include "kaleidoscope/lexer/number_literal_dfa.hpp"
+#include "util.hpp"
+
+namespace
+{
+
+using HandWrittenLexer = BasicLexer<WithNumberLiteralEngine<CompactLexerTraits, NumberLiteralEngine::HandWritten>>;
+using DfaLexer = BasicLexer<WithNumberLiteralEngine<CompactLexerTraits, NumberLiteralEngine::Dfa>>;
+
+template <typename LexerType>
+[[nodiscard]] constexpr std::vector<LexerResult> LexAll(std::string_view src)
+{
+    std::vector<LexerResult> results;
+    LexerType lexer(src);
+    while (true)
+    {
+        results.push_back(lexer.GetToken());
+        if (results.back().has_value() && results.back()->GetType() == TokenType::EndOfFile) break;
+    }
+
+    return results;
+}
+
+}  // namespace
+
+static_assert(IsFinalNumberDfaState(GetNextNumberDfaState(NumberDfaState::Zero, std::nullopt)));
+static_assert(kNumberLiteralDfa.GetNextState(NumberDfaState::Start, '0') == NumberDfaState::Zero);
+static_assert(kNumberLiteralDfa.GetNextState(NumberDfaState::Zero, 'x') == NumberDfaState::HexadecimalPrefix);
+static_assert(LexAll<DfaLexer>("0x1F 1.5e+3 017 .e3") == LexAll<HandWrittenLexer>("0x1F 1.5e+3 017 .e3"));
+
+TEST(NumberLiteralDfaTest, AllLiteralKinds)
+{
+    CheckLexerOutput<DfaLexer>(
+        std::source_location::current(),
+        "0 12 0x1F 0b101 017 1.5 1e3 2E-3 0.e0 0x 0b2 08 .e3 1e 1e+ 0.. 1e3x 12a 1.5+2",
+        {
+            Tok("0", kDecimalLiteral),
+            Tok("12", kDecimalLiteral),
+            Tok("0x1F", kHexLiteral),
+            Tok("0b101", kBinaryLiteral),
+            Tok("017", kOctalLiteral),
+            Tok("1.5", kFloatLiteral),
+            Tok("1e3", kFloatLiteral),
+            Tok("2E-3", kFloatLiteral),
+            Tok("0.e0", kFloatLiteral),
+            Err("0x", LexerErrorType::UnexpectedSymbol),
+            Err("0b2", LexerErrorType::UnexpectedSymbol),
+            Err("08", LexerErrorType::UnexpectedSymbol),
+            Err(".e3", LexerErrorType::NeedAtLeastOneDigitAroundDotInFloatLiteral),
+            Err("1e", LexerErrorType::ZeroLengthExponentInScientificNotation),
+            Err("1e+", LexerErrorType::ZeroLengthExponentInScientificNotation),
+            Err("0..", LexerErrorType::MultipleDotsInFloatingPointLiteral),
+            Err("1e3x", LexerErrorType::UnexpectedSymbol),
+            Tok("12a", kFloatLiteral),
+            Tok("1.5+2", kFloatLiteral),
+            Tok("", kEOF),
+        });
+}
+
+// Both engines must produce exactly the same results on any input
+TEST(NumberLiteralDfaTest, MatchesHandWrittenReaders)
+{
+    constexpr std::string_view alphabet = "0123456789..eExXbB_+-*/ a\"";
+
+    std::mt19937 rng(42);  // NOLINT
+    for (size_t iteration = 0; iteration != 20'000; ++iteration)
+    {
+        std::string src;
+        const size_t length = 1 + rng() % 12;
+        for (size_t i = 0; i != length; ++i) src.push_back(alphabet[rng() % alphabet.size()]);
+
+        ASSERT_EQ(LexAll<DfaLexer>(src), LexAll<HandWrittenLexer>(src)) << src;
+    }
+}
@@ -0,0 +1,47 @@
+#include "kaleidoscope/lexer/perfect_hash.hpp"
+#include "test_data/extended_keywords.hpp"
+#include "util.hpp"
+
+namespace
+{
+
+inline constexpr auto kExtendedKeywordLookup = MakePerfectHashMap<SampledStringHasher, kExtendedKeywords>();
+
+}  // namespace
+
+static_assert(decltype(kExtendedKeywordLookup)::kSize <= 32);
+static_assert(*kKeywordLookup.Find("def") == TokenType::Def);
+static_assert(*kOperatorSymbolLookup.Find('/') == TokenType::ForwardSlash);
+static_assert(!kOperatorSymbolLookup.Contains('\0'));
+
+TEST(PerfectHashTest, FindsAllKeys)
+{
+    for (const auto& [key, value] : kExtendedKeywords)
+    {
+        const int* found = kExtendedKeywordLookup.Find(key);
+        ASSERT_NE(found, nullptr);
+        ASSERT_EQ(*found, value);
+    }
+
+    for (const auto& [key, value] : kKeywords)
+    {
+        const TokenType* found = kKeywordLookup.Find(key);
+        ASSERT_NE(found, nullptr);
+        ASSERT_EQ(*found, value);
+    }
+}
+
+TEST(PerfectHashTest, RejectsNonKeys)
+{
+    for (std::string_view s : {"", "d", "de", "deff", "fed", "iff", "i", "thenn", "els", "var_", "dex", "extern_"})
+    {
+        ASSERT_FALSE(kExtendedKeywordLookup.Contains(s)) << s;
+        ASSERT_FALSE(kKeywordLookup.Contains(s)) << s;
+    }
+
+    for (size_t c = 0; c != 256; ++c)
+    {
+        const char ch = std::bit_cast<char>(static_cast<uint8_t>(c));
+        ASSERT_EQ(kOperatorSymbolLookup.Contains(ch), kOperatorSymbolChars.Get(c));
+    }
+}
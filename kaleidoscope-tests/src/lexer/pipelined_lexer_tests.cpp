@@ -0,0 +1,126 @@
+#include <random>
+#include <thread>
+
+#include "kaleidoscope/lexer/pipelined_lexer.hpp"
+#include "util.hpp"
+
+namespace
+{
+
+[[nodiscard]] std::string MakeSource(size_t token_count)
+{
+    std::mt19937 rnd(42);  // NOLINT
+    std::string src;
+    for (size_t i = 0; i != token_count; ++i)
+    {
+        switch (rnd() % 6)
+        {
+        case 0:
+            src += "name" + std::to_string(i) + " ";
+            break;
+        case 1:
+            src += std::to_string(rnd()) + " ";
+            break;
+        case 2:
+            src += "+ ";
+            break;
+        case 3:
+            src += "// comment\n";
+            break;
+        case 4:
+            src += "0x ";
+            break;
+        default:
+            src += "\"str\" ";
+            break;
+        }
+    }
+
+    return src;
+}
+
+}  // namespace
+
+TEST(SpscQueueTest, TwoThreads)
+{
+    constexpr size_t kCount = 100'000;
+    SpscQueue<size_t, 4> queue;
+
+    std::jthread producer(
+        [&]
+        {
+            for (size_t i = 0; i != kCount; ++i)
+            {
+                size_t* slot = nullptr;
+                while ((slot = queue.TryGetWriteSlot()) == nullptr) std::this_thread::yield();
+                *slot = i;
+                queue.Publish();
+            }
+        });
+
+    for (size_t i = 0; i != kCount; ++i)
+    {
+        const size_t* slot = nullptr;
+        while ((slot = queue.TryGetReadSlot()) == nullptr) std::this_thread::yield();
+        ASSERT_EQ(*slot, i);
+        queue.Release();
+    }
+
+    ASSERT_EQ(queue.TryGetReadSlot(), nullptr);
+}
+
+TEST(PipelinedLexerTest, SameAsLexer)
+{
+    const std::string src = MakeSource(20'000);
+
+    // Small batches and a short queue make both threads wait for each other
+    Lexer lexer(src);
+    PipelinedLexer<Lexer, 7, 2> pipelined(src);
+    while (true)
+    {
+        const LexerResult expected = lexer.GetToken();
+        ASSERT_EQ(pipelined.GetToken(), expected);
+        if (expected.has_value() && expected->GetType() == TokenType::EndOfFile) break;
+    }
+
+    // Keeps returning EndOfFile like the lexer does
+    ASSERT_EQ(pipelined.GetToken(), lexer.GetToken());
+    ASSERT_EQ(pipelined.GetToken(), lexer.GetToken());
+}
+
+TEST(PipelinedLexerTest, Lookahead)
+{
+    using Pipelined = PipelinedLexer<DecodingLexer, 4, 2>;
+    constexpr std::string_view src = "a 1 0x10 2.5";
+
+    Pipelined pipelined(src);
+    LookaheadLexer<3, Pipelined> lookahead(pipelined);
+    ASSERT_EQ(lookahead.Peek(0)->GetType(), kIdentifier);
+    ASSERT_EQ(lookahead.PeekLiteralValue(1), LiteralValue{uint64_t{1}});
+    ASSERT_EQ(lookahead.PeekLiteralValue(2), LiteralValue{uint64_t{16}});
+    ASSERT_EQ(lookahead.GetTokenView(*lookahead.Take()), "a");
+    std::ignore = lookahead.Take();
+    std::ignore = lookahead.Take();
+    ASSERT_EQ(lookahead.PeekLiteralValue(0), LiteralValue{2.5});
+    ASSERT_EQ(lookahead.Peek(1)->GetType(), kEOF);
+}
+
+TEST(PipelinedLexerTest, StopBeforeEnd)
+{
+    // The lexer thread is blocked on the full queue when the consumer goes away
+    const std::string src = MakeSource(20'000);
+    for (size_t taken : {0uz, 1uz, 100uz})
+    {
+        PipelinedLexer<Lexer, 8, 2> pipelined(src);
+        for (size_t i = 0; i != taken; ++i) std::ignore = pipelined.GetToken();
+    }
+}
+
+TEST(PipelinedLexerTest, FastFail)
+{
+    using FastFailLexer = BasicLexer<WithErrorMode<CompactLexerTraits, LexerErrorMode::FastFail>>;
+    PipelinedLexer<FastFailLexer> pipelined("a 0x b c");
+    ASSERT_EQ(pipelined.GetToken()->GetType(), kIdentifier);
+    ASSERT_FALSE(pipelined.GetToken().has_value());
+    ASSERT_EQ(pipelined.GetToken()->GetType(), kEOF);
+}
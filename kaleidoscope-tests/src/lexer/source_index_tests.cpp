@@ -0,0 +1,123 @@
+#include <random>
+
+#include "kaleidoscope/lexer/source_index.hpp"
+#include "util.hpp"
+
+namespace
+{
+
+[[nodiscard]] LineColumn GetLineColumnNaive(std::string_view text, size_t offset)
+{
+    LineColumn result;
+    for (const char c : text.substr(0, offset))
+    {
+        if (c == '\n')
+        {
+            ++result.line;
+            result.column = 1;
+        }
+        else
+        {
+            ++result.column;
+        }
+    }
+
+    return result;
+}
+
+}  // namespace
+
+TEST(LineIndexTest, Simple)
+{
+    LineIndex index("ab\n\ncd\n");
+    ASSERT_EQ(index.GetLineColumn(0), (LineColumn{.line = 1, .column = 1}));
+    ASSERT_EQ(index.GetLineColumn(2), (LineColumn{.line = 1, .column = 3}));
+    ASSERT_EQ(index.GetLineColumn(3), (LineColumn{.line = 2, .column = 1}));
+    ASSERT_EQ(index.GetLineColumn(5), (LineColumn{.line = 3, .column = 2}));
+    ASSERT_EQ(index.GetLineColumn(7), (LineColumn{.line = 4, .column = 1}));
+    ASSERT_EQ(index.GetLineBegin(3), 4uz);
+    ASSERT_EQ(index.GetLineBegin(4), 7uz);
+}
+
+TEST(LineIndexTest, MatchesNaive)
+{
+    std::mt19937 rnd(42);  // NOLINT
+    std::string text(200'000, 'a');
+    for (char& c : text)
+    {
+        if (rnd() % 20 == 0) c = '\n';
+    }
+
+    LineIndex index(text);
+    for (size_t i = 0; i != 2000; ++i)
+    {
+        // Both random and ascending queries, the index grows in steps
+        const size_t offset = i % 2 == 0 ? rnd() % (text.size() + 1) : i * 100;
+        ASSERT_EQ(index.GetLineColumn(offset), GetLineColumnNaive(text, offset)) << "offset " << offset;
+    }
+}
+
+TEST(LineIndexTest, ExtendText)
+{
+    std::string text = "a\nb";
+    LineIndex index(text);
+    ASSERT_EQ(index.GetLineColumn(3), (LineColumn{.line = 2, .column = 2}));
+
+    text += "c\nd";
+    index.ExtendText(text);
+    ASSERT_EQ(index.GetLineColumn(5), (LineColumn{.line = 3, .column = 1}));
+    ASSERT_EQ(index.GetLineColumn(4), (LineColumn{.line = 2, .column = 3}));
+}
+
+TEST(LineIndexTest, AppendChunk)
+{
+    std::mt19937 rnd(7);  // NOLINT
+    std::string text(10'000, 'a');
+    for (char& c : text)
+    {
+        if (rnd() % 10 == 0) c = '\n';
+    }
+
+    // Chunks of different sizes, each one is gone once it is appended
+    LineIndex index;
+    for (size_t begin = 0; begin != text.size();)
+    {
+        std::string chunk(std::string_view(text).substr(begin, rnd() % 100));
+        index.AppendChunk(chunk);
+        begin += chunk.size();
+        std::ranges::fill(chunk, '\n');
+
+        const size_t offset = rnd() % (begin + 1);
+        ASSERT_EQ(index.GetLineColumn(offset), GetLineColumnNaive(text, offset)) << "offset " << offset;
+    }
+
+    ASSERT_EQ(index.GetSize(), text.size());
+    ASSERT_EQ(index.GetLineColumn(text.size()), GetLineColumnNaive(text, text.size()));
+}
+
+TEST(SourceIndexTest, MultipleFiles)
+{
+    SourceIndex sources;
+    const SourceFileId a = sources.AddFile("a.ks", "x\ny");
+    const SourceFileId b = sources.AddFile("b.ks", "");
+    const SourceFileId c = sources.AddFile("c.ks", "\n\nz");
+
+    const SourceLocation a_end = sources.GetLocation(a, 3);
+    const SourceLocation b_end = sources.GetLocation(b, 0);
+    const SourceLocation c_z = sources.GetLocation(c, 2);
+    ASSERT_LT(a_end, b_end);
+    ASSERT_LT(b_end, c_z);
+
+    ASSERT_EQ(sources.GetFileId(a_end), a);
+    ASSERT_EQ(sources.GetFileId(b_end), b);
+    ASSERT_EQ(sources.GetFileId(c_z), c);
+    ASSERT_EQ(sources.GetOffset(c_z), 2uz);
+
+    const PresumedLocation a_location = sources.GetPresumedLocation(a_end);
+    ASSERT_EQ(a_location.file_name, "a.ks");
+    ASSERT_EQ(a_location.line_column, (LineColumn{.line = 2, .column = 2}));
+
+    const PresumedLocation c_location = sources.GetPresumedLocation(c_z);
+    ASSERT_EQ(c_location.file_name, "c.ks");
+    ASSERT_EQ(c_location.line_column, (LineColumn{.line = 3, .column = 1}));
+}
@@ -0,0 +1,162 @@
+#include <random>
+
+#include "kaleidoscope/lexer/streaming_lexer.hpp"
+#include "util.hpp"
+
+namespace
+{
+
+inline constexpr std::string_view kStreamingSource = R"(
+    def extern foo_bar_baz 42 0x1F 0b101 017 1.5e+3 .5 "str \" ing" // line comment
+    /* block
+       comment */ 0x 001A .e3 ☺ a + b - c * d / e 0.. 1e
+    "unterminated
+    x/**/y//z
+    /* unterminated block)";
+
+template <typename Traits = CompactLexerTraits>
+[[nodiscard]] std::vector<ExpectedResult> LexWhole(std::string_view src)
+{
+    std::vector<ExpectedResult> results;
+    BasicLexer<Traits> lexer(src);
+    while (true)
+    {
+        const auto r = lexer.GetToken();
+        results.push_back(ToExpectedResult(src, r));
+        if (r.has_value() && r->GetType() == kEOF) break;
+    }
+
+    return results;
+}
+
+// Feeds the source by chunks of the specified sizes and collects all results.
+// Reports the number of bytes the lexer examined to scanned_size.
+template <typename Traits = CompactLexerTraits>
+[[nodiscard]] std::vector<ExpectedResult> LexByChunks(
+    std::string_view src,
+    auto&& next_chunk_size,
+    size_t* scanned_size = nullptr)
+{
+    std::vector<ExpectedResult> results;
+    BasicStreamingLexer<Traits> lexer;
+
+    auto drain = [&]
+    {
+        while (auto r = lexer.GetToken())
+        {
+            // Offsets are absolute, so results can be compared against the whole source
+            results.push_back(ToExpectedResult(src, *r));
+            if (r->has_value())
+            {
+                EXPECT_EQ(lexer.GetTokenView(r->value()), results.back()->token);
+                if (r->value().GetType() == kEOF) return;
+            }
+        }
+    };
+
+    for (size_t pos = 0; pos < src.size();)
+    {
+        const size_t size = std::min(next_chunk_size(), src.size() - pos);
+        lexer.Feed(src.substr(pos, size));
+        pos += size;
+        drain();
+    }
+
+    lexer.Finish();
+    drain();
+
+    if (scanned_size != nullptr) *scanned_size = lexer.GetScannedSize();
+    return results;
+}
+
+}  // namespace
+
+TEST(StreamingLexerTest, SingleChunk)
+{
+    ASSERT_EQ(LexByChunks(kStreamingSource, [] { return kStreamingSource.size(); }), LexWhole(kStreamingSource));
+}
+
+TEST(StreamingLexerTest, ByteByByte)
+{
+    ASSERT_EQ(LexByChunks(kStreamingSource, [] { return 1uz; }), LexWhole(kStreamingSource));
+}
+
+TEST(StreamingLexerTest, RandomChunks)
+{
+    std::mt19937 rng(42);  // NOLINT
+    for (size_t iteration = 0; iteration != 200; ++iteration)
+    {
+        const size_t max_chunk = 1 + iteration % 16;
+        ASSERT_EQ(
+            LexByChunks(kStreamingSource, [&] { return 1 + rng() % max_chunk; }),
+            LexWhole(kStreamingSource));
+    }
+}
+
+TEST(StreamingLexerTest, RandomSources)
+{
+    // Characters that start, continue or end tokens in many different ways
+    constexpr std::string_view kAlphabet = "a_Z09.eE+-*/()\"\\ \n\tx0b17#";
+
+    std::mt19937 rng(42);  // NOLINT
+    for (size_t iteration = 0; iteration != 2000; ++iteration)
+    {
+        std::string src(rng() % 40, ' ');
+        for (char& c : src) c = kAlphabet[rng() % kAlphabet.size()];
+
+        const size_t max_chunk = 1 + iteration % 5;
+        ASSERT_EQ(LexByChunks(src, [&] { return 1 + rng() % max_chunk; }), LexWhole(src)) << src;
+    }
+}
+
+TEST(StreamingLexerTest, WithoutTrivia)
+{
+    using Traits = WithTrivia<CompactLexerTraits, false>;
+    std::mt19937 rng(42);  // NOLINT
+    for (size_t iteration = 0; iteration != 50; ++iteration)
+    {
+        const size_t max_chunk = 1 + iteration % 8;
+        ASSERT_EQ(
+            LexByChunks<Traits>(kStreamingSource, [&] { return 1 + rng() % max_chunk; }),
+            LexWhole<Traits>(kStreamingSource));
+    }
+}
+
+TEST(StreamingLexerTest, LongTokensAreScannedOnce)
+{
+    constexpr size_t kLength = 100'000;
+
+    std::string src = "// " + std::string(kLength, 'c') + "\n";
+    src += '"';
+    for (size_t i = 0; i != kLength / 4; ++i) src += "s\\\"\\t";
+    src += "\" /*";
+    for (size_t i = 0; i != kLength / 4; ++i) src += "b**/"[i % 3];
+    src += "*/ " + std::string(kLength, 'i') + " " + std::string(kLength, '7') + " end";
+
+    size_t scanned_size = 0;
+    const auto results = LexByChunks(src, [] { return 1uz; }, &scanned_size);
+    ASSERT_EQ(results, LexWhole(src));
+    ASSERT_EQ(results.size(), 7uz);
+
+    // Rescanning the unfinished token after every byte would examine about kLength^2 / 2 bytes per token
+    ASSERT_LE(scanned_size, src.size());
+}
+
+TEST(StreamingLexerTest, BoundedBuffer)
+{
+    StreamingLexer lexer;
+    for (size_t i = 0; i != 1000; ++i)
+    {
+        lexer.Feed("abc + 12345 ");
+        while (auto r = lexer.GetToken())
+        {
+            ASSERT_TRUE(r->has_value());
+        }
+        ASSERT_LE(lexer.GetBufferedSize(), 12uz);
+    }
+
+    lexer.Finish();
+    auto r = lexer.GetToken();
+    ASSERT_TRUE(r.has_value() && r->has_value());
+    ASSERT_EQ(r->value(), EofToken(12'000));
+}
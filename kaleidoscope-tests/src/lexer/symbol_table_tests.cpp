@@ -0,0 +1,117 @@
+#include <thread>
+
+#include "kaleidoscope/lexer/symbol_table.hpp"
+#include "util.hpp"
+
+namespace
+{
+
+template <typename SymbolTableType>
+using InterningLexer = BasicLexer<WithSymbolTable<CompactLexerTraits, SymbolTableType>>;
+
+}  // namespace
+
+static_assert(HashIdentifier("abcdefgh") != HashIdentifier("abcdefgi"));
+static_assert(HashIdentifier("a") != HashIdentifier(std::string_view("a\0", 2)));
+
+TEST(SymbolTableTest, DenseIds)
+{
+    SymbolTable symbols;
+    ASSERT_EQ(symbols.Intern("foo"), 0u);
+    ASSERT_EQ(symbols.Intern("bar"), 1u);
+    ASSERT_EQ(symbols.Intern("foo"), 0u);
+    ASSERT_EQ(symbols.Intern(""), 2u);
+    ASSERT_EQ(symbols.GetName(1), "bar");
+    ASSERT_EQ(symbols.Size(), 3uz);
+}
+
+TEST(SymbolTableTest, ManySymbols)
+{
+    // Forces several rehashes and arena blocks, including names longer than a quarter of a block
+    SymbolTable symbols;
+    std::vector<std::string> names;
+    for (size_t i = 0; i != 50'000; ++i) names.push_back("name_" + std::to_string(i));
+    names.push_back(std::string(40'000, 'x'));
+
+    for (size_t i = 0; i != names.size(); ++i) ASSERT_EQ(symbols.Intern(names[i]), i);
+    for (size_t i = 0; i != names.size(); ++i)
+    {
+        ASSERT_EQ(symbols.Intern(names[i]), i);
+        ASSERT_EQ(symbols.GetName(static_cast<SymbolId>(i)), names[i]);
+    }
+}
+
+TEST(SymbolTableTest, Lexer)
+{
+    constexpr std::string_view src = "def foo bar extern foo";
+    SymbolTable symbols;
+    InterningLexer<SymbolTable> lexer(src, symbols);
+
+    ASSERT_EQ(lexer.GetToken()->GetType(), TokenType::Def);
+    ASSERT_EQ(lexer.GetToken()->GetType(), kIdentifier);
+    ASSERT_EQ(lexer.GetSymbolId(), 0u);
+    ASSERT_EQ(lexer.GetToken()->GetType(), kIdentifier);
+    ASSERT_EQ(lexer.GetSymbolId(), 1u);
+    ASSERT_EQ(lexer.GetToken()->GetType(), TokenType::Extern);
+    ASSERT_EQ(lexer.GetToken()->GetType(), kIdentifier);
+    ASSERT_EQ(lexer.GetSymbolId(), 0u);
+
+    // Keywords are not interned
+    ASSERT_EQ(symbols.Size(), 2uz);
+}
+
+TEST(SymbolTableTest, LookaheadLexer)
+{
+    constexpr std::string_view src = "a b a";
+    SymbolTable symbols;
+    InterningLexer<SymbolTable> lexer(src, symbols);
+    LookaheadLexer<3, InterningLexer<SymbolTable>> lookahead(lexer);
+
+    ASSERT_EQ(lookahead.PeekSymbolId(0), 0u);
+    ASSERT_EQ(lookahead.PeekSymbolId(1), 1u);
+    ASSERT_EQ(lookahead.PeekSymbolId(2), 0u);
+}
+
+TEST(ConcurrentSymbolTableTest, ManyThreads)
+{
+    constexpr size_t kThreadCount = 4;
+    constexpr size_t kNameCount = 20'000;
+
+    std::vector<std::string> sources(kThreadCount);
+    for (size_t t = 0; t != kThreadCount; ++t)
+    {
+        // Every thread sees all names, in different orders
+        for (size_t i = 0; i != kNameCount; ++i)
+        {
+            sources[t] += "n" + std::to_string((i * (t + 1) * 7919) % kNameCount) + " ";
+        }
+    }
+
+    ConcurrentSymbolTable symbols;
+    std::vector<std::vector<std::pair<std::string_view, SymbolId>>> results(kThreadCount);
+    {
+        std::vector<std::jthread> threads;
+        for (size_t t = 0; t != kThreadCount; ++t)
+        {
+            threads.emplace_back(
+                [&, t]
+                {
+                    InterningLexer<ConcurrentSymbolTable> lexer(sources[t], symbols);
+                    for (auto r = lexer.GetToken(); r->GetType() != kEOF; r = lexer.GetToken())
+                    {
+                        results[t].emplace_back(lexer.GetTokenView(*r), lexer.GetSymbolId());
+                    }
+                });
+        }
+    }
+
+    ASSERT_EQ(symbols.Size(), kNameCount);
+    for (const auto& thread_results : results)
+    {
+        for (const auto& [name, id] : thread_results)
+        {
+            ASSERT_LT(id, kNameCount);
+            ASSERT_EQ(symbols.GetName(id), name);
+        }
+    }
+}
@@ -0,0 +1,228 @@
+#include <algorithm>
+#include <random>
+
+#include "kaleidoscope/lexer/token_buffer.hpp"
+#include "util.hpp"
+
+namespace
+{
+
+// Merges tokens and errors back into the order in which Lexer::GetToken produces them
+[[nodiscard]] std::vector<LexerResult> Interleave(const TokenBuffer& buffer)
+{
+    std::vector<LexerResult> results;
+    auto errors = buffer.GetErrors();
+    auto error_it = errors.begin();
+
+    for (size_t index = 0; index != buffer.Size(); ++index)
+    {
+        for (; error_it != errors.end() && error_it->token_index == index; ++error_it)
+        {
+            results.emplace_back(std::unexpected(error_it->error));
+        }
+
+        results.emplace_back(buffer.GetToken(index));
+    }
+
+    return results;
+}
+
+[[nodiscard]] std::vector<LexerResult> LexAll(std::string_view src)
+{
+    std::vector<LexerResult> results;
+    Lexer lexer(src);
+    while (true)
+    {
+        results.push_back(lexer.GetToken());
+        if (results.back().has_value() && results.back()->GetType() == TokenType::EndOfFile) break;
+    }
+
+    return results;
+}
+
+}  // namespace
+
+static_assert(
+    []
+    {
+        const TokenBuffer buffer("def f 1 + 2");
+        return buffer.Size() == 6 && buffer.GetType(0) == TokenType::Def && buffer.GetTokenView(1) == "f" &&
+               buffer.GetType(5) == TokenType::EndOfFile;
+    }());
+
+TEST(TokenBufferTest, MatchesLexer)
+{
+    constexpr std::string_view src = R"(
+        def extern foo_bar 42 0x1F 0b101 017 1.5e3 "str" // comment
+        /* block */ 0x 001A .e3 ☺ a + b - c * d / e "unterminated
+        /* unterminated block)";
+
+    const TokenBuffer buffer(src);
+    ASSERT_EQ(buffer.GetText(), src);
+    ASSERT_FALSE(buffer.GetErrors().empty());
+    ASSERT_EQ(buffer.GetType(buffer.Size() - 1), kEOF);
+    ASSERT_EQ(Interleave(buffer), LexAll(src));
+
+    for (size_t index = 0; index != buffer.Size(); ++index)
+    {
+        const LexerToken token = buffer.GetToken(index);
+        ASSERT_EQ(buffer.GetTokenView(index), src.substr(token.GetBegin(), token.GetLength()));
+    }
+}
+
+TEST(TokenBufferTest, Reuse)
+{
+    TokenBuffer buffer("☺ 1 2 3");
+    ASSERT_EQ(buffer.Size(), 4uz);
+    ASSERT_EQ(buffer.GetErrors().size(), 1uz);
+    ASSERT_EQ(buffer.GetErrors().front().token_index, 0u);
+
+    buffer.Tokenize("x");
+    ASSERT_EQ(buffer.Size(), 2uz);
+    ASSERT_TRUE(buffer.GetErrors().empty());
+    ASSERT_EQ(buffer.GetType(0), kIdentifier);
+    ASSERT_EQ(buffer.GetTokenView(0), "x");
+
+    buffer.Tokenize("");
+    ASSERT_EQ(buffer.Size(), 1uz);
+    ASSERT_EQ(buffer.GetToken(0), EofToken(0));
+}
+
+namespace
+{
+
+// Long comments and string literals make chunk boundaries land inside them
+[[nodiscard]] std::string MakeMixedSource(size_t size, uint32_t seed)
+{
+    constexpr std::array<std::string_view, 12> fragments{
+        "def ",
+        "extern ",
+        "foo_bar ",
+        "42 ",
+        "0x1F ",
+        "1.5e3 ",
+        "+ - * / ",
+        "\"string \\\" literal with // and /* inside\" ",
+        "// line comment with \"quotes\" and /*\n",
+        "/* block comment\n spanning lines with \"quotes\" // */ ",
+        "☺ ",
+        "\n    ",
+    };
+
+    std::mt19937 rng(seed);  // NOLINT
+    std::string source;
+    while (source.size() < size)
+    {
+        source += fragments[rng() % fragments.size()];
+
+        // Sometimes stretch the last fragment to have tokens and comments longer than usual
+        if (rng() % 64 == 0) source.append(rng() % 256, 'x');
+    }
+
+    return source;
+}
+
+}  // namespace
+
+TEST(TokenBufferTest, ParallelMatchesSequential)
+{
+    for (const uint32_t seed : {1u, 2u, 3u})
+    {
+        const std::string src = MakeMixedSource(size_t{1} << 20, seed);
+        const TokenBuffer expected(src);
+
+        TokenBuffer buffer;
+        for (const size_t thread_count : {1uz, 2uz, 3uz, 7uz, 16uz})
+        {
+            buffer.TokenizeParallel(src, thread_count);
+            ASSERT_EQ(buffer.GetTypes().size(), expected.GetTypes().size());
+            ASSERT_TRUE(std::ranges::equal(buffer.GetTypes(), expected.GetTypes()));
+            ASSERT_TRUE(std::ranges::equal(buffer.GetBegins(), expected.GetBegins()));
+            ASSERT_TRUE(std::ranges::equal(buffer.GetLengths(), expected.GetLengths()));
+            ASSERT_TRUE(std::ranges::equal(buffer.GetErrors(), expected.GetErrors()));
+        }
+    }
+}
+
+TEST(TokenBufferTest, ParallelUnterminatedBlockComment)
+{
+    // One comment spans all chunks, so every speculative chunk is thrown away
+    std::string src = "a /*";
+    src.append(size_t{1} << 19, '*');
+
+    const TokenBuffer expected(src);
+    TokenBuffer buffer;
+    buffer.TokenizeParallel(src, 4);
+    ASSERT_TRUE(std::ranges::equal(buffer.GetTypes(), expected.GetTypes()));
+    ASSERT_TRUE(std::ranges::equal(buffer.GetErrors(), expected.GetErrors()));
+}
+
+namespace
+{
+
+void ExpectSameTokens(const TokenBuffer& actual, const TokenBuffer& expected)
+{
+    ASSERT_EQ(actual.GetText(), expected.GetText());
+    ASSERT_TRUE(std::ranges::equal(actual.GetTypes(), expected.GetTypes()));
+    ASSERT_TRUE(std::ranges::equal(actual.GetBegins(), expected.GetBegins()));
+    ASSERT_TRUE(std::ranges::equal(actual.GetLengths(), expected.GetLengths()));
+    ASSERT_TRUE(std::ranges::equal(actual.GetErrors(), expected.GetErrors()));
+}
+
+}  // namespace
+
+TEST(TokenBufferTest, ApplyEdit)
+{
+    // Every edit is applied to the original source
+    struct Edit
+    {
+        size_t offset;
+        size_t removed_length;
+        std::string_view inserted;
+    };
+
+    constexpr std::string_view src = "def foo 12 + bar // c\nx";
+    constexpr std::array edits{
+        Edit{5, 0, "x"},          // extends an identifier
+        Edit{7, 1, ""},           // joins two tokens
+        Edit{8, 0, "/*"},         // comments out the rest of the text
+        Edit{8, 0, "\""},         // starts an unterminated string
+        Edit{19, 3, ""},          // removes the line break after the comment
+        Edit{0, src.size(), ""},  // removes everything
+        Edit{src.size(), 0, " 0x"},
+        Edit{3, 0, "☺"},
+    };
+
+    for (const Edit& edit : edits)
+    {
+        std::string new_text{src};
+        new_text.replace(edit.offset, edit.removed_length, edit.inserted);
+
+        TokenBuffer buffer(src);
+        buffer.ApplyEdit(new_text, {edit.offset, edit.removed_length, edit.inserted.size()});
+        ExpectSameTokens(buffer, TokenBuffer(new_text));
+    }
+}
+
+TEST(TokenBufferTest, ApplyRandomEdits)
+{
+    constexpr std::array<std::string_view, 10> insertions{"", "a", " ", "\n", "\"", "/*", "*/", "//", "1.", "☺"};
+
+    std::mt19937 rng(42);  // NOLINT
+    std::string text = MakeMixedSource(4096, 4);
+    TokenBuffer buffer(text);
+
+    // Every edit is applied to the result of the previous one
+    for (size_t iteration = 0; iteration != 2000; ++iteration)
+    {
+        const size_t offset = rng() % (text.size() + 1);
+        const size_t removed_length = std::min<size_t>(rng() % 8, text.size() - offset);
+        const std::string_view inserted = insertions[rng() % insertions.size()];
+
+        // ApplyEdit reads only the size of the old text, so it can be edited in place
+        text.replace(offset, removed_length, inserted);
+        buffer.ApplyEdit(text, {offset, removed_length, inserted.size()});
+
+        ExpectSameTokens(buffer, TokenBuffer(text));
+    }
+}
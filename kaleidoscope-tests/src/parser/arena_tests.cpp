@@ -0,0 +1,142 @@
+#include <memory_resource>
+#include <string>
+
+#include "kaleidoscope/lexer/block_lookahead_lexer.hpp"
+#include "kaleidoscope/parser/parser_context.hpp"
+#include "util.hpp"
+
+namespace
+{
+
+// Forwards to the default resource and counts allocations
+class CountingResource final : public std::pmr::memory_resource
+{
+public:
+    size_t allocations = 0;
+    size_t deallocations = 0;
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override
+    {
+        ++allocations;
+        return std::pmr::get_default_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override
+    {
+        ++deallocations;
+        std::pmr::get_default_resource()->deallocate(p, bytes, alignment);
+    }
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+[[nodiscard]] bool IsAligned(const void* p, size_t alignment)
+{
+    return std::bit_cast<uintptr_t>(p) % alignment == 0;
+}
+
+}  // namespace
+
+TEST(ArenaTest, Alignment)
+{
+    Arena arena;
+    auto* a = static_cast<char*>(arena.allocate(1, 1));
+    void* b = arena.allocate(8, 8);
+    void* c = arena.allocate(3, 1);
+    void* d = arena.allocate(64, 64);
+    void* e = arena.allocate(size_t{1} << 20, 256);
+
+    ASSERT_TRUE(IsAligned(b, 8));
+    ASSERT_TRUE(IsAligned(d, 64));
+    ASSERT_TRUE(IsAligned(e, 256));
+    ASSERT_EQ(static_cast<char*>(b) - a, 8);
+    ASSERT_EQ(static_cast<char*>(c) - a, 16);
+    ASSERT_GE(arena.GetUsedSize(), (size_t{1} << 20) + 64 + 19);
+    ASSERT_GE(arena.GetCapacity(), arena.GetUsedSize());
+}
+
+TEST(ArenaTest, ResetReusesMemory)
+{
+    CountingResource upstream;
+    Arena arena(0, &upstream);
+
+    auto compile = [&]
+    {
+        std::pmr::vector<uint64_t> v(&arena);
+        for (uint64_t i = 0; i != 100'000; ++i) v.push_back(i);
+        std::pmr::string s(1000, 'x', &arena);
+        ASSERT_EQ(v[99'999], 99'999);
+    };
+
+    compile();
+    ASSERT_GT(upstream.allocations, 1);
+
+    // Blocks of the first round are merged into one
+    arena.Reset();
+    ASSERT_EQ(arena.GetUsedSize(), 0);
+    const size_t allocations = upstream.allocations;
+    for (size_t i = 0; i != 10; ++i)
+    {
+        compile();
+        arena.Reset();
+    }
+
+    ASSERT_EQ(upstream.allocations, allocations);
+}
+
+TEST(ArenaTest, InitialCapacity)
+{
+    CountingResource upstream;
+    {
+        Arena arena(size_t{1} << 16, &upstream);
+        ASSERT_EQ(upstream.allocations, 1);
+        ASSERT_EQ(arena.GetCapacity(), size_t{1} << 16);
+
+        for (size_t i = 0; i != 1000; ++i) std::ignore = arena.allocate(32, 8);
+        ASSERT_EQ(upstream.allocations, 1);
+        ASSERT_EQ(arena.GetUsedSize(), 32'000);
+    }
+
+    ASSERT_EQ(upstream.deallocations, upstream.allocations);
+}
+
+TEST(ParserContextTest, SteadyStateMakesNoAllocations)
+{
+    CountingResource upstream;
+    ParserContext context(0, &upstream);
+
+    std::string source = "1";
+    for (size_t i = 0; i != 1000; ++i) source += i % 3 == 0 ? " * (2 + 3)" : " - 4 / 5";
+
+    size_t allocations = 0;
+    for (size_t i = 0; i != 5; ++i)
+    {
+        Parser& parser = context.StartCompilation();
+        Lexer l(source);
+        LookaheadLexer<2> lexer(l);
+        auto r = parser.ParseExpression(lexer);
+        ASSERT_TRUE(r.has_value());
+        ASSERT_EQ(parser.GetExprs().GetNodes<BinaryOperatorExpression>().size(), 2000);
+
+        // Token buffers and codegen scratch come from the same arena
+        Lexer block_l(source);
+        BlockLookaheadLexer<2> block_lexer(block_l, context.GetResource());
+        while (block_lexer.Take()->GetType() != TokenType::EndOfFile)
+        {
+        }
+
+        std::pmr::string ir(context.GetResource());
+        for (const auto& literal : parser.GetExprs().GetNodes<IntegralLiteralExprAST>())
+        {
+            ir += std::to_string(literal.value);
+        }
+
+        if (i == 1) allocations = upstream.allocations;
+    }
+
+    ASSERT_EQ(upstream.allocations, allocations);
+}
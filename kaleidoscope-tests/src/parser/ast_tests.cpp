@@ -0,0 +1,96 @@
+#include <cstring>
+
+#include "kaleidoscope/parser/parser.hpp"
+#include "util.hpp"
+
+static_assert(kTypeListIndex<BinaryOperatorExpression, ExprNodeTypes> == 1);
+static_assert(kExprType<BinaryOperatorExpression> == ExprType::BinaryOperator);
+static_assert(std::is_same_v<ExprAstStorage::NodeType<ExprType::IntegralLiteral>, IntegralLiteralExprAST>);
+static_assert(std::is_trivially_copyable_v<IntegralLiteralExprAST>);
+static_assert(sizeof(IntegralLiteralExprAST) == 16);
+static_assert(sizeof(BinaryOperatorExpression) == 20);
+
+namespace
+{
+
+// Evaluates the expression, with division rounding towards zero
+class Evaluator
+{
+public:
+    [[nodiscard]] int64_t operator()(const IntegralLiteralExprAST& literal) const
+    {
+        return static_cast<int64_t>(literal.value);
+    }
+
+    [[nodiscard]] int64_t operator()(const BinaryOperatorExpression& expr) const
+    {
+        const int64_t left = exprs.Visit(expr.left, *this);
+        const int64_t right = exprs.Visit(expr.right, *this);
+        switch (expr.type)
+        {
+        case BinaryOperatorType::Plus:
+            return left + right;
+        case BinaryOperatorType::Minus:
+            return left - right;
+        case BinaryOperatorType::Multiply:
+            return left * right;
+        case BinaryOperatorType::Divide:
+            return left / right;
+        }
+
+        return 0;
+    }
+
+    const ExprAstStorage& exprs;  // NOLINT
+};
+
+}  // namespace
+
+TEST(ExprStorageTest, AddGetVisit)
+{
+    ExprAstStorage exprs;
+    const ExprId a = exprs.Add(IntegralLiteralExprAST{.value = 6});
+    const ExprId b = exprs.Add(IntegralLiteralExprAST{.value = 7});
+    const ExprId mul = exprs.Add(BinaryOperatorExpression{.left = a, .right = b, .type = BinaryOperatorType::Multiply});
+
+    ASSERT_EQ(a.type, ExprType::IntegralLiteral);
+    ASSERT_EQ(b.index, 1);
+    ASSERT_EQ(mul.type, ExprType::BinaryOperator);
+    ASSERT_EQ(mul.index, 0);
+    ASSERT_EQ(exprs.Size(), 3);
+    ASSERT_EQ(exprs.Get<ExprType::IntegralLiteral>(1)->value, 7);
+    ASSERT_EQ(exprs.Get<ExprType::BinaryOperator>(1), nullptr);
+    ASSERT_EQ(exprs.Visit(mul, Evaluator{exprs}), 42);
+
+    exprs.Clear();
+    ASSERT_EQ(exprs.Size(), 0);
+}
+
+TEST(ExprStorageTest, MemcpyClone)
+{
+    Lexer l("(1 + 2) * 3 - 8 / 4");
+    LookaheadLexer<2> lexer(l);
+    Parser parser;
+    const auto r = parser.ParseExpression(lexer);
+    ASSERT_TRUE(r.has_value());
+
+    // Nodes refer to each other by ExprId, so copying the arrays bytewise gives the same tree
+    const ExprAstStorage& original = parser.GetExprs();
+    ExprAstStorage clone;
+    for (const auto& node : original.GetNodes<IntegralLiteralExprAST>())
+    {
+        IntegralLiteralExprAST copy;
+        std::memcpy(&copy, &node, sizeof(copy));
+        std::ignore = clone.Add(copy);
+    }
+
+    for (const auto& node : original.GetNodes<BinaryOperatorExpression>())
+    {
+        BinaryOperatorExpression copy;  // NOLINT
+        std::memcpy(&copy, &node, sizeof(copy));
+        std::ignore = clone.Add(copy);
+    }
+
+    ASSERT_EQ(original.Visit(*r, Evaluator{original}), 7);
+    ASSERT_EQ(clone.Visit(*r, Evaluator{clone}), 7);
+}
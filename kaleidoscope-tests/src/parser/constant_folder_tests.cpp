@@ -0,0 +1,133 @@
+#include <format>
+
+#include "kaleidoscope/parser/constant_folder.hpp"
+#include "kaleidoscope/parser/parser.hpp"
+#include "util.hpp"
+
+namespace
+{
+
+class FoldResult
+{
+public:
+    std::string expression;
+    std::vector<FoldingErrorType> errors;
+};
+
+[[nodiscard]] std::string Print(const ExprAstStorage& exprs, ExprId id)
+{
+    if (id.type == ExprType::IntegralLiteral)
+    {
+        return std::to_string(exprs.Get<ExprType::IntegralLiteral>(id.index)->GetSignedValue());
+    }
+
+    constexpr std::array<std::string_view, 4> kSymbols{"+", "-", "*", "/"};
+    const auto* expr = exprs.Get<ExprType::BinaryOperator>(id.index);
+    return std::format(
+        "({} {} {})",
+        Print(exprs, expr->left),
+        kSymbols[static_cast<size_t>(expr->type)],
+        Print(exprs, expr->right));
+}
+
+// Folds the expression and prints the result with all parentheses
+[[nodiscard]] FoldResult ParseAndFold(std::string_view src)
+{
+    Lexer l(src);
+    LookaheadLexer<2> lexer(l);
+
+    Parser parser(std::pmr::get_default_resource(), {.hash_consing = true});
+    const auto r = parser.ParseExpression(lexer);
+    if (!r.has_value()) return {.expression = "parsing error", .errors = {}};
+
+    ConstantFolder folder;
+    const ExprId folded = folder.Fold(parser.GetExprs(), *r);
+
+    FoldResult result;
+    for (const FoldingError& error : folder.GetErrors()) result.errors.push_back(error.type);
+
+    result.expression = Print(parser.GetExprs(), folded);
+    return result;
+}
+
+}  // namespace
+
+TEST(ConstantFolderTest, FoldsConstants)
+{
+    ASSERT_EQ(ParseAndFold("42 - 21").expression, "21");
+    ASSERT_EQ(ParseAndFold("1 - 2 * 3").expression, "-5");
+    ASSERT_EQ(ParseAndFold("(7 - 10) / 2").expression, "-1");
+    ASSERT_EQ(ParseAndFold("2147483647 - 2147483647 + 5").expression, "5");
+    ASSERT_TRUE(ParseAndFold("(1 + 2) * (3 + 4)").errors.empty());
+}
+
+TEST(ConstantFolderTest, ReportsErrors)
+{
+    const FoldResult overflow = ParseAndFold("2147483647 + 1");
+    ASSERT_EQ(overflow.expression, "(2147483647 + 1)");
+    ASSERT_EQ(overflow.errors, std::vector{FoldingErrorType::IntegerOverflow});
+
+    const FoldResult division = ParseAndFold("(1 + 1) / (2 - 2)");
+    ASSERT_EQ(division.expression, "(2 / 0)");
+    ASSERT_EQ(division.errors, std::vector{FoldingErrorType::DivisionByZero});
+
+    // Literals that don't fit into their type
+    ASSERT_EQ(ParseAndFold("4294967296 * 1").errors, std::vector{FoldingErrorType::IntegerOverflow});
+}
+
+TEST(ConstantFolderTest, Identities)
+{
+    // Division by zero keeps the left operand from folding
+    ASSERT_EQ(ParseAndFold("1 / 0 + 0").expression, "(1 / 0)");
+    ASSERT_EQ(ParseAndFold("0 + 1 / 0").expression, "(1 / 0)");
+    ASSERT_EQ(ParseAndFold("1 / 0 - (3 - 3)").expression, "(1 / 0)");
+    ASSERT_EQ(ParseAndFold("1 / 0 * (2 - 1)").expression, "(1 / 0)");
+    ASSERT_EQ(ParseAndFold("1 * (1 / 0)").expression, "(1 / 0)");
+    ASSERT_EQ(ParseAndFold("1 / 0 / 1").expression, "(1 / 0)");
+    ASSERT_EQ(ParseAndFold("(1 / 0) * 0").expression, "0");
+    ASSERT_EQ(ParseAndFold("0 * (1 / 0)").expression, "0");
+
+    // Hash-consing gives both operands the same ExprId
+    ASSERT_EQ(ParseAndFold("1 / 0 - 1 / 0").expression, "0");
+    ASSERT_EQ(ParseAndFold("(1 / 0 - 1 / 0) + 5").expression, "5");
+    ASSERT_EQ(ParseAndFold("1 / 0 - 2 / 0").expression, "((1 / 0) - (2 / 0))");
+}
+
+TEST(ConstantFolderTest, ReusedAfterClear)
+{
+    // The second storage has fewer expressions than the first one
+    constexpr std::array<std::pair<std::string_view, std::string_view>, 2> kCases{{
+        {"(1 + 2) * (3 + 4) - 1 / 0", "(21 - (1 / 0))"},
+        {"6 / 2", "3"},
+    }};
+
+    ConstantFolder folder;
+    for (const auto& [src, expected] : kCases)
+    {
+        Lexer l(src);
+        LookaheadLexer<2> lexer(l);
+        Parser parser;
+        const auto root = parser.ParseExpression(lexer);
+        ASSERT_TRUE(root.has_value());
+
+        folder.Clear();
+        ASSERT_EQ(Print(parser.GetExprs(), folder.Fold(parser.GetExprs(), *root)), expected);
+    }
+
+    ASSERT_TRUE(folder.GetErrors().empty());
+}
+
+TEST(ConstantFolderTest, DeepExpression)
+{
+    // No recursion: nodes are folded in the order of creation
+    constexpr size_t kTerms = 1'000'000;
+    std::string src = "1";
+    for (size_t i = 0; i != kTerms; ++i) src += i % 2 == 0 ? " + 2" : " - 1";
+
+    ASSERT_EQ(ParseAndFold(src).expression, std::to_string(1 + kTerms / 2 * 1));
+
+    std::string nested(kTerms, '(');
+    nested += "0";
+    for (size_t i = 0; i != kTerms; ++i) nested += " + 1)";
+    ASSERT_EQ(ParseAndFold(nested).expression, std::to_string(kTerms));
+}
@@ -1,167 +1,129 @@
-#include <bit>
-#include <cstdio>
 #include <format>
 
-#pragma clang diagnostic push
-#pragma clang diagnostic ignored "-Wfloat-equal"
-#include "fmt/compile.h"
-#pragma clang diagnostic pop
-#include "ir_expression_executor.hpp"
 #include "kaleidoscope/parser/parser.hpp"
 #include "util.hpp"
 
-namespace kaleidoscope
+TEST(ParserTests, TwoLeadingZeroes)
 {
+    Lexer l("1234");
+    LookaheadLexer<5> lexer(l);
 
-class Parser
+    Parser parser;
+    auto r = parser.ParseExpression(lexer);
+    ASSERT_TRUE(r.has_value());
+    ASSERT_EQ(r->type, ExprType::IntegralLiteral);
+
+    auto* ast = parser.GetExprAst<ExprType::IntegralLiteral>(r->index);
+    ASSERT_NE(ast, nullptr);
+    ASSERT_EQ(ast->type.bits, 32);
+    ASSERT_EQ(ast->value, 1234);
+}
+
+namespace
 {
-public:
-    template <size_t horizon_size>
-    [[nodiscard]] constexpr ExprASTResult ParseDecimalIntegralLiteral(LookaheadLexer<horizon_size>& l)
-    {
-        LexerResult ra = l.Take();
-        assert(ra.has_value());
-
-        const LexerToken& ta = *ra;
-        assert(ta.type == TokenType::DecimalLiteral);
-
-        const std::string_view text = l.GetTokenView(ta);
-
-        auto char_to_digit = [](char c) -> uint8_t
-        {
-            return std::bit_cast<uint8_t>(static_cast<int8_t>(c - '0'));
-        };
-
-        uint64_t value = 0;
-
-        if (text.size() != 0)
-        {
-            value += char_to_digit(text.front());
-            for (size_t i = 1; i != text.size(); ++i)
-            {
-                value = value * 10 + char_to_digit(text[i]);
-            }
-        }
-
-        uint32_t index = static_cast<uint32_t>(integral_literals_.size());
-        IntegralLiteralExprAST& expr = integral_literals_.emplace_back();
-        expr.value = value;
-        expr.type.bits = 32;
-        expr.type.type = BuiltinType::SignedInteger;
-
-        return ExprId{
-            .type = ExprType::IntegralLiteral,
-            .index = index,
-        };
-    }
 
-    template <size_t horizon_size>
-    [[nodiscard]] constexpr ExprASTResult ParseExpression(LookaheadLexer<horizon_size>& l)
+// Prints the expression with all parentheses, e.g. "((1 + 2) * 3)"
+class Printer
+{
+public:
+    [[nodiscard]] std::string operator()(const IntegralLiteralExprAST& literal) const
     {
-        assert(l.Peek().has_value());
-
-        auto first = [&]() -> ExprASTResult
-        {
-            switch (l.Peek()->type)
-            {
-            case TokenType::DecimalLiteral:
-                return ParseDecimalIntegralLiteral(l);
-
-            default:
-                return std::unexpected(ParserErrorType::UnexpectedToken);
-            }
-        }();
-
-        if (!first.has_value())
-        {
-            return first;
-        }
-
-        if (!l.Peek().has_value() || l.Peek()->type == TokenType::EndOfFile)
-        {
-            return first;
-        }
-
-        switch (l.Take()->type)
-        {
-        case TokenType::Plus:
-        {
-            auto second = ParseExpression(l);
-            if (!second.has_value()) return second;
-
-            const auto index = static_cast<uint32_t>(binary_operator_expression_.size());
-            auto& expr = binary_operator_expression_.emplace_back();
-            expr.left = *first;
-            expr.right = *second;
-            expr.type = BinaryOperatorType::Plus;
-            return ExprId{
-                .type = ExprType::BinaryOperator,
-                .index = index,
-            };
-        }
-        case TokenType::Minus:
-        {
-            auto second = ParseExpression(l);
-            if (!second.has_value()) return second;
-
-            const auto index = static_cast<uint32_t>(binary_operator_expression_.size());
-            auto& expr = binary_operator_expression_.emplace_back();
-            expr.left = *first;
-            expr.right = *second;
-            expr.type = BinaryOperatorType::Minus;
-            return ExprId{
-                .type = ExprType::BinaryOperator,
-                .index = index,
-            };
-        }
-        break;
-        default:
-            return std::unexpected(ParserErrorType::UnexpectedToken);
-        }
+        return std::to_string(literal.GetSignedValue());
     }
 
-    template <ExprType type>
-    [[nodiscard]] constexpr const auto* GetExprAst(uint32_t index) const
+    [[nodiscard]] std::string operator()(const BinaryOperatorExpression& expr) const
     {
-        auto get_from = [&](auto&& v)
-        {
-            return index < v.size() ? &v[index] : nullptr;
-        };
-
-        if constexpr (type == ExprType::IntegralLiteral)
-        {
-            return get_from(integral_literals_);
-        }
-        else if constexpr (type == ExprType::BinaryOperator)
-        {
-            return get_from(binary_operator_expression_);
-        }
-        else
-        {
-            assert(false);
-            return nullptr;
-        }
+        constexpr std::array<std::string_view, 4> kSymbols{"+", "-", "*", "/"};
+        return std::format(
+            "({} {} {})",
+            exprs.Visit(expr.left, *this),
+            kSymbols[static_cast<size_t>(expr.type)],
+            exprs.Visit(expr.right, *this));
     }
 
-    std::vector<IntegralLiteralExprAST> integral_literals_;
-    std::vector<BinaryOperatorExpression> binary_operator_expression_;
+    const ExprAstStorage& exprs;  // NOLINT
 };
-}  // namespace kaleidoscope
 
-TEST(ParserTests, TwoLeadingZeroes)
+[[nodiscard]] std::string Print(const Parser& parser, const ExprASTResult& r)
 {
-    Lexer l("1234");
-    LookaheadLexer<5> lexer(l);
+    if (!r.has_value()) return r.error() == ParserErrorType::UnexpectedToken ? "UnexpectedToken" : "error";
+    return parser.GetExprs().Visit(*r, Printer{parser.GetExprs()});
+}
+
+[[nodiscard]] std::string ParseAndPrint(std::string_view src)
+{
+    Lexer l(src);
+    LookaheadLexer<2> lexer(l);
 
     Parser parser;
-    auto r = parser.ParseExpression(lexer);
-    ASSERT_TRUE(r.has_value());
-    ASSERT_EQ(r->type, ExprType::IntegralLiteral);
+    const auto r = parser.ParseExpression(lexer);
+    return Print(parser, r);
+}
 
-    auto* ast = parser.GetExprAst<ExprType::IntegralLiteral>(r->index);
-    ASSERT_NE(ast, nullptr);
-    ASSERT_EQ(ast->type.bits, 32);
-    ASSERT_EQ(ast->value, 1234);
+}  // namespace
+
+TEST(ParserTests, Precedence)
+{
+    ASSERT_EQ(ParseAndPrint("1 + 2 * 3"), "(1 + (2 * 3))");
+    ASSERT_EQ(ParseAndPrint("1 * 2 + 3"), "((1 * 2) + 3)");
+    ASSERT_EQ(ParseAndPrint("1 - 2 - 3"), "((1 - 2) - 3)");
+    ASSERT_EQ(ParseAndPrint("8 / 4 / 2 * 3"), "(((8 / 4) / 2) * 3)");
+    ASSERT_EQ(ParseAndPrint("1 + 2 * 3 - 4 / 5"), "((1 + (2 * 3)) - (4 / 5))");
+}
+
+TEST(ParserTests, Parentheses)
+{
+    ASSERT_EQ(ParseAndPrint("(1 + 2) * 3"), "((1 + 2) * 3)");
+    ASSERT_EQ(ParseAndPrint("1 - (2 - 3)"), "(1 - (2 - 3))");
+    ASSERT_EQ(ParseAndPrint("((1))"), "1");
+    ASSERT_EQ(ParseAndPrint("2 * (3 + (4 - 1) * 5)"), "(2 * (3 + ((4 - 1) * 5)))");
+}
+
+TEST(ParserTests, Errors)
+{
+    ASSERT_EQ(ParseAndPrint("(1 + 2"), "UnexpectedToken");
+    ASSERT_EQ(ParseAndPrint("1 +"), "UnexpectedToken");
+    ASSERT_EQ(ParseAndPrint("* 1"), "UnexpectedToken");
+    ASSERT_EQ(ParseAndPrint("()"), "UnexpectedToken");
+}
+
+TEST(ParserTests, StopsAtEndOfExpression)
+{
+    Lexer l("1 + 2) 3");
+    LookaheadLexer<2> lexer(l);
+
+    Parser parser;
+    ASSERT_TRUE(parser.ParseExpression(lexer).has_value());
+    ASSERT_EQ(lexer.Peek()->GetType(), TokenType::CloseParen);
+}
+
+TEST(ParserTests, DeepExpressions)
+{
+    // Would overflow the native stack with one recursive call per operator or parenthesis
+    constexpr size_t kTerms = 1'000'000;
+
+    std::string flat = "1";
+    for (size_t i = 1; i != kTerms; ++i) flat += i % 2 == 0 ? " + 1" : " * 1";
+
+    std::string nested(kTerms, '(');
+    nested += "1";
+    for (size_t i = 0; i != kTerms; ++i) nested += " + 1)";
+
+    for (const std::string& src : {flat, nested})
+    {
+        Lexer l(src);
+        LookaheadLexer<2> lexer(l);
+
+        Parser parser;
+        const auto r = parser.ParseExpression(lexer);
+        ASSERT_TRUE(r.has_value());
+        ASSERT_EQ(r->type, ExprType::BinaryOperator);
+        ASSERT_EQ(lexer.Peek()->GetType(), TokenType::EndOfFile);
+        const ExprAstStorage& exprs = parser.GetExprs();
+        ASSERT_EQ(
+            exprs.GetNodes<IntegralLiteralExprAST>().size(),
+            exprs.GetNodes<BinaryOperatorExpression>().size() + 1);
+    }
 }
 
 TEST(ParserTests, Plus)
@@ -191,165 +153,67 @@ TEST(ParserTests, Plus)
     ASSERT_EQ(right_ast->value, 2);
 }
 
-struct FixedBufferOutIt
-{
-    explicit constexpr FixedBufferOutIt(std::span<char> buffer)
-        : size{buffer.size()},
-          out{buffer.data()},
-          end{out + buffer.size()}  // NOLINT
-    {
-    }
-
-    constexpr FixedBufferOutIt& operator=(char c)
-    {
-        if (out != end)
-        {
-            *out = c;
-            std::advance(out, 1);
-        }
-
-        size += 1;
-
-        return *this;
-    }
-
-    constexpr FixedBufferOutIt& operator*() { return *this; }
-    constexpr FixedBufferOutIt& operator++() { return *this; }
-    constexpr FixedBufferOutIt operator++(int) { return *this; }
-
-    size_t size = 0;
-    char *out, *end{};
-};
-
-class CodeGen_LLVM_IR
-{
-public:
-    constexpr explicit CodeGen_LLVM_IR(const Parser& parser, std::span<char> out, size_t first_variable_index = 0)
-        : out_{out.data()},
-          out_size_{std::ssize(out)},
-          next_var_{first_variable_index},
-          parser_{parser}
-    {
-    }
-
-    template <typename... FormatArgs>
-    constexpr void Write(fmt::format_string<FormatArgs...> format_string, FormatArgs&&... args)
-    {
-        const auto format_result =
-            fmt::format_to_n(out_, static_cast<size_t>(out_size_), format_string, std::forward<FormatArgs>(args)...);
-
-        out_size_ -= std::distance(out_, format_result.out);
-        out_ = format_result.out;
-        required_space_ += static_cast<size_t>(format_result.size);
-    }
-
-    // Returns variable index where result of expression will be stored
-    [[nodiscard]] constexpr size_t Gen(const IntegralLiteralExprAST& literal)
-    {
-        assert(literal.type.bits == 32 || literal.type.bits == 64);
-
-        const size_t var_ptr_id = next_var_++;
-        const size_t var_id = next_var_++;
-        const size_t align = literal.type.bits == 32 ? 4 : 8;
-
-        Write("%{} = alloca i{}, align {}\n", var_ptr_id, literal.type.bits, align);
-        Write("store i{} {}, ptr %{}, align {}\n", literal.type.bits, literal.value, var_ptr_id, align);
-        Write("%{} = load i{}, ptr %{}, align {}\n", var_id, literal.type.bits, var_ptr_id, align);
-
-        return var_id;
-    }
-
-    // Returns variable index where result of expression will be stored
-    [[nodiscard]] constexpr size_t Gen(const BinaryOperatorExpression& binary_operator)
-    {
-        assert(binary_operator.left.type == ExprType::IntegralLiteral);
-        assert(binary_operator.right.type == ExprType::IntegralLiteral);
-        const size_t left = Gen(*parser_.GetExprAst<ExprType::IntegralLiteral>(binary_operator.left.index));
-        const size_t right = Gen(*parser_.GetExprAst<ExprType::IntegralLiteral>(binary_operator.right.index));
-        const size_t var_id = next_var_++;
-
-        auto op = [&]() -> std::string_view
-        {
-            switch (binary_operator.type)
-            {
-            case BinaryOperatorType::Plus:
-                return "add";
-            case BinaryOperatorType::Minus:
-                return "sub";
-            default:
-                assert(false);
-                return "";
-            }
-        }();
-
-        Write("%{} = {} i{} %{}, %{}\n", var_id, op, 32, left, right);
-
-        return var_id;
-    }
-
-    char* out_;
-    ssize_t out_size_;
-    size_t next_var_ = 0;
-    size_t required_space_ = 0;
-    const Parser& parser_;  // NOLINT
-};
-
-[[nodiscard]] inline constexpr std::tuple<size_t, size_t> ExpressionToIR(
-    std::string_view expression,
-    std::span<char> ir)
+TEST(ParserTests, IntegerLiteralOverflow)
 {
-    Lexer l(expression);
+    Lexer l("18446744073709551616");
     LookaheadLexer<5> lexer(l);
 
     Parser parser;
-    auto parse_result = parser.ParseExpression(lexer);
-    auto* opt_ast = parser.GetExprAst<ExprType::BinaryOperator>(parse_result->index);
-    CodeGen_LLVM_IR g{parser, ir, 1};
-    size_t variable_index = g.Gen(*opt_ast);
-
-    return {g.required_space_, variable_index};
+    ASSERT_EQ(parser.ParseExpression(lexer), std::unexpected(ParserErrorType::IntegerLiteralOverflow));
 }
 
-static_assert(
-    []
+TEST(ParserTests, IntegerLiteralOverflowWithDecodingLexer)
+{
+    // Reported the same way as when the parser decodes the literal
+    for (const std::string_view src : {"18446744073709551616", "1 + 99999999999999999999"})
     {
-        std::array<char, 2048> buffer{};
-        constexpr auto f = FMT_COMPILE("{}");
-        fmt::format_to(FixedBufferOutIt{std::span{buffer}}, f, 123);
-        return true;
-    }());
+        DecodingLexer l(src);
+        LookaheadLexer<5, DecodingLexer> lexer(l);
 
-// static_assert(
-//     []
-//     {
-//         std::array<char, 2048> buffer{};
-
-//         return ExpressionToIR("42 - 21", buffer) == std::tuple<size_t, size_t>{192, 5};
-//     }());
+        Parser parser;
+        ASSERT_EQ(parser.ParseExpression(lexer), std::unexpected(ParserErrorType::IntegerLiteralOverflow)) << src;
+    }
+}
 
-TEST(ParserTests, Gen)
+TEST(ParserTests, DecodingLexer)
 {
-    Lexer l("42 - 21");
-    LookaheadLexer<5> lexer(l);
+    DecodingLexer l("18446744073709551615 - 1");
+    LookaheadLexer<5, DecodingLexer> lexer(l);
 
     Parser parser;
     auto r = parser.ParseExpression(lexer);
     ASSERT_TRUE(r.has_value());
-    ASSERT_EQ(r->type, ExprType::BinaryOperator);
 
     auto* opt_ast = parser.GetExprAst<ExprType::BinaryOperator>(r->index);
     ASSERT_NE(opt_ast, nullptr);
-    ASSERT_EQ(opt_ast->type, BinaryOperatorType::Minus);
+    ASSERT_EQ(parser.GetExprAst<ExprType::IntegralLiteral>(opt_ast->left.index)->value, UINT64_MAX);
+}
 
-    std::vector<char> data;
-    data.resize(2048, 0);
-    CodeGen_LLVM_IR g{parser, data, 1};
-    size_t variable_index = g.Gen(*opt_ast);
-    ASSERT_LE(g.required_space_, data.size());
+TEST(ParserTests, BlockLookaheadLexer)
+{
+    // One token per block, so keeping the checkpoint makes the ring grow while the parser peeks
+    Lexer l("(1 + 2) * 3 - 4 / (5 + 6) 7");
+    BlockLookaheadLexer<2, Lexer, 1> lexer(l);
+    const LookaheadCheckpoint start = lexer.Save();
+
+    Parser parser;
+    ASSERT_EQ(Print(parser, parser.ParseExpression(lexer)), "(((1 + 2) * 3) - (4 / (5 + 6)))");
+    ASSERT_EQ(lexer.Peek()->GetType(), kDecimalLiteral);
+
+    // The same tokens are parsed again without lexing them
+    lexer.Rewind(start);
+    lexer.Release(start);
+    Parser again;
+    ASSERT_EQ(Print(again, again.ParseExpression(lexer)), "(((1 + 2) * 3) - (4 / (5 + 6)))");
+    ASSERT_EQ(lexer.GetTokenView(*lexer.Peek()), "7");
+}
 
-    std::string var_name = std::format("%{}", variable_index);
-    auto eval_result = IRExpressionExecutor::ExecI32(SpanAsStringView(std::span{data}), var_name);
+TEST(ParserTests, BlockLookaheadDecodingLexer)
+{
+    DecodingLexer l("18446744073709551615 - (1 + 99999999999999999999)");
+    BlockLookaheadLexer<2, DecodingLexer> lexer(l);
 
-    ASSERT_TRUE(eval_result.has_value());
-    ASSERT_EQ(eval_result.value(), 21);
+    Parser parser;
+    ASSERT_EQ(parser.ParseExpression(lexer), std::unexpected(ParserErrorType::IntegerLiteralOverflow));
+    ASSERT_EQ(parser.GetExprs().GetNodes<IntegralLiteralExprAST>().front().value, UINT64_MAX);
 }
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <array>
+#include <string_view>
+#include <utility>
+
+// Shared by kaleidoscope-tests and kaleidoscope-benchmarks
+
+// All keywords of the full Kaleidoscope language, most of them share first bytes.
+// The lexer does not support them yet: keyword lookup tests and benchmarks use them as a larger set.
+inline constexpr std::array kExtendedKeywords{
+    std::pair{std::string_view{"def"}, 0},
+    std::pair{std::string_view{"extern"}, 1},
+    std::pair{std::string_view{"if"}, 2},
+    std::pair{std::string_view{"then"}, 3},
+    std::pair{std::string_view{"else"}, 4},
+    std::pair{std::string_view{"for"}, 5},
+    std::pair{std::string_view{"in"}, 6},
+    std::pair{std::string_view{"var"}, 7},
+    std::pair{std::string_view{"binary"}, 8},
+    std::pair{std::string_view{"unary"}, 9},
+};
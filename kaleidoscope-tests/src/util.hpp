@@ -5,8 +5,10 @@
 #include <source_location>
 
 #include "gtest/gtest.h"
+#include "kaleidoscope/lexer/block_lookahead_lexer.hpp"
 #include "kaleidoscope/lexer/lexer.hpp"
 #include "kaleidoscope/lexer/lookahead_lexer.hpp"
+#include "kaleidoscope/parser/parser.hpp"
 #include "magic_enum/magic_enum.hpp"
 using namespace kaleidoscope;  // NOLINT
 // IWYU pragma: end_exports
@@ -21,11 +23,7 @@ inline constexpr auto kEOF = TokenType::EndOfFile;
 
 [[nodiscard]] inline constexpr kaleidoscope::LexerToken EofToken(size_t text_len)
 {
-    return kaleidoscope::LexerToken{
-        .type = kaleidoscope::TokenType::EndOfFile,
-        .begin = text_len,
-        .end = text_len,
-    };
+    return kaleidoscope::LexerToken(kaleidoscope::TokenType::EndOfFile, text_len, text_len);
 }
 
 struct ExpectedToken
@@ -46,6 +44,31 @@ struct ExpectedError
 
 using ExpectedResult = std::expected<ExpectedToken, ExpectedError>;
 
+struct ParsedExpression
+{
+    Parser parser;
+    ExprId root;
+};
+
+// Parses an expression and gives all its literals the given width (the parser produces 32-bit ones)
+[[nodiscard]] inline ParsedExpression ParseWithLiteralBits(std::string_view src, uint8_t bits = 32)
+{
+    Lexer l(src);
+    LookaheadLexer<2> lexer(l);
+
+    ParsedExpression parsed;
+    const auto root = parsed.parser.ParseExpression(lexer);
+    EXPECT_TRUE(root.has_value()) << src;
+    if (root.has_value()) parsed.root = *root;
+
+    for (IntegralLiteralExprAST& literal : parsed.parser.GetExprs().GetNodes<IntegralLiteralExprAST>())
+    {
+        literal.type.bits = bits;
+    }
+
+    return parsed;
+}
+
 [[nodiscard]] inline constexpr ExpectedToken Tok(std::string_view text, TokenType type)
 {
     return {
@@ -78,39 +101,50 @@ inline constexpr void PrintExpectedResult(std::string_view prefix, const Expecte
     std::print("{}", suffix);
 }
 
-[[nodiscard]] constexpr ExpectedResult ToExpectedResult(std::string_view src, const LexerResult& r)
+template <typename Result>
+[[nodiscard]] constexpr ExpectedResult ToExpectedResult(std::string_view src, const Result& r)
 {
     if (r)
     {
         return ExpectedToken{
-            .token = src.substr(r->begin, r->end - r->begin),
-            .type = r->type,
+            .token = src.substr(r->GetBegin(), r->GetLength()),
+            .type = r->GetType(),
         };
     }
 
     const auto& err = r.error();
     return std::unexpected(
         ExpectedError{
-            .token = src.substr(err.begin, err.end - err.begin),
-            .type = err.type,
+            .token = src.substr(err.GetBegin(), err.GetLength()),
+            .type = err.GetType(),
         });
 }
 
+// Where the result begins in the source, for mismatch reports
+template <typename Result>
+[[nodiscard]] inline LineColumn GetResultLineColumn(std::string_view src, const Result& r)
+{
+    return LineIndex(src).GetLineColumn(r ? r->GetBegin() : r.error().GetBegin());
+}
+
+template <typename LexerType = Lexer>
 inline constexpr void CheckLexerOutput(
     std::source_location source_location,
     std::string_view src,
     std::initializer_list<ExpectedResult> expected_results)
 {
-    Lexer lexer(src);
+    LexerType lexer(src);
 
     for (const size_t idx : std::views::iota(0uz, expected_results.size()))
     {
         const ExpectedResult& expected = expected_results.begin()[idx];  // NOLINT
-        auto actual = ToExpectedResult(src, lexer.GetToken());
+        const auto result = lexer.GetToken();
+        auto actual = ToExpectedResult(src, result);
         if (expected != actual)
         {
+            const LineColumn line_column = GetResultLineColumn(src, result);
             std::println("{}:{}", source_location.file_name(), source_location.line());
-            std::println("At index {}:", idx);
+            std::println("At index {} (line {}, column {}):", idx, line_column.line, line_column.column);
             PrintExpectedResult("    Expected: ", expected, "\n");
             PrintExpectedResult("    Actual: ", actual, "\n");
             throw std::logic_error("Expectation mismatch");
@@ -118,14 +152,14 @@ inline constexpr void CheckLexerOutput(
     }
 }
 
-template <size_t horizon_size>
+template <size_t horizon_size, typename LookaheadType = LookaheadLexer<horizon_size>>
 inline constexpr void CheckLookaheadOutput(
     std::source_location source_location,
     std::string_view src,
     std::initializer_list<ExpectedResult> expected_results)
 {
     Lexer lexer(src);
-    LookaheadLexer<horizon_size> lookahead_lexer(lexer);
+    LookaheadType lookahead_lexer(lexer);
 
     for (const size_t base_idx : std::views::iota(size_t{0}, expected_results.size()))
     {
@@ -134,11 +168,13 @@ inline constexpr void CheckLookaheadOutput(
         {
             const size_t peek_idx = base_idx + offset;
             const ExpectedResult& expected = expected_results.begin()[peek_idx];  // NOLINT
-            auto actual = ToExpectedResult(src, lookahead_lexer.Peek(offset));
+            const auto& result = lookahead_lexer.Peek(offset);
+            auto actual = ToExpectedResult(src, result);
             if (expected != actual)
             {
+                const LineColumn line_column = GetResultLineColumn(src, result);
                 std::println("{}:{}", source_location.file_name(), source_location.line());
-                std::println("At index {}:", peek_idx);
+                std::println("At index {} (line {}, column {}):", peek_idx, line_column.line, line_column.column);
                 PrintExpectedResult("    Expected: ", expected, "\n");
                 PrintExpectedResult("    Actual: ", actual, "\n");
                 throw std::logic_error("Expectation mismatch");
@@ -0,0 +1,241 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <expected>
+#include <memory_resource>
+#include <optional>
+#include <vector>
+
+#include "kaleidoscope/parser/ast.hpp"
+
+namespace kaleidoscope
+{
+
+enum class BytecodeType : uint8_t
+{
+    I32,
+    I64,
+    F64,
+};
+
+// Binary opcodes are grouped by type, in the order of BinaryOperatorType
+enum class Opcode : uint8_t
+{
+    // dst = constants[constant index]
+    LoadI32,
+    LoadI64,
+    LoadF64,
+
+    // dst = a op b. Integer operations wrap around, division by zero and overflowing division are errors.
+    AddI32,
+    SubI32,
+    MulI32,
+    DivI32,
+    AddI64,
+    SubI64,
+    MulI64,
+    DivI64,
+    AddF64,
+    SubF64,
+    MulF64,
+    DivF64,
+
+    // Returns register a
+    Ret,
+};
+
+inline constexpr size_t kOpcodeCount = static_cast<size_t>(Opcode::Ret) + 1;
+
+[[nodiscard]] constexpr Opcode GetLoadOpcode(BytecodeType type) noexcept
+{
+    return static_cast<Opcode>(static_cast<uint8_t>(Opcode::LoadI32) + static_cast<uint8_t>(type));
+}
+
+[[nodiscard]] constexpr Opcode GetBinaryOpcode(BinaryOperatorType op, BytecodeType type) noexcept
+{
+    return static_cast<Opcode>(
+        static_cast<uint8_t>(Opcode::AddI32) + static_cast<uint8_t>(type) * 4 + static_cast<uint8_t>(op));
+}
+
+[[nodiscard]] constexpr bool IsLoadOpcode(Opcode opcode) noexcept
+{
+    return opcode <= Opcode::LoadF64;
+}
+
+[[nodiscard]] constexpr bool IsBinaryOpcode(Opcode opcode) noexcept
+{
+    return opcode >= Opcode::AddI32 && opcode <= Opcode::DivF64;
+}
+
+// Type of the result of a load or binary opcode
+[[nodiscard]] constexpr BytecodeType GetOpcodeType(Opcode opcode) noexcept
+{
+    const auto index = static_cast<uint8_t>(opcode);
+    if (IsLoadOpcode(opcode)) return static_cast<BytecodeType>(index);
+    return static_cast<BytecodeType>((index - static_cast<uint8_t>(Opcode::AddI32)) / 4);
+}
+
+static_assert(GetBinaryOpcode(BinaryOperatorType::Divide, BytecodeType::I64) == Opcode::DivI64);
+static_assert(GetBinaryOpcode(BinaryOperatorType::Plus, BytecodeType::F64) == Opcode::AddF64);
+static_assert(GetOpcodeType(Opcode::MulF64) == BytecodeType::F64);
+
+// Three-address instruction over a register file
+class Instruction
+{
+public:
+    [[nodiscard]] constexpr uint32_t GetConstantIndex() const noexcept { return a | (uint32_t{b} << 16); }
+
+    Opcode opcode = Opcode::Ret;
+    uint16_t dst = 0;
+
+    // Operand registers. Loads keep the low and high halves of the constant index here.
+    uint16_t a = 0;
+    uint16_t b = 0;
+};
+
+static_assert(sizeof(Instruction) == 8);
+
+// Contents of a register or a constant. Its type is known from the instructions.
+union BytecodeValue
+{
+    int32_t i32;
+    int64_t i64;
+    double f64;
+};
+
+// Straight-line register bytecode. Run it with BytecodeVM after it passes BytecodeVerifier.
+class BytecodeProgram
+{
+public:
+    static constexpr size_t kMaxRegisters = size_t{1} << 16;
+
+    explicit BytecodeProgram(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : instructions(resource),
+          constants(resource)
+    {
+    }
+
+    void EmitLoad(uint16_t dst, int32_t value) { EmitLoad(dst, BytecodeType::I32, {.i32 = value}); }
+    void EmitLoad(uint16_t dst, int64_t value) { EmitLoad(dst, BytecodeType::I64, {.i64 = value}); }
+    void EmitLoad(uint16_t dst, double value) { EmitLoad(dst, BytecodeType::F64, {.f64 = value}); }
+
+    void EmitBinary(BinaryOperatorType op, BytecodeType type, uint16_t dst, uint16_t a, uint16_t b)
+    {
+        instructions.push_back({.opcode = GetBinaryOpcode(op, type), .dst = dst, .a = a, .b = b});
+        UseRegister(dst);
+    }
+
+    void EmitRet(uint16_t src, BytecodeType type)
+    {
+        instructions.push_back({.opcode = Opcode::Ret, .a = src});
+        result_type = type;
+    }
+
+    void Clear() noexcept
+    {
+        instructions.clear();
+        constants.clear();
+        register_count = 0;
+        result_type = BytecodeType::I32;
+    }
+
+    std::pmr::vector<Instruction> instructions;
+    std::pmr::vector<BytecodeValue> constants;
+    size_t register_count = 0;
+    BytecodeType result_type = BytecodeType::I32;
+
+private:
+    void EmitLoad(uint16_t dst, BytecodeType type, BytecodeValue value)
+    {
+        const auto index = static_cast<uint32_t>(constants.size());
+        constants.push_back(value);
+        instructions.push_back({
+            .opcode = GetLoadOpcode(type),
+            .dst = dst,
+            .a = static_cast<uint16_t>(index),
+            .b = static_cast<uint16_t>(index >> 16),
+        });
+        UseRegister(dst);
+    }
+
+    void UseRegister(uint16_t r) { register_count = std::max(register_count, size_t{r} + 1); }
+};
+
+enum class BytecodeCompilerError : uint8_t
+{
+    // Only signed 32 and 64-bit integers are supported, and all literals must have the same type
+    UnsupportedType,
+
+    // The expression is nested deeper than BytecodeProgram::kMaxRegisters
+    TooManyRegisters,
+};
+
+// Lowers expressions to bytecode. The register of a value is its depth on the evaluation stack.
+// The AST is walked with an explicit stack, so the native stack depth does not depend on the input.
+// Shared subexpressions of a hash-consed AST are evaluated once per parent.
+class BytecodeCompiler
+{
+public:
+    explicit BytecodeCompiler(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : pending_(resource)
+    {
+    }
+
+    // Replaces the program with the one that returns the value of the expression
+    [[nodiscard]] std::expected<void, BytecodeCompilerError>
+    Compile(const ExprAstStorage& exprs, ExprId root, BytecodeProgram& program);
+
+private:
+    class PendingExpr
+    {
+    public:
+        ExprId id;
+
+        // Operands of the binary operator are already on the stack
+        bool operands_ready = false;
+    };
+
+    std::pmr::vector<PendingExpr> pending_;
+};
+
+enum class BytecodeVerificationErrorType : uint8_t
+{
+    InvalidOpcode,
+    InvalidRegister,
+    InvalidConstant,
+
+    // The register is read before anything is written to it
+    UndefinedRegister,
+
+    // Operand or returned register has a different type
+    TypeMismatch,
+
+    MissingRet,
+    CodeAfterRet,
+};
+
+class BytecodeVerificationError
+{
+public:
+    size_t instruction = 0;
+    BytecodeVerificationErrorType type;
+};
+
+// Checks everything that BytecodeVM does not check while running: opcodes, register and constant indices
+// and that every register is written with a value of the right type before it is read.
+class BytecodeVerifier
+{
+public:
+    explicit BytecodeVerifier(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : register_types_(resource)
+    {
+    }
+
+    [[nodiscard]] std::expected<void, BytecodeVerificationError> Verify(const BytecodeProgram& program);
+
+private:
+    std::pmr::vector<std::optional<BytecodeType>> register_types_;
+};
+
+}  // namespace kaleidoscope
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <expected>
+#include <memory_resource>
+#include <vector>
+
+#include "bytecode.hpp"
+
+namespace kaleidoscope
+{
+
+enum class BytecodeVMError : uint8_t
+{
+    DivisionByZero,
+
+    // Minimal integer divided by -1
+    IntegerOverflow,
+};
+
+// Interprets BytecodeProgram. Dispatch is threaded with computed goto where the compiler supports it,
+// so every handler jumps to the next one directly instead of returning to a shared switch.
+class BytecodeVM
+{
+public:
+    explicit BytecodeVM(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : registers_(resource)
+    {
+    }
+
+    // The program must pass BytecodeVerifier: instructions are not checked here.
+    // Returns the value of the type in BytecodeProgram::result_type.
+    [[nodiscard]] std::expected<BytecodeValue, BytecodeVMError> Run(const BytecodeProgram& program);
+
+private:
+    // Reused between runs
+    std::pmr::vector<BytecodeValue> registers_;
+};
+
+}  // namespace kaleidoscope
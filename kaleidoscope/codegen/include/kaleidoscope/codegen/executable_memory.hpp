@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <span>
+
+namespace kaleidoscope
+{
+
+// Pages with generated machine code. They are never writable and executable at the same time (W^X):
+// the code is copied while the pages are writable, then they become read-only and executable.
+// Uses mmap, so it is only built with the x86-64 backend on POSIX systems (KALEIDOSCOPE_X86_64_BACKEND).
+class ExecutableMemory
+{
+public:
+    // Returns errno of the failed mmap or mprotect
+    [[nodiscard]] static std::expected<ExecutableMemory, int> Create(std::span<const uint8_t> code);
+
+    ExecutableMemory(ExecutableMemory&& other) noexcept;
+    ExecutableMemory& operator=(ExecutableMemory&& other) noexcept;
+    ~ExecutableMemory();
+
+    ExecutableMemory(const ExecutableMemory&) = delete;
+    ExecutableMemory& operator=(const ExecutableMemory&) = delete;
+
+    // The code starts with the function
+    template <typename Function>
+    [[nodiscard]] Function* GetFunction() const noexcept
+    {
+        return reinterpret_cast<Function*>(data_);  // NOLINT
+    }
+
+    [[nodiscard]] size_t GetSize() const noexcept { return size_; }
+
+private:
+    ExecutableMemory(void* data, size_t size) noexcept : data_(data), size_(size) {}
+
+private:
+    void* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+}  // namespace kaleidoscope
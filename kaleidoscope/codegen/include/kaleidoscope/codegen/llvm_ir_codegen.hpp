@@ -0,0 +1,247 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "fmt/format.h"
+#include "kaleidoscope/parser/ast.hpp"
+#include "kaleidoscope/parser/expr_walker.hpp"
+#include "output_sink.hpp"
+
+namespace kaleidoscope
+{
+
+enum class IRCodeGenMode : uint8_t
+{
+    // Every literal is stored to a stack slot and loaded back, like clang -O0 does
+    Memory,
+
+    // Literals are immediate operands and results are SSA registers, so there is nothing for mem2reg to undo
+    SSA,
+};
+
+class IRCodeGenOptions
+{
+public:
+    size_t first_variable_index = 0;
+    IRCodeGenMode mode = IRCodeGenMode::Memory;
+};
+
+// Operand of an instruction: a register or an immediate constant
+class IRValue
+{
+public:
+    bool is_constant = false;
+    int64_t value = 0;
+
+    // Width of the integer type. Binary expressions have the type of their operands.
+    uint8_t bits = 32;
+};
+
+// Generates LLVM IR instructions that compute expressions into numbered registers.
+// Every instruction is formatted once into a small buffer on the stack and passed to the sink.
+// Expressions shared by several parents (see ParserOptions::hash_consing) are generated once.
+template <OutputSink Sink>
+class CodeGen_LLVM_IR
+{
+public:
+    explicit CodeGen_LLVM_IR(
+        const ExprAstStorage& exprs,
+        Sink& sink,
+        IRCodeGenOptions options = {},
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : exprs_(&exprs),
+          sink_(&sink),
+          next_var_(options.first_variable_index),
+          mode_(options.mode),
+          values_{MakeValues(resource, std::make_index_sequence<ExprNodeTypes::kSize>())},
+          walker_(resource)
+    {
+    }
+
+    // Returns variable index where result of expression will be stored
+    [[nodiscard]] size_t Gen(ExprId id)
+    {
+        const IRValue value = GenValue(id);
+        if (!value.is_constant) return static_cast<size_t>(value.value);
+
+        // The result must be in a register even if the whole expression is a constant
+        const size_t var_id = next_var_++;
+        Write("%{} = add i{} {}, 0\n", var_id, value.bits, value.value);
+        return var_id;
+    }
+
+    // Generates operands before operators without recursion, so any depth of expressions is supported
+    [[nodiscard]] IRValue GenValue(ExprId id)
+    {
+        std::ignore = walker_.Walk(
+            *exprs_,
+            id,
+            [&](ExprId operand) { return !GetValue(operand).has_value(); },
+            [&](ExprId expr_id, const auto& expr)
+            {
+                const IRValue value = MakeValue(expr);
+                GetValue(expr_id) = value;
+                return true;
+            });
+
+        return *GetValue(id);
+    }
+
+    // Returns variable index where result of expression will be stored
+    [[nodiscard]] size_t Gen(const IntegralLiteralExprAST& literal)
+    {
+        assert(literal.type.bits == 32 || literal.type.bits == 64);
+
+        const size_t var_ptr_id = next_var_++;
+        const size_t var_id = next_var_++;
+        const size_t align = literal.type.bits == 32 ? 4 : 8;
+
+        Write("%{} = alloca i{}, align {}\n", var_ptr_id, literal.type.bits, align);
+        Write("store i{} {}, ptr %{}, align {}\n", literal.type.bits, literal.GetSignedValue(), var_ptr_id, align);
+        Write("%{} = load i{}, ptr %{}, align {}\n", var_id, literal.type.bits, var_ptr_id, align);
+
+        return var_id;
+    }
+
+    // Returns variable index where result of expression will be stored
+    [[nodiscard]] size_t Gen(const BinaryOperatorExpression& binary_operator)
+    {
+        const IRValue left = GenValue(binary_operator.left);
+        const IRValue right = GenValue(binary_operator.right);
+        return GenOperator(binary_operator, left, right);
+    }
+
+    [[nodiscard]] static constexpr std::string_view GetInstructionName(BinaryOperatorType type) noexcept
+    {
+        switch (type)
+        {
+        case BinaryOperatorType::Plus:
+            return "add";
+        case BinaryOperatorType::Minus:
+            return "sub";
+        case BinaryOperatorType::Multiply:
+            return "mul";
+        case BinaryOperatorType::Divide:
+            return "sdiv";
+        }
+
+        assert(false);
+        return "";
+    }
+
+private:
+    // Longer than any instruction the generator emits
+    static constexpr size_t kMaxInstructionSize = 128;
+
+    template <typename... FormatArgs>
+    void Write(fmt::format_string<FormatArgs...> format_string, FormatArgs&&... args)
+    {
+        std::array<char, kMaxInstructionSize> buffer;  // NOLINT
+        const auto result =
+            fmt::format_to_n(buffer.data(), buffer.size(), format_string, std::forward<FormatArgs>(args)...);
+        assert(result.size <= buffer.size());
+        sink_->Write({buffer.data(), result.size});
+    }
+
+    // Returns variable index of the result of the operator applied to generated operands
+    [[nodiscard]] size_t GenOperator(const BinaryOperatorExpression& binary_operator, IRValue left, IRValue right)
+    {
+        assert(left.bits == right.bits);
+        const size_t var_id = next_var_++;
+
+        Write(
+            "%{} = {} i{} {}{}, {}{}\n",
+            var_id,
+            GetInstructionName(binary_operator.type),
+            left.bits,
+            left.is_constant ? "" : "%",
+            left.value,
+            right.is_constant ? "" : "%",
+            right.value);
+
+        return var_id;
+    }
+
+    // Value of the generated expression or nullopt
+    [[nodiscard]] std::optional<IRValue>& GetValue(ExprId id)
+    {
+        auto& values = values_[static_cast<size_t>(id.type)];
+        if (values.size() <= id.index) values.resize(id.index + 1);
+        return values[id.index];
+    }
+
+    [[nodiscard]] IRValue MakeValue(const IntegralLiteralExprAST& literal)
+    {
+        if (mode_ == IRCodeGenMode::SSA)
+        {
+            return {.is_constant = true, .value = literal.GetSignedValue(), .bits = literal.type.bits};
+        }
+
+        return {.is_constant = false, .value = static_cast<int64_t>(Gen(literal)), .bits = literal.type.bits};
+    }
+
+    // Operands are generated already
+    [[nodiscard]] IRValue MakeValue(const BinaryOperatorExpression& binary_operator)
+    {
+        const IRValue left = *GetValue(binary_operator.left);
+        const IRValue right = *GetValue(binary_operator.right);
+        const size_t var_id = GenOperator(binary_operator, left, right);
+        return {.is_constant = false, .value = static_cast<int64_t>(var_id), .bits = left.bits};
+    }
+
+    template <size_t... indices>
+    [[nodiscard]] static auto MakeValues(std::pmr::memory_resource* resource, std::index_sequence<indices...>)
+    {
+        return std::array{(static_cast<void>(indices), std::pmr::vector<std::optional<IRValue>>(resource))...};
+    }
+
+private:
+    const ExprAstStorage* exprs_ = nullptr;
+    Sink* sink_ = nullptr;
+    size_t next_var_ = 0;
+    IRCodeGenMode mode_;
+    std::array<std::pmr::vector<std::optional<IRValue>>, ExprNodeTypes::kSize> values_;
+    ExprPostOrderWalker walker_;
+};
+
+class GeneratedIR
+{
+public:
+    std::string text;
+
+    // Register that holds the result
+    size_t variable_index = 0;
+};
+
+// Generates IR into a string allocated once with the exact size: a counting pass measures the output
+// and the second pass writes it. Formatting twice is slower than growing a string, so this is for callers that
+// need contiguous text without slack. RopeSink is faster when the text may stay split into chunks.
+[[nodiscard]] inline GeneratedIR
+GenerateIRString(const ExprAstStorage& exprs, ExprId root, IRCodeGenOptions options = {})
+{
+    FixedBufferSink counter;
+    std::ignore = CodeGen_LLVM_IR{exprs, counter, options}.Gen(root);
+
+    // libstdc++ 12 passes the capacity of a short string instead of the requested size, so use the measured one
+    const size_t size = counter.GetRequiredSize();
+    GeneratedIR ir;
+    ir.text.resize_and_overwrite(
+        size,
+        [&](char* data, size_t)
+        {
+            FixedBufferSink sink({data, size});
+            ir.variable_index = CodeGen_LLVM_IR{exprs, sink, options}.Gen(root);
+            assert(sink.GetRequiredSize() == size);
+            return size;
+        });
+
+    return ir;
+}
+
+}  // namespace kaleidoscope
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace kaleidoscope
+{
+
+// Code generators write text through a sink: any class with void Write(std::string_view)
+template <typename T>
+concept OutputSink = requires(T& sink, std::string_view text) { sink.Write(text); };
+
+// Writes into a fixed buffer. Text that does not fit is dropped but still counted, so a pass with
+// an empty buffer measures the exact size of the output (see GenerateIRString).
+class FixedBufferSink
+{
+public:
+    constexpr explicit FixedBufferSink(std::span<char> buffer = {}) noexcept : buffer_(buffer) {}
+
+    constexpr void Write(std::string_view text) noexcept
+    {
+        if (written_ < buffer_.size())
+        {
+            const size_t n = std::min(text.size(), buffer_.size() - written_);
+            std::copy_n(text.data(), n, buffer_.data() + written_);
+            written_ += n;
+        }
+
+        required_size_ += text.size();
+    }
+
+    // Size of everything that was written, including the dropped text
+    [[nodiscard]] constexpr size_t GetRequiredSize() const noexcept { return required_size_; }
+    [[nodiscard]] constexpr bool Overflowed() const noexcept { return required_size_ > buffer_.size(); }
+    [[nodiscard]] constexpr std::string_view GetText() const noexcept { return {buffer_.data(), written_}; }
+
+private:
+    std::span<char> buffer_;
+    size_t written_ = 0;
+    size_t required_size_ = 0;
+};
+
+// Growable output of unknown size. Text is appended to fixed-size chunks and never moves,
+// so growing costs one chunk allocation and no copies of what was written before.
+class RopeSink
+{
+public:
+    static constexpr size_t kChunkSize = size_t{1} << 16;
+
+    explicit RopeSink(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : chunks_(resource)
+    {
+    }
+
+    ~RopeSink();
+
+    RopeSink(const RopeSink&) = delete;
+    RopeSink& operator=(const RopeSink&) = delete;
+
+    void Write(std::string_view text)
+    {
+        while (!text.empty())
+        {
+            if (chunk_used_ == kChunkSize) AddChunk();
+
+            const size_t n = std::min(text.size(), kChunkSize - chunk_used_);
+            std::memcpy(chunks_.back() + chunk_used_, text.data(), n);
+            chunk_used_ += n;
+            text.remove_prefix(n);
+        }
+    }
+
+    [[nodiscard]] size_t Size() const noexcept
+    {
+        return chunks_.empty() ? 0 : (chunks_.size() - 1) * kChunkSize + chunk_used_;
+    }
+
+    [[nodiscard]] size_t GetChunkCount() const noexcept { return chunks_.size(); }
+    [[nodiscard]] std::string_view GetChunk(size_t index) const noexcept
+    {
+        return {chunks_[index], index + 1 == chunks_.size() ? chunk_used_ : kChunkSize};
+    }
+
+    [[nodiscard]] std::string ToString() const;
+
+    // Writes the whole text to a file descriptor with as few writev calls as possible
+    // (one write per chunk on Windows). Returns 0 or errno of the failed call.
+    [[nodiscard]] int WriteTo(int fd) const;
+
+private:
+    void AddChunk();
+
+private:
+    std::pmr::vector<char*> chunks_;
+    size_t chunk_used_ = kChunkSize;
+};
+
+// Streams text to a file descriptor. Small writes are gathered in a buffer. A write that does not fit
+// goes to the descriptor together with the buffered text in one writev, without being copied.
+// The destructor flushes. After a failed write the rest of the output is dropped and GetError reports errno.
+class FdSink
+{
+public:
+    static constexpr size_t kBufferSize = size_t{1} << 16;
+
+    explicit FdSink(int fd) : fd_(fd), buffer_(std::make_unique_for_overwrite<char[]>(kBufferSize)) {}  // NOLINT
+    ~FdSink();
+
+    FdSink(const FdSink&) = delete;
+    FdSink& operator=(const FdSink&) = delete;
+
+    void Write(std::string_view text)
+    {
+        if (text.size() <= kBufferSize - used_)
+        {
+            std::memcpy(buffer_.get() + used_, text.data(), text.size());
+            used_ += text.size();
+            return;
+        }
+
+        WriteThrough(text);
+    }
+
+    void Flush() { WriteThrough({}); }
+
+    [[nodiscard]] int GetError() const noexcept { return error_; }
+
+private:
+    // Writes the buffered text followed by text
+    void WriteThrough(std::string_view text);
+
+private:
+    int fd_ = -1;
+    int error_ = 0;
+    std::unique_ptr<char[]> buffer_;  // NOLINT
+    size_t used_ = 0;
+};
+
+}  // namespace kaleidoscope
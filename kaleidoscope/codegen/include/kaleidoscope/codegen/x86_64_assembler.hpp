@@ -0,0 +1,161 @@
+#pragma once
+
+#include <cassert>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+namespace kaleidoscope
+{
+
+// Values match register numbers in instruction encodings
+enum class X86Register : uint8_t
+{
+    RAX,
+    RCX,
+    RDX,
+    RBX,
+    RSP,
+    RBP,
+    RSI,
+    RDI,
+    R8,
+    R9,
+    R10,
+    R11,
+    R12,
+    R13,
+    R14,
+    R15,
+};
+
+// Encodes the few x86-64 instructions that expressions need.
+// Arithmetic works on 32-bit (eax, ...) or 64-bit (rax, ...) registers depending on bits.
+class X86_64Assembler
+{
+public:
+    explicit X86_64Assembler(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : code_(resource)
+    {
+    }
+
+    // mov dst, value
+    void MovImmediate(X86Register dst, int64_t value, uint8_t bits)
+    {
+        if (bits == 32)
+        {
+            EmitRex(false, X86Register::RAX, dst);
+            Emit(static_cast<uint8_t>(0xB8 + Low(dst)));
+            EmitImmediate(static_cast<uint32_t>(value));
+        }
+        else if (value >= std::numeric_limits<int32_t>::min() && value <= std::numeric_limits<int32_t>::max())
+        {
+            // Sign-extended 32-bit immediate is 3 bytes shorter than movabs
+            EmitRex(true, X86Register::RAX, dst);
+            Emit(0xC7);
+            EmitModRM(0, dst);
+            EmitImmediate(static_cast<uint32_t>(value));
+        }
+        else
+        {
+            EmitRex(true, X86Register::RAX, dst);
+            Emit(static_cast<uint8_t>(0xB8 + Low(dst)));
+            EmitImmediate(static_cast<uint64_t>(value));
+        }
+    }
+
+    // mov dst, src
+    void Mov(X86Register dst, X86Register src, uint8_t bits) { EmitRegisterToRegister(0x89, dst, src, bits); }
+
+    // add dst, src
+    void Add(X86Register dst, X86Register src, uint8_t bits) { EmitRegisterToRegister(0x01, dst, src, bits); }
+
+    // sub dst, src
+    void Sub(X86Register dst, X86Register src, uint8_t bits) { EmitRegisterToRegister(0x29, dst, src, bits); }
+
+    // imul dst, src
+    void IMul(X86Register dst, X86Register src, uint8_t bits)
+    {
+        EmitRex(IsWide(bits), dst, src);
+        Emit(0x0F);
+        Emit(0xAF);
+        EmitModRM(Low(dst), src);
+    }
+
+    // cdq or cqo: sign-extends eax into edx:eax (rax into rdx:rax) before idiv
+    void SignExtendAccumulator(uint8_t bits)
+    {
+        EmitRex(IsWide(bits), X86Register::RAX, X86Register::RAX);
+        Emit(0x99);
+    }
+
+    // idiv divisor: signed division of edx:eax (rdx:rax), the quotient goes to eax (rax)
+    void IDiv(X86Register divisor, uint8_t bits)
+    {
+        EmitRex(IsWide(bits), X86Register::RAX, divisor);
+        Emit(0xF7);
+        EmitModRM(7, divisor);
+    }
+
+    void Push(X86Register r)
+    {
+        EmitRex(false, X86Register::RAX, r);
+        Emit(static_cast<uint8_t>(0x50 + Low(r)));
+    }
+
+    void Pop(X86Register r)
+    {
+        EmitRex(false, X86Register::RAX, r);
+        Emit(static_cast<uint8_t>(0x58 + Low(r)));
+    }
+
+    void Ret() { Emit(0xC3); }
+
+    [[nodiscard]] std::span<const uint8_t> GetCode() const noexcept { return code_; }
+
+    void Clear() noexcept { code_.clear(); }
+
+private:
+    [[nodiscard]] static constexpr bool IsWide(uint8_t bits) noexcept
+    {
+        assert(bits == 32 || bits == 64);
+        return bits == 64;
+    }
+
+    [[nodiscard]] static constexpr uint8_t Low(X86Register r) noexcept { return static_cast<uint8_t>(r) & 7; }
+    [[nodiscard]] static constexpr bool High(X86Register r) noexcept { return static_cast<uint8_t>(r) >= 8; }
+
+    void Emit(uint8_t byte) { code_.push_back(byte); }
+
+    template <std::unsigned_integral T>
+    void EmitImmediate(T value)
+    {
+        for (size_t i = 0; i != sizeof(T); ++i) Emit(static_cast<uint8_t>(value >> (i * 8)));
+    }
+
+    // REX prefix is emitted only when it is needed: for 64-bit operands or registers r8-r15
+    void EmitRex(bool wide, X86Register reg, X86Register rm)
+    {
+        const auto rex = static_cast<uint8_t>(0x40 | (wide ? 8 : 0) | (High(reg) ? 4 : 0) | (High(rm) ? 1 : 0));
+        if (rex != 0x40) Emit(rex);
+    }
+
+    // Register-direct ModRM byte
+    void EmitModRM(uint8_t reg, X86Register rm) { Emit(static_cast<uint8_t>(0xC0 | (reg << 3) | Low(rm))); }
+
+    // op r/m, reg
+    void EmitRegisterToRegister(uint8_t opcode, X86Register dst, X86Register src, uint8_t bits)
+    {
+        EmitRex(IsWide(bits), src, dst);
+        Emit(opcode);
+        EmitModRM(Low(src), dst);
+    }
+
+private:
+    std::pmr::vector<uint8_t> code_;
+};
+
+}  // namespace kaleidoscope
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <expected>
+#include <memory_resource>
+#include <span>
+
+#include "executable_memory.hpp"
+#include "kaleidoscope/parser/ast.hpp"
+#include "kaleidoscope/parser/expr_walker.hpp"
+#include "x86_64_assembler.hpp"
+
+namespace kaleidoscope
+{
+
+enum class X86_64CodeGenErrorType : uint8_t
+{
+    // Only signed 32 and 64-bit integers are supported, and all literals must have the same type
+    UnsupportedType,
+
+    // Could not allocate executable memory
+    MemoryMappingFailed,
+};
+
+class X86_64CodeGenError
+{
+public:
+    X86_64CodeGenErrorType type;
+
+    // errno for MemoryMappingFailed
+    int error_code = 0;
+};
+
+// Generates x86-64 machine code of a function without arguments that returns the value of an expression
+// in eax or rax (System V ABI), without LLVM. Only built on System V x86-64 hosts (KALEIDOSCOPE_X86_64_BACKEND).
+// Operands are evaluated on a stack that is kept in caller-saved registers. When it is deeper than there
+// are registers, the bottom values are pushed to the machine stack and popped back when the stack shrinks.
+// As in LLVM IR, division by zero and overflowing division are undefined: idiv raises SIGFPE.
+// Shared subexpressions of a hash-consed AST are evaluated once per parent.
+// The AST is walked with an explicit stack, but the generated code needs a machine stack slot per spilled value,
+// so deeply right-nested expressions are limited by the stack of the thread that runs them.
+class X86_64CodeGen
+{
+public:
+    explicit X86_64CodeGen(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : asm_(resource),
+          walker_(resource)
+    {
+    }
+
+    // Replaces the code with the function that evaluates the expression
+    [[nodiscard]] std::expected<void, X86_64CodeGenError> Gen(const ExprAstStorage& exprs, ExprId root);
+
+    [[nodiscard]] std::span<const uint8_t> GetCode() const noexcept { return asm_.GetCode(); }
+
+private:
+    // Evaluation stack registers. rax and rdx are used by idiv and are not in the pool.
+    static constexpr std::array kRegisters{
+        X86Register::RCX,
+        X86Register::RSI,
+        X86Register::RDI,
+        X86Register::R8,
+        X86Register::R9,
+        X86Register::R10,
+        X86Register::R11,
+    };
+
+    // Register with the value at a given depth of the evaluation stack
+    [[nodiscard]] static constexpr X86Register GetRegister(size_t depth) noexcept
+    {
+        return kRegisters[depth % kRegisters.size()];
+    }
+
+    // Operands are generated before this is called
+    [[nodiscard]] bool GenExpr(const IntegralLiteralExprAST& literal);
+    [[nodiscard]] bool GenExpr(const BinaryOperatorExpression& binary_operator);
+
+private:
+    X86_64Assembler asm_;
+    ExprPostOrderWalker walker_;
+    BuiltinTypeInfo type_{};
+    size_t depth_ = 0;
+};
+
+// Generates the expression and copies it to executable memory.
+// The result can be called as int32_t() or int64_t() depending on the type of the expression.
+[[nodiscard]] std::expected<ExecutableMemory, X86_64CodeGenError> CompileX86_64(
+    const ExprAstStorage& exprs,
+    ExprId root,
+    std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+}  // namespace kaleidoscope
@@ -0,0 +1,132 @@
+#include "kaleidoscope/codegen/bytecode.hpp"
+
+#include <cassert>
+#include <span>
+
+namespace kaleidoscope
+{
+
+std::expected<void, BytecodeCompilerError>
+BytecodeCompiler::Compile(const ExprAstStorage& exprs, ExprId root, BytecodeProgram& program)
+{
+    program.Clear();
+
+    const BuiltinTypeInfo type = GetResultType(exprs, root);
+    if (type.type != BuiltinType::SignedInteger || (type.bits != 32 && type.bits != 64))
+    {
+        return std::unexpected(BytecodeCompilerError::UnsupportedType);
+    }
+
+    const BytecodeType bytecode_type = type.bits == 32 ? BytecodeType::I32 : BytecodeType::I64;
+
+    // Post-order: operands go to registers depth and depth + 1, the result replaces the left one
+    size_t depth = 0;
+    pending_.clear();
+    pending_.push_back({.id = root});
+    while (!pending_.empty())
+    {
+        const PendingExpr expr = pending_.back();
+        pending_.pop_back();
+
+        if (expr.id.type == ExprType::IntegralLiteral)
+        {
+            const IntegralLiteralExprAST& literal = exprs.GetNodes<IntegralLiteralExprAST>()[expr.id.index];
+            if (literal.type != type) return std::unexpected(BytecodeCompilerError::UnsupportedType);
+            if (depth == BytecodeProgram::kMaxRegisters)
+            {
+                return std::unexpected(BytecodeCompilerError::TooManyRegisters);
+            }
+
+            const auto dst = static_cast<uint16_t>(depth++);
+            if (bytecode_type == BytecodeType::I32)
+            {
+                program.EmitLoad(dst, static_cast<int32_t>(literal.GetSignedValue()));
+            }
+            else
+            {
+                program.EmitLoad(dst, literal.GetSignedValue());
+            }
+
+            continue;
+        }
+
+        const BinaryOperatorExpression& binary_operator = exprs.GetNodes<BinaryOperatorExpression>()[expr.id.index];
+        if (expr.operands_ready)
+        {
+            const auto left = static_cast<uint16_t>(depth - 2);
+            const auto right = static_cast<uint16_t>(depth - 1);
+            program.EmitBinary(binary_operator.type, bytecode_type, left, left, right);
+            --depth;
+            continue;
+        }
+
+        pending_.push_back({.id = expr.id, .operands_ready = true});
+        pending_.push_back({.id = binary_operator.right});
+        pending_.push_back({.id = binary_operator.left});
+    }
+
+    assert(depth == 1);
+    program.EmitRet(0, bytecode_type);
+    return {};
+}
+
+std::expected<void, BytecodeVerificationError> BytecodeVerifier::Verify(const BytecodeProgram& program)
+{
+    register_types_.assign(program.register_count, std::nullopt);
+
+    const auto error = [](size_t instruction, BytecodeVerificationErrorType type)
+    {
+        return std::unexpected(BytecodeVerificationError{.instruction = instruction, .type = type});
+    };
+
+    // Reads register r that must hold a value of the given type
+    const auto check_operand = [&](size_t instruction, uint16_t r, BytecodeType type)
+        -> std::expected<void, BytecodeVerificationError>
+    {
+        if (r >= register_types_.size()) return error(instruction, BytecodeVerificationErrorType::InvalidRegister);
+        if (!register_types_[r].has_value())
+        {
+            return error(instruction, BytecodeVerificationErrorType::UndefinedRegister);
+        }
+        if (*register_types_[r] != type) return error(instruction, BytecodeVerificationErrorType::TypeMismatch);
+        return {};
+    };
+
+    const std::span<const Instruction> instructions = program.instructions;
+    for (size_t i = 0; i != instructions.size(); ++i)
+    {
+        const Instruction& instruction = instructions[i];
+        if (static_cast<size_t>(instruction.opcode) >= kOpcodeCount)
+        {
+            return error(i, BytecodeVerificationErrorType::InvalidOpcode);
+        }
+
+        if (instruction.opcode == Opcode::Ret)
+        {
+            if (auto r = check_operand(i, instruction.a, program.result_type); !r.has_value()) return r;
+            if (i + 1 != instructions.size()) return error(i + 1, BytecodeVerificationErrorType::CodeAfterRet);
+            return {};
+        }
+
+        const BytecodeType type = GetOpcodeType(instruction.opcode);
+        if (IsLoadOpcode(instruction.opcode))
+        {
+            if (instruction.GetConstantIndex() >= program.constants.size())
+            {
+                return error(i, BytecodeVerificationErrorType::InvalidConstant);
+            }
+        }
+        else
+        {
+            if (auto r = check_operand(i, instruction.a, type); !r.has_value()) return r;
+            if (auto r = check_operand(i, instruction.b, type); !r.has_value()) return r;
+        }
+
+        if (instruction.dst >= register_types_.size()) return error(i, BytecodeVerificationErrorType::InvalidRegister);
+        register_types_[instruction.dst] = type;
+    }
+
+    return error(instructions.size(), BytecodeVerificationErrorType::MissingRet);
+}
+
+}  // namespace kaleidoscope
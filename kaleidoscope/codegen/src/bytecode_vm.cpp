@@ -0,0 +1,149 @@
+#include "kaleidoscope/codegen/bytecode_vm.hpp"
+
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#if defined(__GNUC__)
+#define KALEIDOSCOPE_VM_COMPUTED_GOTO 1
+#else
+#define KALEIDOSCOPE_VM_COMPUTED_GOTO 0
+#endif
+
+namespace kaleidoscope
+{
+
+namespace
+{
+
+// Two's complement wrap around, like add, sub and mul in LLVM IR
+template <std::signed_integral T>
+[[nodiscard]] constexpr T Wrap(std::make_unsigned_t<T> value) noexcept
+{
+    return static_cast<T>(value);
+}
+
+template <std::signed_integral T>
+[[nodiscard]] constexpr std::make_unsigned_t<T> AsUnsigned(T value) noexcept
+{
+    return static_cast<std::make_unsigned_t<T>>(value);
+}
+
+}  // namespace
+
+#if KALEIDOSCOPE_VM_COMPUTED_GOTO
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+#if defined(__clang__)
+#pragma clang diagnostic ignored "-Wgnu-label-as-value"
+#endif
+#endif
+
+std::expected<BytecodeValue, BytecodeVMError> BytecodeVM::Run(const BytecodeProgram& program)
+{
+    registers_.resize(program.register_count);
+    BytecodeValue* r = registers_.data();
+    const BytecodeValue* constants = program.constants.data();
+    const Instruction* ip = program.instructions.data();
+
+#if KALEIDOSCOPE_VM_COMPUTED_GOTO
+    // Order of Opcode
+    static const void* const kHandlers[]{
+        &&LoadI32, &&LoadI64, &&LoadF64,                         // NOLINT
+        &&AddI32,  &&SubI32,  &&MulI32,  &&DivI32,               // NOLINT
+        &&AddI64,  &&SubI64,  &&MulI64,  &&DivI64,               // NOLINT
+        &&AddF64,  &&SubF64,  &&MulF64,  &&DivF64,               // NOLINT
+        &&Ret,                                                   // NOLINT
+    };
+    static_assert(std::size(kHandlers) == kOpcodeCount);
+
+#define KALEIDOSCOPE_VM_DISPATCH() goto* kHandlers[static_cast<size_t>(ip->opcode)]  // NOLINT
+#define KALEIDOSCOPE_VM_CASE(name) name:
+    KALEIDOSCOPE_VM_DISPATCH();
+#else
+#define KALEIDOSCOPE_VM_DISPATCH() goto dispatch  // NOLINT
+#define KALEIDOSCOPE_VM_CASE(name) case Opcode::name:
+dispatch:
+    switch (ip->opcode)
+    {
+#endif
+
+#define KALEIDOSCOPE_VM_LOAD(name)                      \
+    KALEIDOSCOPE_VM_CASE(name)                          \
+    {                                                   \
+        r[ip->dst] = constants[ip->GetConstantIndex()]; \
+        ++ip;                                           \
+        KALEIDOSCOPE_VM_DISPATCH();                     \
+    }
+
+#define KALEIDOSCOPE_VM_INTEGER(name, field, T, op)                                              \
+    KALEIDOSCOPE_VM_CASE(name)                                                                   \
+    {                                                                                            \
+        r[ip->dst].field = Wrap<T>(AsUnsigned(r[ip->a].field) op AsUnsigned(r[ip->b].field)); \
+        ++ip;                                                                                    \
+        KALEIDOSCOPE_VM_DISPATCH();                                                              \
+    }
+
+#define KALEIDOSCOPE_VM_DIVIDE(name, field, T)                                                          \
+    KALEIDOSCOPE_VM_CASE(name)                                                                          \
+    {                                                                                                   \
+        const T divisor = r[ip->b].field;                                                               \
+        if (divisor == 0) return std::unexpected(BytecodeVMError::DivisionByZero);                      \
+        if (divisor == -1 && r[ip->a].field == std::numeric_limits<T>::min())                           \
+        {                                                                                               \
+            return std::unexpected(BytecodeVMError::IntegerOverflow);                                   \
+        }                                                                                               \
+        r[ip->dst].field = r[ip->a].field / divisor;                                                    \
+        ++ip;                                                                                           \
+        KALEIDOSCOPE_VM_DISPATCH();                                                                     \
+    }
+
+#define KALEIDOSCOPE_VM_FLOAT(name, op)                   \
+    KALEIDOSCOPE_VM_CASE(name)                            \
+    {                                                     \
+        r[ip->dst].f64 = r[ip->a].f64 op r[ip->b].f64;    \
+        ++ip;                                             \
+        KALEIDOSCOPE_VM_DISPATCH();                       \
+    }
+
+    KALEIDOSCOPE_VM_LOAD(LoadI32)
+    KALEIDOSCOPE_VM_LOAD(LoadI64)
+    KALEIDOSCOPE_VM_LOAD(LoadF64)
+    KALEIDOSCOPE_VM_INTEGER(AddI32, i32, int32_t, +)
+    KALEIDOSCOPE_VM_INTEGER(SubI32, i32, int32_t, -)
+    KALEIDOSCOPE_VM_INTEGER(MulI32, i32, int32_t, *)
+    KALEIDOSCOPE_VM_DIVIDE(DivI32, i32, int32_t)
+    KALEIDOSCOPE_VM_INTEGER(AddI64, i64, int64_t, +)
+    KALEIDOSCOPE_VM_INTEGER(SubI64, i64, int64_t, -)
+    KALEIDOSCOPE_VM_INTEGER(MulI64, i64, int64_t, *)
+    KALEIDOSCOPE_VM_DIVIDE(DivI64, i64, int64_t)
+    KALEIDOSCOPE_VM_FLOAT(AddF64, +)
+    KALEIDOSCOPE_VM_FLOAT(SubF64, -)
+    KALEIDOSCOPE_VM_FLOAT(MulF64, *)
+    KALEIDOSCOPE_VM_FLOAT(DivF64, /)
+
+    KALEIDOSCOPE_VM_CASE(Ret)
+    {
+        return r[ip->a];
+    }
+
+#if !KALEIDOSCOPE_VM_COMPUTED_GOTO
+    }
+
+    // Only an invalid opcode gets here and BytecodeVerifier rejects those
+    std::unreachable();
+#endif
+
+#undef KALEIDOSCOPE_VM_FLOAT
+#undef KALEIDOSCOPE_VM_DIVIDE
+#undef KALEIDOSCOPE_VM_INTEGER
+#undef KALEIDOSCOPE_VM_LOAD
+#undef KALEIDOSCOPE_VM_CASE
+#undef KALEIDOSCOPE_VM_DISPATCH
+}
+
+#if KALEIDOSCOPE_VM_COMPUTED_GOTO
+#pragma GCC diagnostic pop
+#endif
+
+}  // namespace kaleidoscope
@@ -0,0 +1,52 @@
+#include "kaleidoscope/codegen/executable_memory.hpp"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+namespace kaleidoscope
+{
+
+std::expected<ExecutableMemory, int> ExecutableMemory::Create(std::span<const uint8_t> code)
+{
+    const auto page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t size = std::max((code.size() + page_size - 1) / page_size, size_t{1}) * page_size;
+
+    void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (data == MAP_FAILED) return std::unexpected(errno);
+
+    ExecutableMemory memory(data, size);
+    std::memcpy(data, code.data(), code.size());
+    if (mprotect(data, size, PROT_READ | PROT_EXEC) != 0) return std::unexpected(errno);
+
+    return memory;
+}
+
+ExecutableMemory::ExecutableMemory(ExecutableMemory&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0))
+{
+}
+
+ExecutableMemory& ExecutableMemory::operator=(ExecutableMemory&& other) noexcept
+{
+    if (this != &other)
+    {
+        if (data_ != nullptr) munmap(data_, size_);
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+    }
+
+    return *this;
+}
+
+ExecutableMemory::~ExecutableMemory()
+{
+    if (data_ != nullptr) munmap(data_, size_);
+}
+
+}  // namespace kaleidoscope
@@ -0,0 +1,136 @@
+#include "kaleidoscope/codegen/output_sink.hpp"
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <sys/uio.h>
+#endif
+
+#include <cerrno>
+#include <climits>
+
+namespace kaleidoscope
+{
+
+namespace
+{
+
+#ifdef _WIN32
+
+// There is no writev: the pieces are written one by one
+class iovec  // NOLINT
+{
+public:
+    void* iov_base = nullptr;
+    size_t iov_len = 0;
+};
+
+// Writes all iovecs. Returns 0 or errno.
+[[nodiscard]] int WriteAll(int fd, std::span<iovec> iovecs)
+{
+    for (const iovec& piece : iovecs)
+    {
+        const char* data = static_cast<const char*>(piece.iov_base);
+        size_t size = piece.iov_len;
+        while (size != 0)
+        {
+            const auto count = static_cast<unsigned>(std::min(size, size_t{INT_MAX}));
+            const int result = _write(fd, data, count);
+            if (result < 0) return errno;
+
+            data += result;
+            size -= static_cast<size_t>(result);
+        }
+    }
+
+    return 0;
+}
+
+#else
+
+// Writes all iovecs, continuing after partial writes and interrupts. Returns 0 or errno.
+[[nodiscard]] int WriteAll(int fd, std::span<iovec> iovecs)
+{
+    while (!iovecs.empty())
+    {
+        const size_t count = std::min(iovecs.size(), size_t{IOV_MAX});
+        const ssize_t result = writev(fd, iovecs.data(), static_cast<int>(count));
+        if (result < 0)
+        {
+            if (errno == EINTR) continue;
+            return errno;
+        }
+
+        auto written = static_cast<size_t>(result);
+        while (!iovecs.empty() && written >= iovecs.front().iov_len)
+        {
+            written -= iovecs.front().iov_len;
+            iovecs = iovecs.subspan(1);
+        }
+
+        if (written != 0)
+        {
+            iovecs.front().iov_base = static_cast<char*>(iovecs.front().iov_base) + written;
+            iovecs.front().iov_len -= written;
+        }
+    }
+
+    return 0;
+}
+
+#endif
+
+}  // namespace
+
+RopeSink::~RopeSink()
+{
+    for (char* chunk : chunks_) chunks_.get_allocator().resource()->deallocate(chunk, kChunkSize);
+}
+
+std::string RopeSink::ToString() const
+{
+    std::string text;
+    text.reserve(Size());
+    for (size_t i = 0; i != chunks_.size(); ++i) text += GetChunk(i);
+    return text;
+}
+
+int RopeSink::WriteTo(int fd) const
+{
+    std::vector<iovec> iovecs(chunks_.size());
+    for (size_t i = 0; i != chunks_.size(); ++i)
+    {
+        const std::string_view chunk = GetChunk(i);
+        iovecs[i] = {.iov_base = const_cast<char*>(chunk.data()), .iov_len = chunk.size()};  // NOLINT
+    }
+
+    return WriteAll(fd, iovecs);
+}
+
+void RopeSink::AddChunk()
+{
+    chunks_.push_back(static_cast<char*>(chunks_.get_allocator().resource()->allocate(kChunkSize)));
+    chunk_used_ = 0;
+}
+
+FdSink::~FdSink()
+{
+    Flush();
+}
+
+void FdSink::WriteThrough(std::string_view text)
+{
+    if (error_ == 0 && (used_ != 0 || !text.empty()))
+    {
+        std::array<iovec, 2> iovecs{{
+            {.iov_base = buffer_.get(), .iov_len = used_},
+            {.iov_base = const_cast<char*>(text.data()), .iov_len = text.size()},  // NOLINT
+        }};
+
+        error_ = WriteAll(fd_, iovecs);
+    }
+
+    used_ = 0;
+}
+
+}  // namespace kaleidoscope
@@ -0,0 +1,88 @@
+#include "kaleidoscope/codegen/x86_64_codegen.hpp"
+
+namespace kaleidoscope
+{
+
+std::expected<void, X86_64CodeGenError> X86_64CodeGen::Gen(const ExprAstStorage& exprs, ExprId root)
+{
+    asm_.Clear();
+    type_ = GetResultType(exprs, root);
+    depth_ = 0;
+
+    const auto gen_expr = [&](ExprId, const auto& expr) { return GenExpr(expr); };
+
+    if (type_.type != BuiltinType::SignedInteger || (type_.bits != 32 && type_.bits != 64) ||
+        !walker_.Walk(exprs, root, gen_expr))
+    {
+        return std::unexpected(X86_64CodeGenError{.type = X86_64CodeGenErrorType::UnsupportedType});
+    }
+
+    assert(depth_ == 1);
+    asm_.Mov(X86Register::RAX, GetRegister(0), type_.bits);
+    asm_.Ret();
+    return {};
+}
+
+bool X86_64CodeGen::GenExpr(const IntegralLiteralExprAST& literal)
+{
+    if (literal.type != type_) return false;
+
+    // The register holds the value that is kRegisters.size() deeper
+    const X86Register r = GetRegister(depth_);
+    if (depth_ >= kRegisters.size()) asm_.Push(r);
+
+    asm_.MovImmediate(r, literal.GetSignedValue(), type_.bits);
+    ++depth_;
+    return true;
+}
+
+bool X86_64CodeGen::GenExpr(const BinaryOperatorExpression& binary_operator)
+{
+    assert(depth_ >= 2);
+    const X86Register left = GetRegister(depth_ - 2);
+    const X86Register right = GetRegister(depth_ - 1);
+    const uint8_t bits = type_.bits;
+
+    switch (binary_operator.type)
+    {
+    case BinaryOperatorType::Plus:
+        asm_.Add(left, right, bits);
+        break;
+    case BinaryOperatorType::Minus:
+        asm_.Sub(left, right, bits);
+        break;
+    case BinaryOperatorType::Multiply:
+        asm_.IMul(left, right, bits);
+        break;
+    case BinaryOperatorType::Divide:
+        asm_.Mov(X86Register::RAX, left, bits);
+        asm_.SignExtendAccumulator(bits);
+        asm_.IDiv(right, bits);
+        asm_.Mov(left, X86Register::RAX, bits);
+        break;
+    }
+
+    // The register of the right operand is free now and gets back the value that was pushed out of it
+    --depth_;
+    if (depth_ >= kRegisters.size()) asm_.Pop(right);
+
+    return true;
+}
+
+std::expected<ExecutableMemory, X86_64CodeGenError>
+CompileX86_64(const ExprAstStorage& exprs, ExprId root, std::pmr::memory_resource* resource)
+{
+    X86_64CodeGen codegen(resource);
+    if (auto r = codegen.Gen(exprs, root); !r.has_value()) return std::unexpected(r.error());
+
+    auto memory = ExecutableMemory::Create(codegen.GetCode());
+    if (!memory.has_value())
+    {
+        return std::unexpected(
+            X86_64CodeGenError{.type = X86_64CodeGenErrorType::MemoryMappingFailed, .error_code = memory.error()});
+    }
+
+    return std::move(*memory);
+}
+
+}  // namespace kaleidoscope
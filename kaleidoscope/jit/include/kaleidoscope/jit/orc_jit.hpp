@@ -0,0 +1,107 @@
+#pragma once
+
+#include <concepts>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace llvm::orc
+{
+class LLJIT;
+}  // namespace llvm::orc
+
+namespace kaleidoscope
+{
+
+class OrcJitOptions
+{
+public:
+    // Compile with LLVM optimizations. Expressions are small, so by default lower latency of -O0 is preferred.
+    bool optimize = false;
+};
+
+// Types that evaluated expressions can return
+template <typename T>
+concept JitResult = std::same_as<T, int32_t> || std::same_as<T, int64_t> || std::same_as<T, double>;
+
+template <JitResult T>
+[[nodiscard]] constexpr std::string_view GetIRTypeName() noexcept
+{
+    if constexpr (std::same_as<T, int32_t>) return "i32";
+    if constexpr (std::same_as<T, int64_t>) return "i64";
+    if constexpr (std::same_as<T, double>) return "double";
+}
+
+// Module compiled by OrcJit. Its code stays loaded until the module is destroyed.
+// Must not outlive the OrcJit that compiled it.
+class JitModule
+{
+public:
+    JitModule(JitModule&&) noexcept;
+    JitModule& operator=(JitModule&&) noexcept;
+    ~JitModule();
+
+    // Address of the function that was requested in OrcJit::Compile
+    template <typename Function>
+    [[nodiscard]] Function* GetFunction() const noexcept
+    {
+        return reinterpret_cast<Function*>(function_address_);  // NOLINT
+    }
+
+private:
+    friend class OrcJit;
+
+    // Owns the code of the module in the JIT
+    class Resources;
+
+    JitModule(std::unique_ptr<Resources> resources, uintptr_t function_address);
+
+private:
+    std::unique_ptr<Resources> resources_;
+    uintptr_t function_address_ = 0;
+};
+
+// Compiles LLVM IR in memory with LLVM ORC (LLJIT) and runs it in this process.
+// Unlike running lli, evaluation does not spawn a process and results are returned without printing them.
+class OrcJit
+{
+public:
+    static constexpr std::string_view kExpressionFunctionName = "kaleidoscope_expression";
+
+    [[nodiscard]] static std::expected<OrcJit, std::string> Create(OrcJitOptions options = {});
+
+    OrcJit(OrcJit&&) noexcept;
+    OrcJit& operator=(OrcJit&&) noexcept;
+    ~OrcJit();
+
+    // Parses and verifies a module in LLVM IR text form and compiles function_name from it.
+    // Names of functions must not repeat among modules that are loaded at the same time.
+    [[nodiscard]] std::expected<JitModule, std::string> Compile(
+        std::string_view module_ir,
+        std::string_view function_name);
+
+    // Evaluates instructions that compute variable_name, i.e. the output of CodeGen_LLVM_IR.
+    // Instructions are the body of a function without arguments, so registers must start from %1.
+    template <JitResult T>
+    [[nodiscard]] std::expected<T, std::string> Exec(std::string_view expression_ir, std::string_view variable_name)
+    {
+        const std::string module_ir = MakeExpressionModule(GetIRTypeName<T>(), expression_ir, variable_name);
+        const auto module = Compile(module_ir, kExpressionFunctionName);
+        if (!module.has_value()) return std::unexpected(module.error());
+        return module->GetFunction<T()>()();
+    }
+
+    // Wraps expression instructions into a module with function kExpressionFunctionName that returns variable_name
+    [[nodiscard]] static std::string
+    MakeExpressionModule(std::string_view type, std::string_view expression_ir, std::string_view variable_name);
+
+private:
+    explicit OrcJit(std::unique_ptr<llvm::orc::LLJIT> jit);
+
+private:
+    std::unique_ptr<llvm::orc::LLJIT> jit_;
+};
+
+}  // namespace kaleidoscope
@@ -0,0 +1,144 @@
+#include "kaleidoscope/jit/orc_jit.hpp"
+
+#include "fmt/format.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/ExecutionEngine/Orc/LLJIT.h"
+#include "llvm/IR/Verifier.h"
+#include "llvm/IRReader/IRReader.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace kaleidoscope
+{
+
+namespace
+{
+
+[[nodiscard]] llvm::StringRef ToStringRef(std::string_view s) noexcept
+{
+    return {s.data(), s.size()};
+}
+
+[[nodiscard]] std::string ToString(llvm::Error error)
+{
+    return llvm::toString(std::move(error));
+}
+
+}  // namespace
+
+class JitModule::Resources
+{
+public:
+    explicit Resources(llvm::orc::ResourceTrackerSP tracker) : tracker_(std::move(tracker)) {}
+
+    ~Resources() { llvm::consumeError(tracker_->remove()); }
+
+    Resources(const Resources&) = delete;
+    Resources& operator=(const Resources&) = delete;
+
+    [[nodiscard]] const llvm::orc::ResourceTrackerSP& GetTracker() const noexcept { return tracker_; }
+
+private:
+    llvm::orc::ResourceTrackerSP tracker_;
+};
+
+JitModule::JitModule(std::unique_ptr<Resources> resources, uintptr_t function_address)
+    : resources_(std::move(resources)),
+      function_address_(function_address)
+{
+}
+
+JitModule::JitModule(JitModule&&) noexcept = default;
+JitModule& JitModule::operator=(JitModule&&) noexcept = default;
+JitModule::~JitModule() = default;
+
+OrcJit::OrcJit(std::unique_ptr<llvm::orc::LLJIT> jit) : jit_(std::move(jit)) {}
+
+OrcJit::OrcJit(OrcJit&&) noexcept = default;
+OrcJit& OrcJit::operator=(OrcJit&&) noexcept = default;
+OrcJit::~OrcJit() = default;
+
+std::expected<OrcJit, std::string> OrcJit::Create(OrcJitOptions options)
+{
+    [[maybe_unused]] static const bool initialized = []
+    {
+        llvm::InitializeNativeTarget();
+        llvm::InitializeNativeTargetAsmPrinter();
+        return true;
+    }();
+
+    auto target = llvm::orc::JITTargetMachineBuilder::detectHost();
+    if (!target) return std::unexpected(ToString(target.takeError()));
+
+#if LLVM_VERSION_MAJOR >= 18
+    target->setCodeGenOptLevel(options.optimize ? llvm::CodeGenOptLevel::Default : llvm::CodeGenOptLevel::None);
+#else
+    target->setCodeGenOptLevel(options.optimize ? llvm::CodeGenOpt::Default : llvm::CodeGenOpt::None);
+#endif
+
+    auto jit = llvm::orc::LLJITBuilder().setJITTargetMachineBuilder(std::move(*target)).create();
+    if (!jit) return std::unexpected(ToString(jit.takeError()));
+
+    return OrcJit(std::move(*jit));
+}
+
+std::expected<JitModule, std::string> OrcJit::Compile(std::string_view module_ir, std::string_view function_name)
+{
+    auto context = std::make_unique<llvm::LLVMContext>();
+#if LLVM_VERSION_MAJOR < 15
+    // CodeGen_LLVM_IR writes opaque pointers (ptr) which are the default since LLVM 15
+    context->enableOpaquePointers();
+#endif
+
+    llvm::SMDiagnostic diagnostic;
+    std::unique_ptr<llvm::Module> module =
+        llvm::parseIR(llvm::MemoryBufferRef(ToStringRef(module_ir), "module"), diagnostic, *context);
+    if (!module)
+    {
+        std::string message;
+        llvm::raw_string_ostream stream(message);
+        diagnostic.print("module", stream);
+        return std::unexpected(std::move(stream.str()));
+    }
+
+    // Invalid IR is not diagnosed by code generation and may crash it
+    {
+        std::string message;
+        llvm::raw_string_ostream stream(message);
+        if (llvm::verifyModule(*module, &stream)) return std::unexpected(std::move(stream.str()));
+    }
+
+    auto resources = std::make_unique<JitModule::Resources>(jit_->getMainJITDylib().createResourceTracker());
+    if (auto error = jit_->addIRModule(
+            resources->GetTracker(),
+            llvm::orc::ThreadSafeModule(std::move(module), std::move(context))))
+    {
+        return std::unexpected(ToString(std::move(error)));
+    }
+
+    // Code is generated here, on the first lookup
+    auto symbol = jit_->lookup(ToStringRef(function_name));
+    if (!symbol) return std::unexpected(ToString(symbol.takeError()));
+
+#if LLVM_VERSION_MAJOR >= 15
+    const auto address = static_cast<uintptr_t>(symbol->getValue());
+#else
+    const auto address = static_cast<uintptr_t>(symbol->getAddress());
+#endif
+
+    return JitModule(std::move(resources), address);
+}
+
+std::string
+OrcJit::MakeExpressionModule(std::string_view type, std::string_view expression_ir, std::string_view variable_name)
+{
+    return fmt::format(
+        "define {0} @{1}() {{\n{2}ret {0} {3}\n}}\n",
+        type,
+        kExpressionFunctionName,
+        expression_ir,
+        variable_name);
+}
+
+}  // namespace kaleidoscope
@@ -0,0 +1,207 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <memory_resource>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+#include "lexer.hpp"
+#include "lookahead_lexer.hpp"
+
+namespace kaleidoscope
+{
+
+// Position in the token stream of BlockLookaheadLexer
+class LookaheadCheckpoint
+{
+public:
+    [[nodiscard]] constexpr bool operator==(const LookaheadCheckpoint&) const noexcept = default;
+
+    size_t token_index = 0;
+};
+
+// Same interface as LookaheadLexer (see TokenLookahead), but tokens are lexed block_size at a time into a ring
+// whose size is a power of two, so the lexer is entered once per block and slots are found with a mask.
+// Checkpoints keep their tokens in the ring (it grows when needed), so the parser can go back
+// any distance without lexing the same tokens again. Buffers are allocated from the given memory resource.
+// Peek returns copies: the ring may be reallocated by Take when a checkpoint makes it grow.
+template <size_t horizon_size, typename LexerType = Lexer, size_t block_size = 64>
+    requires(horizon_size >= 2 && block_size >= 1)
+class BlockLookaheadLexer
+{
+public:
+    using Token = typename LexerType::Token;
+    using Result = typename LexerType::Result;
+
+    static constexpr bool kDecodesLiteralValues = LexerType::kDecodesLiteralValues;
+    static constexpr bool kInternsIdentifiers = LexerType::kInternsIdentifiers;
+
+    constexpr explicit BlockLookaheadLexer(
+        LexerType& lexer,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : lexer_(&lexer),
+          tokens_(std::bit_ceil(horizon_size + block_size), resource),
+          values_(MakeRing<kDecodesLiteralValues, LiteralValue>(tokens_.size(), resource)),
+          symbol_ids_(MakeRing<kInternsIdentifiers, SymbolId>(tokens_.size(), resource)),
+          checkpoints_(resource)
+    {
+        Refill();
+    }
+
+    [[nodiscard]] constexpr Result Peek(size_t index = 0) const noexcept
+    {
+        assert(index < horizon_size);
+        return tokens_[GetSlot(next_ + index)];
+    }
+
+    [[nodiscard]] constexpr Result Take() noexcept
+    {
+        Result result = tokens_[GetSlot(next_)];
+        ++next_;
+        Refill();
+        return result;
+    }
+
+    [[nodiscard]] constexpr std::string_view GetTokenView(const Token& lexer_token) const
+    {
+        return lexer_->GetTokenView(lexer_token);
+    }
+
+    // Value of the numeric literal returned by Peek(index)
+    [[nodiscard]] constexpr LiteralValue PeekLiteralValue(size_t index = 0) const noexcept
+        requires(kDecodesLiteralValues)
+    {
+        assert(index < horizon_size);
+        return values_[GetSlot(next_ + index)];
+    }
+
+    // Symbol of the identifier returned by Peek(index)
+    [[nodiscard]] constexpr SymbolId PeekSymbolId(size_t index = 0) const noexcept
+        requires(kInternsIdentifiers)
+    {
+        assert(index < horizon_size);
+        return symbol_ids_[GetSlot(next_ + index)];
+    }
+
+    // Remembers the current position. Tokens after it stay in memory until the checkpoint is released.
+    [[nodiscard]] constexpr LookaheadCheckpoint Save()
+    {
+        checkpoints_.push_back(next_);
+        return {.token_index = next_};
+    }
+
+    // Goes back (or forward) to the position of a checkpoint that has not been released yet
+    constexpr void Rewind(const LookaheadCheckpoint& checkpoint) noexcept
+    {
+        assert(std::ranges::find(checkpoints_, checkpoint.token_index) != checkpoints_.end());
+        next_ = checkpoint.token_index;
+    }
+
+    // Checkpoints are released in the reverse order of saving
+    constexpr void Release(const LookaheadCheckpoint& checkpoint) noexcept
+    {
+        assert(!checkpoints_.empty() && checkpoints_.back() == checkpoint.token_index);
+        checkpoints_.pop_back();
+    }
+
+    // Number of tokens taken so far
+    [[nodiscard]] constexpr size_t GetTokenIndex() const noexcept { return next_; }
+
+private:
+    // Ring of per-token data that is only kept for some lexers
+    template <bool enabled, typename T>
+    using OptionalRing = std::conditional_t<enabled, std::pmr::vector<T>, std::monostate>;
+
+    template <bool enabled, typename T>
+    [[nodiscard]] static constexpr OptionalRing<enabled, T> MakeRing(size_t size, std::pmr::memory_resource* resource)
+    {
+        if constexpr (enabled)
+        {
+            return std::pmr::vector<T>(size, resource);
+        }
+        else
+        {
+            return std::monostate{};
+        }
+    }
+
+    [[nodiscard]] constexpr size_t GetSlot(size_t token_index) const noexcept
+    {
+        return token_index & (tokens_.size() - 1);
+    }
+
+    // Makes sure the whole horizon is lexed
+    constexpr void Refill()
+    {
+        while (lexed_ - next_ < horizon_size) LexBlock();
+    }
+
+    // Lexes the next block of tokens. Grows the ring if checkpoints still need the tokens it would overwrite.
+    constexpr void LexBlock()
+    {
+        size_t first_kept = next_;
+        for (const size_t checkpoint : checkpoints_) first_kept = std::min(first_kept, checkpoint);
+
+        if (lexed_ + block_size - first_kept > tokens_.size())
+        {
+            Grow(first_kept, std::bit_ceil(lexed_ + block_size - first_kept));
+        }
+
+        for (const size_t end = lexed_ + block_size; lexed_ != end; ++lexed_)
+        {
+            const size_t slot = GetSlot(lexed_);
+            tokens_[slot] = lexer_->GetToken();
+            if constexpr (kDecodesLiteralValues)
+            {
+                if (tokens_[slot].has_value() && IsNumericLiteral(tokens_[slot]->GetType()))
+                {
+                    values_[slot] = lexer_->GetLiteralValue();
+                }
+            }
+
+            if constexpr (kInternsIdentifiers)
+            {
+                if (tokens_[slot].has_value() && tokens_[slot]->GetType() == TokenType::Identifier)
+                {
+                    symbol_ids_[slot] = lexer_->GetSymbolId();
+                }
+            }
+        }
+    }
+
+    constexpr void Grow(size_t first_kept, size_t new_size)
+    {
+        if constexpr (kDecodesLiteralValues) GrowRing(values_, first_kept, new_size);
+        if constexpr (kInternsIdentifiers) GrowRing(symbol_ids_, first_kept, new_size);
+        GrowRing(tokens_, first_kept, new_size);
+    }
+
+    // Moves the kept entries of a ring to a new one. Must be called before tokens_ grows.
+    template <typename T>
+    constexpr void GrowRing(std::pmr::vector<T>& ring, size_t first_kept, size_t new_size) const
+    {
+        std::pmr::vector<T> grown(new_size, ring.get_allocator());
+        for (size_t i = first_kept; i != lexed_; ++i) grown[i & (new_size - 1)] = ring[GetSlot(i)];
+        ring = std::move(grown);
+    }
+
+private:
+    LexerType* lexer_ = nullptr;
+    std::pmr::vector<Result> tokens_;
+    [[no_unique_address]] OptionalRing<kDecodesLiteralValues, LiteralValue> values_;
+    [[no_unique_address]] OptionalRing<kInternsIdentifiers, SymbolId> symbol_ids_;
+
+    // Token indices since the beginning of the stream
+    size_t next_ = 0;
+    size_t lexed_ = 0;
+
+    // Token indices of checkpoints that were not released
+    std::pmr::vector<size_t> checkpoints_;
+};
+
+static_assert(TokenLookahead<BlockLookaheadLexer<2>>);
+
+}  // namespace kaleidoscope
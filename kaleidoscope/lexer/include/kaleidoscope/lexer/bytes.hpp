@@ -0,0 +1,31 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace kaleidoscope
+{
+
+// Loads 8 bytes so that the first character ends up in the lowest byte on any platform
+[[nodiscard]] constexpr uint64_t LoadEightChars(const char* chars) noexcept
+{
+    uint64_t word = 0;
+    if consteval
+    {
+        for (size_t i = 0; i != 8; ++i)
+        {
+            word |= uint64_t{std::bit_cast<uint8_t>(chars[i])} << (i * 8);
+        }
+    }
+    else
+    {
+        std::memcpy(&word, chars, sizeof(word));
+        if constexpr (std::endian::native == std::endian::big) word = std::byteswap(word);
+    }
+
+    return word;
+}
+
+}  // namespace kaleidoscope
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "lexer_data.hpp"
+
+#if defined(__x86_64__)
+#define KALEIDOSCOPE_LEXER_X86_SIMD 1
+#else
+#define KALEIDOSCOPE_LEXER_X86_SIMD 0
+#endif
+
+namespace kaleidoscope
+{
+
+// Character classes the lexer skips over in potentially long runs
+enum class CharClass : uint8_t
+{
+    Space,
+    IdentifierTail,
+
+    // Everything up to the delimiter that ends or interrupts a comment or a string literal
+    LineCommentBody,
+    BlockCommentBody,
+    StringLiteralBody,
+};
+
+[[nodiscard]] constexpr const ass::FixedBitset<256>& GetCharClassBitset(CharClass char_class) noexcept
+{
+    switch (char_class)
+    {
+    case CharClass::Space:
+        return kSpaceChars;
+    case CharClass::IdentifierTail:
+        return kIdentifierTailChars;
+    case CharClass::LineCommentBody:
+        return kLineCommentBodyChars;
+    case CharClass::BlockCommentBody:
+        return kBlockCommentBodyChars;
+    case CharClass::StringLiteralBody:
+        return kStringLiteralBodyChars;
+    }
+
+    assert(false);
+    return kSpaceChars;
+}
+
+// Returns the position of the first character at or after pos that does not belong to the class.
+// Returns text.size() if all remaining characters belong to the class.
+[[nodiscard]] constexpr size_t ScanCharClassScalar(std::string_view text, size_t pos, CharClass char_class) noexcept
+{
+    const auto& bitset = GetCharClassBitset(char_class);
+    while (pos < text.size() && bitset.Get(std::bit_cast<uint8_t>(text[pos]))) ++pos;
+    return pos;
+}
+
+#if KALEIDOSCOPE_LEXER_X86_SIMD
+// Classify 16 and 32 bytes per step respectively. Both have the same contract as ScanCharClassScalar.
+[[nodiscard]] size_t ScanCharClassSSE2(std::string_view text, size_t pos, CharClass char_class) noexcept;
+[[nodiscard]] size_t ScanCharClassAVX2(std::string_view text, size_t pos, CharClass char_class) noexcept;
+[[nodiscard]] bool IsAVX2Supported() noexcept;
+#endif
+
+// Picks the widest vector implementation supported by the CPU (scalar on non-x86 targets)
+[[nodiscard]] size_t ScanCharClassVectorized(std::string_view text, size_t pos, CharClass char_class) noexcept;
+
+[[nodiscard]] constexpr size_t ScanCharClass(std::string_view text, size_t pos, CharClass char_class) noexcept
+{
+    if consteval
+    {
+        return ScanCharClassScalar(text, pos, char_class);
+    }
+    else
+    {
+        // Most runs are short (a single space, a short name), so check a few characters inline
+        // and only pay for the out-of-line vector call when the run keeps going.
+        constexpr size_t kInlineChars = 8;
+        const size_t inline_end = std::min(text.size(), pos + kInlineChars);
+        const auto& bitset = GetCharClassBitset(char_class);
+        while (pos != inline_end && bitset.Get(std::bit_cast<uint8_t>(text[pos]))) ++pos;
+
+        if (pos != inline_end || pos == text.size())
+        {
+            return pos;
+        }
+
+        return ScanCharClassVectorized(text, pos, char_class);
+    }
+}
+
+}  // namespace kaleidoscope
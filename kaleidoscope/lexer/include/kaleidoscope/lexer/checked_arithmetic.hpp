@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <optional>
+
+namespace kaleidoscope
+{
+
+// Integer arithmetic that returns nullopt instead of overflowing. Written without compiler builtins,
+// so that it builds with any compiler.
+
+// value * factor + addend
+[[nodiscard]] constexpr std::optional<uint64_t>
+CheckedMultiplyAdd(uint64_t value, uint64_t factor, uint64_t addend) noexcept
+{
+    if (factor != 0 && value > (std::numeric_limits<uint64_t>::max() - addend) / factor) return std::nullopt;
+    return value * factor + addend;
+}
+
+[[nodiscard]] constexpr std::optional<int64_t> CheckedAdd(int64_t a, int64_t b) noexcept
+{
+    constexpr int64_t kMin = std::numeric_limits<int64_t>::min();
+    constexpr int64_t kMax = std::numeric_limits<int64_t>::max();
+    if ((b > 0 && a > kMax - b) || (b < 0 && a < kMin - b)) return std::nullopt;
+    return a + b;
+}
+
+[[nodiscard]] constexpr std::optional<int64_t> CheckedSubtract(int64_t a, int64_t b) noexcept
+{
+    constexpr int64_t kMin = std::numeric_limits<int64_t>::min();
+    constexpr int64_t kMax = std::numeric_limits<int64_t>::max();
+    if ((b < 0 && a > kMax + b) || (b > 0 && a < kMin + b)) return std::nullopt;
+    return a - b;
+}
+
+[[nodiscard]] constexpr std::optional<int64_t> CheckedMultiply(int64_t a, int64_t b) noexcept
+{
+    constexpr int64_t kMin = std::numeric_limits<int64_t>::min();
+    constexpr int64_t kMax = std::numeric_limits<int64_t>::max();
+
+    // Limits are divided by a positive operand or by a negative one for a positive limit,
+    // so the divisions themselves can't overflow
+    if (a > 0)
+    {
+        if (b > 0 ? a > kMax / b : b < kMin / a) return std::nullopt;
+    }
+    else if (b > 0)
+    {
+        if (a < kMin / b) return std::nullopt;
+    }
+    else if (a != 0 && b < kMax / a)
+    {
+        return std::nullopt;
+    }
+
+    return a * b;
+}
+
+}  // namespace kaleidoscope
@@ -1,100 +1,278 @@
 #pragma once
 
+#include <algorithm>
 #include <cassert>
 #include <expected>
 #include <string_view>
+#include <type_traits>
+#include <variant>
 
+#include "char_class_scan.hpp"
 #include "lexer_data.hpp"
 #include "lexer_enums.hpp"
+#include "lexer_token.hpp"
+#include "literal_decoder.hpp"
+#include "number_literal_dfa.hpp"
+#include "source_index.hpp"
+#include "symbol_table.hpp"
 
 namespace kaleidoscope
 {
 
-class LexerToken
+using LexerResult = std::expected<LexerToken, LexerError>;
+using LargeLexerResult = std::expected<LargeLexerToken, LargeLexerError>;
+
+// Token representation used by the default lexer: 8-byte tokens and errors.
+// Sources must not exceed 4 GiB. Tokens longer than 16 MiB are reported as TokenTooLong errors.
+struct CompactLexerTraits
 {
-public:
-    [[nodiscard]] constexpr bool operator==(const LexerToken&) const noexcept = default;
+    using Token = LexerToken;
+    using Error = LexerError;
+    static constexpr NumberLiteralEngine kNumberLiteralEngine = NumberLiteralEngine::Dfa;
+    static constexpr bool kDecodeLiteralValues = false;
+    static constexpr bool kEmitTrivia = true;
+    static constexpr bool kTrackLineColumn = false;
+    static constexpr LexerErrorMode kErrorMode = LexerErrorMode::Report;
+    using SymbolTableType = void;
+};
 
-    TokenType type = TokenType::EndOfFile;
-    size_t begin = 0;
-    size_t end = 0;
+// Token representation without limits on source size and token length
+struct LargeFileLexerTraits
+{
+    using Token = LargeLexerToken;
+    using Error = LargeLexerError;
+    static constexpr NumberLiteralEngine kNumberLiteralEngine = NumberLiteralEngine::Dfa;
+    static constexpr bool kDecodeLiteralValues = false;
+    static constexpr bool kEmitTrivia = true;
+    static constexpr bool kTrackLineColumn = false;
+    static constexpr LexerErrorMode kErrorMode = LexerErrorMode::Report;
+    using SymbolTableType = void;
 };
 
-class LexerError
+// Compact tokens plus values of numeric literals. Literals that do not fit into their type
+// are reported as IntegerLiteralOverflow and FloatLiteralOutOfRange errors.
+struct DecodingLexerTraits : CompactLexerTraits
 {
-public:
-    [[nodiscard]] constexpr bool operator==(const LexerError&) const noexcept = default;
+    static constexpr bool kDecodeLiteralValues = true;
+};
 
-    LexerErrorType type;
-    size_t begin;
-    size_t end;
+// Same as Base but with another number literal engine. Used to compare the engines against each other.
+template <typename Base, NumberLiteralEngine engine>
+struct WithNumberLiteralEngine : Base
+{
+    static constexpr NumberLiteralEngine kNumberLiteralEngine = engine;
 };
 
-using LexerResult = std::expected<LexerToken, LexerError>;
+// Same as Base but comments are skipped like spaces instead of being reported as tokens.
+// Unterminated block comments are still reported as errors.
+template <typename Base, bool emit_trivia>
+struct WithTrivia : Base
+{
+    static constexpr bool kEmitTrivia = emit_trivia;
+};
 
-class Lexer
+// Same as Base but the lexer also tracks line and column of every result it returns
+template <typename Base, bool track_line_column>
+struct WithLineColumnTracking : Base
+{
+    static constexpr bool kTrackLineColumn = track_line_column;
+};
+
+template <typename Base, LexerErrorMode error_mode>
+struct WithErrorMode : Base
+{
+    static constexpr LexerErrorMode kErrorMode = error_mode;
+};
+
+// Same as Base but identifiers are interned into a table of the specified type
+// (SymbolTable or ConcurrentSymbolTable) as they are lexed
+template <typename Base, typename SymbolTableType_>
+struct WithSymbolTable : Base
+{
+    using SymbolTableType = SymbolTableType_;
+};
+
+// Options selected by Traits:
+//   kNumberLiteralEngine - see NumberLiteralEngine
+//   kDecodeLiteralValues - decode values of numeric literals (GetLiteralValue)
+//   kEmitTrivia          - report comments as tokens or skip them
+//   kTrackLineColumn     - maintain line and column of each result (GetLineColumn)
+//   kErrorMode           - see LexerErrorMode
+//   SymbolTableType      - table to intern identifiers into (GetSymbolId) or void
+// Disabled options cost nothing: their code is compiled out and their state takes no space.
+template <typename Traits>
+class BasicLexer
 {
 public:
-    constexpr explicit Lexer(std::string_view text) noexcept : text_(text) {}
+    using Token = typename Traits::Token;
+    using Error = typename Traits::Error;
+    using Result = std::expected<Token, Error>;
+
+    static constexpr bool kDecodesLiteralValues = Traits::kDecodeLiteralValues;
+    static constexpr bool kEmitsTrivia = Traits::kEmitTrivia;
+    static constexpr bool kTracksLineColumn = Traits::kTrackLineColumn;
+    static constexpr bool kInternsIdentifiers = !std::is_void_v<typename Traits::SymbolTableType>;
 
-    [[nodiscard]] constexpr LexerResult GetToken() noexcept
+    using SymbolTableType =
+        std::conditional_t<kInternsIdentifiers, typename Traits::SymbolTableType, std::monostate>;
+
+    constexpr explicit BasicLexer(std::string_view text) noexcept : BasicLexer(text, 0) {}
+
+    constexpr BasicLexer(std::string_view text, SymbolTableType& symbols, size_t start_pos = 0) noexcept
+        requires(kInternsIdentifiers)
+        : BasicLexer(text, start_pos)
     {
-        SkipSpaces();
-        if (HasChars())
+        symbols_ = &symbols;
+    }
+
+    // Starts lexing at the specified offset. Token offsets are still relative to the beginning of text.
+    constexpr BasicLexer(std::string_view text, size_t start_pos) noexcept : text_(text), pos_(start_pos)
+    {
+        assert(text.size() <= Token::kMaxOffset);
+        assert(start_pos <= text.size());
+
+        if constexpr (kTracksLineColumn)
+        {
+            CountLines(0, start_pos);
+        }
+    }
+
+    [[nodiscard]] constexpr Result GetToken() noexcept
+    {
+        Result result = ReadNext();
+        if constexpr (Traits::kErrorMode == LexerErrorMode::FastFail)
+        {
+            if (!result.has_value()) pos_ = text_.size();
+        }
+
+        return result;
+    }
+
+    [[nodiscard]] constexpr std::string_view GetTokenView(const Token& lexer_token) const
+    {
+        [[unlikely]] if (lexer_token.GetType() == TokenType::EndOfFile)
+        {
+            return "";
+        }
+
+        return text_.substr(lexer_token.GetBegin(), lexer_token.GetLength());
+    }
+
+    // Offset of the first character that has not been consumed yet
+    [[nodiscard]] constexpr size_t GetPosition() const noexcept { return pos_; }
+
+    // Value of the last numeric literal returned by GetToken
+    [[nodiscard]] constexpr const LiteralValue& GetLiteralValue() const noexcept
+        requires(kDecodesLiteralValues)
+    {
+        return literal_value_;
+    }
+
+    // Symbol of the last identifier returned by GetToken
+    [[nodiscard]] constexpr SymbolId GetSymbolId() const noexcept
+        requires(kInternsIdentifiers)
+    {
+        return symbol_id_;
+    }
+
+    // Line and column where the last result returned by GetToken begins
+    [[nodiscard]] constexpr LineColumn GetLineColumn() const noexcept
+        requires(kTracksLineColumn)
+    {
+        return lines_.result_line_column;
+    }
+
+    // Results with the length limits of Token and Error applied (also used by BasicStreamingLexer)
+    [[nodiscard]] static constexpr Result MakeToken(TokenType type, size_t begin, size_t end) noexcept
+    {
+        [[unlikely]] if (end - begin > Token::kMaxLength)
+        {
+            return MakeError(LexerErrorType::TokenTooLong, begin, end);
+        }
+
+        return Token(type, begin, end);
+    }
+
+    [[nodiscard]] static constexpr Result MakeError(LexerErrorType type, size_t begin, size_t end) noexcept
+    {
+        // Errors only point at the problem, so ranges that do not fit are truncated
+        const size_t length = std::min(end - begin, Error::kMaxLength);
+        return std::unexpected(Error(type, begin, begin + length));
+    }
+
+private:
+    [[nodiscard]] constexpr Result ReadNext() noexcept
+    {
+        while (true)
         {
+            SkipSpaces();
+
+            if constexpr (kTracksLineColumn)
+            {
+                lines_.result_line_column = {
+                    .line = lines_.line,
+                    .column = pos_ - lines_.line_begin + 1,
+                };
+            }
+
+            if (!HasChars())
+            {
+                return MakeToken(TokenType::EndOfFile, pos_, pos_);
+            }
+
             const char c = text_[pos_];
 
             if (IsValidIdentifierHeadChar(c)) return ReadIdentifier();
             if (IsDigit(c) || c == '.') return ReadNumberLiteral();
             if (c == '"') return ReadStringLiteral();
-            if (MatchesNext("//")) return ReadComment();
-            if (MatchesNext("/*")) return ReadBlockComment();
+
+            if (MatchesNext("//"))
+            {
+                if constexpr (kEmitsTrivia)
+                {
+                    return ReadComment();
+                }
+
+                pos_ = ScanCharClass(text_, pos_ + 2, CharClass::LineCommentBody);
+                continue;
+            }
+
+            if (MatchesNext("/*"))
+            {
+                if constexpr (kEmitsTrivia)
+                {
+                    return ReadBlockComment();
+                }
+
+                const size_t begin = pos_;
+                if (!SkipBlockComment())
+                {
+                    return MakeError(LexerErrorType::UnterminatedBlockComment, begin, pos_);
+                }
+
+                continue;
+            }
 
             if (const TokenType* op_type = kOperatorSymbolLookup.Find(c))
             {
                 const auto p = pos_++;
-                return LexerToken{
-                    .type = *op_type,
-                    .begin = p,
-                    .end = p + 1,
-                };
+                return MakeToken(*op_type, p, p + 1);
             }
 
             return ReadAsError(pos_, LexerErrorType::UnexpectedSymbol);
         }
-        else
-        {
-            return LexerToken{
-                .type = TokenType::EndOfFile,
-                .begin = pos_,
-                .end = pos_,
-            };
-        }
     }
 
-    [[nodiscard]] constexpr std::string_view GetTokenView(const LexerToken& lexer_token) const
-    {
-        [[unlikely]] if (lexer_token.type == TokenType::EndOfFile)
-        {
-            return "";
-        }
-
-        const char* begin = &text_[lexer_token.begin];  // NOLINT
-        const char* end = &text_[lexer_token.end];      // NOLINT
-        return std::string_view(begin, end);
-    }
-
-private:
     // Returns true if the stream starts with the specified sequence at the current position
     [[nodiscard]] constexpr bool MatchesNext(std::string_view expected) const
     {
         return text_.substr(pos_).starts_with(expected);
     }
 
-    [[nodiscard]] constexpr LexerResult ReadAsError(size_t begin, LexerErrorType error_type)
+    [[nodiscard]] constexpr Result ReadAsError(size_t begin, LexerErrorType error_type)
     {
         while (HasChars() && !IsSpaceChar(text_[pos_])) ++pos_;
-        return std::unexpected(LexerError{.type = error_type, .begin = begin, .end = pos_});
+        return MakeError(error_type, begin, pos_);
     }
 
     [[nodiscard]] static constexpr bool OneOf(char c, const ass::FixedBitset<256>& b)
@@ -108,57 +286,58 @@ private:
     [[nodiscard]] static constexpr bool IsValidIdentifierTailChar(char c) { return OneOf(c, kIdentifierTailChars); }
     [[nodiscard]] static constexpr bool IsSpaceChar(char c) { return OneOf(c, kSpaceChars); }
 
-    [[nodiscard]] constexpr LexerResult ReadComment() noexcept
+    [[nodiscard]] constexpr Result ReadComment() noexcept
     {
         size_t begin = pos_;
-        pos_ += 2;
-
-        while (HasChars() && text_[pos_] != '\n')
-        {
-            ++pos_;
-        }
+        pos_ = ScanCharClass(text_, pos_ + 2, CharClass::LineCommentBody);
 
         size_t end = pos_;
         SkipSpaces();
 
-        return LexerToken{
-            .type = TokenType::Comment,
-            .begin = begin,
-            .end = end,
-        };
+        return MakeToken(TokenType::Comment, begin, end);
     }
 
-    [[nodiscard]] constexpr LexerResult ReadBlockComment() noexcept
+    // Moves past the end of the block comment that starts at the current position.
+    // Returns false if the comment is not terminated, the position is at the end of text then.
+    [[nodiscard]] constexpr bool SkipBlockComment() noexcept
     {
         const size_t begin = std::exchange(pos_, pos_ + 2);
 
-        while (HasChars() && !MatchesNext("*/"))
+        // Jump from one '*' to another until it is followed by '/'
+        bool terminated = false;
+        while (!terminated)
         {
+            pos_ = ScanCharClass(text_, pos_, CharClass::BlockCommentBody);
+            if (!HasChars()) break;
+
             ++pos_;
+            terminated = HasChars() && text_[pos_] == '/';
         }
 
-        if (!(HasChars() && MatchesNext("*/")))
+        pos_ += terminated;
+
+        if constexpr (kTracksLineColumn)
         {
-            return std::unexpected(
-                LexerError{
-                    .type = LexerErrorType::UnterminatedBlockComment,
-                    .begin = begin,
-                    .end = pos_,
-                });
+            CountLines(begin, pos_);
         }
 
-        pos_ += 2;
+        return terminated;
+    }
+
+    [[nodiscard]] constexpr Result ReadBlockComment() noexcept
+    {
+        const size_t begin = pos_;
+        if (!SkipBlockComment())
+        {
+            return MakeError(LexerErrorType::UnterminatedBlockComment, begin, pos_);
+        }
 
         const size_t end = pos_;
         SkipSpaces();
-        return LexerToken{
-            .type = TokenType::BlockComment,
-            .begin = begin,
-            .end = end,
-        };
+        return MakeToken(TokenType::BlockComment, begin, end);
     }
 
-    [[nodiscard]] constexpr LexerResult ReadFloatingPointLiteral() noexcept
+    [[nodiscard]] constexpr Result ReadFloatingPointLiteral() noexcept
     {
         size_t begin = pos_;
         std::optional<size_t> dot;
@@ -217,14 +396,10 @@ private:
             }
         }
 
-        return LexerToken{
-            .type = TokenType::FloatLiteral,
-            .begin = begin,
-            .end = pos_,
-        };
+        return MakeToken(TokenType::FloatLiteral, begin, pos_);
     }
 
-    [[nodiscard]] constexpr LexerResult ReadDecimalNumber() noexcept
+    [[nodiscard]] constexpr Result ReadDecimalNumber() noexcept
     {
         size_t begin = pos_;
 
@@ -248,14 +423,10 @@ private:
             }
         }
 
-        return LexerToken{
-            .type = TokenType::DecimalLiteral,
-            .begin = begin,
-            .end = pos_,
-        };
+        return MakeToken(TokenType::DecimalLiteral, begin, pos_);
     }
 
-    [[nodiscard]] constexpr LexerResult ReadHexadecimalLiteral() noexcept
+    [[nodiscard]] constexpr Result ReadHexadecimalLiteral() noexcept
     {
         size_t begin = pos_;
 
@@ -277,14 +448,10 @@ private:
             }
         }
 
-        return LexerToken{
-            .type = TokenType::HexadecimalLiteral,
-            .begin = begin,
-            .end = pos_,
-        };
+        return MakeToken(TokenType::HexadecimalLiteral, begin, pos_);
     }
 
-    [[nodiscard]] constexpr LexerResult ReadBinaryLiteral() noexcept
+    [[nodiscard]] constexpr Result ReadBinaryLiteral() noexcept
     {
         size_t begin = pos_;
         pos_ += 2;
@@ -301,14 +468,10 @@ private:
             }
         }
 
-        return LexerToken{
-            .type = TokenType::BinaryLiteral,
-            .begin = begin,
-            .end = pos_,
-        };
+        return MakeToken(TokenType::BinaryLiteral, begin, pos_);
     }
 
-    [[nodiscard]] constexpr LexerResult ReadOctalNumber() noexcept
+    [[nodiscard]] constexpr Result ReadOctalNumber() noexcept
     {
         size_t begin = pos_;
 
@@ -323,14 +486,68 @@ private:
             }
         }
 
-        return LexerToken{
-            .type = TokenType::OctalLiteral,
-            .begin = begin,
-            .end = pos_,
-        };
+        return MakeToken(TokenType::OctalLiteral, begin, pos_);
+    }
+
+    [[nodiscard]] constexpr Result ReadNumberLiteral() noexcept
+    {
+        const Result result = [&]
+        {
+            if constexpr (Traits::kNumberLiteralEngine == NumberLiteralEngine::Dfa)
+            {
+                return ReadNumberLiteralDfa();
+            }
+            else
+            {
+                return ReadNumberLiteralHandWritten();
+            }
+        }();
+
+        if constexpr (kDecodesLiteralValues)
+        {
+            // Decode right away while the literal bytes are still in cache
+            if (result.has_value())
+            {
+                auto value = DecodeNumericLiteral(result->GetType(), GetTokenView(*result));
+                if (!value.has_value())
+                {
+                    return MakeError(value.error(), result->GetBegin(), result->GetEnd());
+                }
+
+                literal_value_ = *value;
+            }
+        }
+
+        return result;
+    }
+
+    [[nodiscard]] constexpr Result ReadNumberLiteralDfa() noexcept
+    {
+        assert(HasChars());
+
+        const size_t begin = pos_;
+        NumberDfaState state = NumberDfaState::Start;
+        for (; HasChars(); ++pos_)
+        {
+            state = kNumberLiteralDfa.GetNextState(state, text_[pos_]);
+            if (IsFinalNumberDfaState(state)) break;
+        }
+
+        if (!IsFinalNumberDfaState(state))
+        {
+            state = kNumberLiteralDfa.GetEndState(state);
+        }
+
+        const auto outcome = GetNumberDfaOutcome(state);
+        if (outcome.has_value())
+        {
+            return MakeToken(*outcome, begin, pos_);
+        }
+
+        return ReadAsError(begin, outcome.error());
     }
 
-    [[nodiscard]] constexpr LexerResult ReadNumberLiteral() noexcept
+    [[nodiscard]] constexpr Result ReadNumberLiteralHandWritten() noexcept
     {
         assert(HasChars());
 
@@ -369,72 +586,54 @@ private:
         return ReadFloatingPointLiteral();
     }
 
-    [[nodiscard]] constexpr LexerToken ReadIdentifier() noexcept
+    [[nodiscard]] constexpr Result ReadIdentifier() noexcept
     {
         // Assumes the current pos not pointing at digit
         assert(HasChars() && IsValidIdentifierHeadChar(text_[pos_]));
 
-        LexerToken token{
-            .type = TokenType::Identifier,
-            .begin = pos_,
-        };
-        ++pos_;
-        while (HasChars() && IsValidIdentifierTailChar(text_[pos_]))
+        const size_t begin = pos_;
+        pos_ = ScanCharClass(text_, pos_ + 1, CharClass::IdentifierTail);
+
+        const std::string_view name = text_.substr(begin, pos_ - begin);
+        TokenType type = TokenType::Identifier;
+        if (const auto* pType = kKeywordLookup.Find(name))
         {
-            ++pos_;
+            type = *pType;
         }
-
-        token.end = pos_;
-
-        const auto sub = text_.substr(token.begin, token.end - token.begin);
-        if (const auto* pType = kKeywordLookup.Find(sub))
+        else if constexpr (kInternsIdentifiers)
         {
-            token.type = *pType;
+            // Hashed right after the scan while the name is still in L1
+            assert(symbols_ != nullptr);
+            symbol_id_ = symbols_->Intern(name, HashIdentifier(name));
         }
 
-        return token;
+        return MakeToken(type, begin, pos_);
     }
 
-    [[nodiscard]] constexpr LexerResult ReadStringLiteral() noexcept
+    [[nodiscard]] constexpr Result ReadStringLiteral() noexcept
     {
-        size_t begin = pos_;
+        size_t begin = pos_++;
 
         while (true)
         {
-            ++pos_;
+            // Skip to the next quote, backslash or line break
+            pos_ = ScanCharClass(text_, pos_, CharClass::StringLiteralBody);
             if (!HasChars())
             {
-                return std::unexpected(
-                    LexerError{
-                        .type = LexerErrorType::MissingTerminatingCharacterForStringLiteral,
-                        .begin = begin,
-                        .end = pos_,
-                    });
+                return MakeError(LexerErrorType::MissingTerminatingCharacterForStringLiteral, begin, pos_);
             }
 
             const char c = text_[pos_];
             switch (c)
             {
             case '\n':
-                return std::unexpected(
-                    LexerError{
-                        .type = LexerErrorType::MissingTerminatingCharacterForStringLiteral,
-                        .begin = begin,
-                        .end = pos_,
-                    });
+                return MakeError(LexerErrorType::MissingTerminatingCharacterForStringLiteral, begin, pos_);
             case '\\':
-                if (pos_ + 1 != text_.size() && text_[pos_ + 1] == '"')
-                {
-                    ++pos_;
-                }
-
+                // Only an escaped quote is skipped together with the backslash
+                pos_ += (pos_ + 1 != text_.size() && text_[pos_ + 1] == '"') ? 2uz : 1uz;
                 break;
             case '"':
-                return LexerToken{
-                    .type = TokenType::StringLiteral,
-                    .begin = begin,
-                    .end = ++pos_,
-                };
+                return MakeToken(TokenType::StringLiteral, begin, ++pos_);
             }
         }
     }
@@ -443,15 +642,46 @@ private:
 
     constexpr void SkipSpaces() noexcept
     {
-        while (HasChars() && IsSpaceChar(text_[pos_]))
+        const size_t begin = pos_;
+        pos_ = ScanCharClass(text_, pos_, CharClass::Space);
+
+        if constexpr (kTracksLineColumn)
+        {
+            CountLines(begin, pos_);
+        }
+    }
+
+    // Only spaces and block comments can contain line breaks
+    constexpr void CountLines(size_t begin, size_t end) noexcept
+    {
+        const std::string_view range = text_.substr(begin, end - begin);
+        for (size_t i = range.find('\n'); i != range.npos; i = range.find('\n', i + 1))
         {
-            pos_++;
+            ++lines_.line;
+            lines_.line_begin = begin + i + 1;
         }
     }
 
+    struct LineTracker
+    {
+        size_t line = 1;
+        size_t line_begin = 0;
+        LineColumn result_line_column;
+    };
+
 private:
     std::string_view text_;
     size_t pos_ = 0;
+    [[no_unique_address]] std::conditional_t<kDecodesLiteralValues, LiteralValue, std::monostate> literal_value_;
+    [[no_unique_address]] std::conditional_t<kTracksLineColumn, LineTracker, std::monostate> lines_;
+    [[no_unique_address]] std::conditional_t<kInternsIdentifiers, SymbolTableType*, std::monostate> symbols_{};
+    [[no_unique_address]] std::conditional_t<kInternsIdentifiers, SymbolId, std::monostate> symbol_id_{};
 };
 
+using Lexer = BasicLexer<CompactLexerTraits>;
+using LargeFileLexer = BasicLexer<LargeFileLexerTraits>;
+using DecodingLexer = BasicLexer<DecodingLexerTraits>;
+
+static_assert(sizeof(LexerResult) <= 12);
+
 }  // namespace kaleidoscope
@@ -1,59 +1,34 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cassert>
 #include <string_view>
+#include <utility>
 
-#include "ass/fixed_unordered_map.hpp"
+#include "ass/fixed_bitset.hpp"
 #include "lexer_enums.hpp"
+#include "perfect_hash.hpp"
 
 namespace kaleidoscope
 {
 
-inline constexpr auto kKeywordLookup = []
-{
-    auto hasher = [](const std::string_view s) -> size_t
-    {
-        size_t hash = 0;
-        [[likely]] if (!s.empty())
-        {
-            hash |= std::bit_cast<uint8_t>(s.front());
-        }
-        return hash;
-    };
-
-    ass::FixedUnorderedMap<10, std::string_view, TokenType, decltype(hasher)> m;
-
-    auto add = [&m](std::string_view s, TokenType token_type)
-    {
-        assert(!m.Contains(s));
-        m.Add(s, token_type);
-    };
+inline constexpr std::array kKeywords{
+    std::pair{std::string_view{"def"}, TokenType::Def},
+    std::pair{std::string_view{"extern"}, TokenType::Extern},
+};
 
-    add("def", TokenType::Def);
-    add("extern", TokenType::Extern);
+inline constexpr std::array kOperatorSymbols{
+    std::pair{'+', TokenType::Plus},
+    std::pair{'-', TokenType::Minus},
+    std::pair{'*', TokenType::Asterisk},
+    std::pair{'/', TokenType::ForwardSlash},
+    std::pair{'(', TokenType::OpenParen},
+    std::pair{')', TokenType::CloseParen},
+};
 
-    return m;
-}();
-
-inline constexpr auto kOperatorSymbolLookup = []
-{
-    auto hasher = [](char c) -> size_t
-    {
-        return std::bit_cast<uint8_t>(c);
-    };
-
-    ass::FixedUnorderedMap<10, char, TokenType, decltype(hasher)> m;
-
-    auto add = [&m](char c, TokenType token_type)
-    {
-        assert(!m.Contains(c));
-        m.Add(c, token_type);
-    };
-
-    add('+', TokenType::Plus);
-    add('-', TokenType::Minus);
-    add('*', TokenType::Asterisk);
-    add('/', TokenType::ForwardSlash);
-
-    return m;
-}();
+inline constexpr auto kKeywordLookup = MakePerfectHashMap<SampledStringHasher, kKeywords>();
+inline constexpr auto kOperatorSymbolLookup = MakePerfectHashMap<CharHasher, kOperatorSymbols>();
 
 [[nodiscard]] constexpr auto BitsetFromChars(std::string_view s)
 {
@@ -83,6 +58,17 @@ inline constexpr auto kOperatorSymbolLookup = []
     return b;
 }
 
+// All characters except the specified ones
+[[nodiscard]] constexpr auto BitsetFromCharsExcept(std::string_view s)
+{
+    ass::FixedBitset<256> b;
+
+    for (size_t idx = 0; idx != 256; ++idx) b.Set(idx, true);
+    for (char c : s) b.Set(std::bit_cast<uint8_t>(c), false);
+
+    return b;
+}
+
 inline constexpr auto kLowerCaseLetters = BitsetFromCharRange('a', 'z');
 inline constexpr auto kUpperCaseLetters = BitsetFromCharRange('A', 'Z');
 inline constexpr auto kLetters = kLowerCaseLetters | kUpperCaseLetters;
@@ -93,4 +79,8 @@ inline constexpr auto kSpaceChars = BitsetFromChars(" \f\n\r\t\v");
 inline constexpr auto kHexDigits = kDigits | BitsetFromCharRange('a', 'f') | BitsetFromCharRange('A', 'F');
 inline constexpr auto kOctalDigits = BitsetFromCharRange('0', '7');
 inline constexpr auto kBinaryOperator = BitsetFromChars("+-*/");
+inline constexpr auto kOperatorSymbolChars = BitsetFromChars("+-*/()");
+inline constexpr auto kLineCommentBodyChars = BitsetFromCharsExcept("\n");
+inline constexpr auto kBlockCommentBodyChars = BitsetFromCharsExcept("*");
+inline constexpr auto kStringLiteralBodyChars = BitsetFromCharsExcept("\"\\\n");
 }  // namespace kaleidoscope
@@ -22,6 +22,8 @@ enum class TokenType : uint8_t
     Minus,
     Asterisk,
     ForwardSlash,
+    OpenParen,
+    CloseParen,
     EndOfFile
 };
 
@@ -34,6 +36,29 @@ enum class LexerErrorType : uint8_t
     MultipleDotsInFloatingPointLiteral,
     UnterminatedBlockComment,
     MissingTerminatingCharacterForStringLiteral,
+    TokenTooLong,
+    IntegerLiteralOverflow,
+    FloatLiteralOutOfRange,
+};
+
+// What the lexer does after an error
+enum class LexerErrorMode : uint8_t
+{
+    // Report the error and continue with the next token
+    Report,
+
+    // Report the first error and then only EndOfFile
+    FastFail,
+};
+
+// Implementation of number literal lexing
+enum class NumberLiteralEngine : uint8_t
+{
+    // Separate readers for every literal kind which are tried one after another
+    HandWritten,
+
+    // Table-driven automaton that recognizes all literal kinds in one pass
+    Dfa,
 };
 
 }  // namespace kaleidoscope
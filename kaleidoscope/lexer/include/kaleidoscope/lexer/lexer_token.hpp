@@ -0,0 +1,88 @@
+#pragma once
+
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include "lexer_enums.hpp"
+
+namespace kaleidoscope
+{
+
+// Source range [begin, end) tagged with a one byte type, packed into 8 bytes:
+// 32-bit begin offset, 24-bit length and 8-bit type. A default-constructed range is empty and has kDefaultType.
+template <typename Type, Type kDefaultType = Type{}>
+    requires(sizeof(Type) == 1)
+class CompactTaggedRange
+{
+public:
+    static constexpr size_t kMaxOffset = std::numeric_limits<uint32_t>::max();
+    static constexpr size_t kMaxLength = (size_t{1} << 24) - 1;
+
+    constexpr CompactTaggedRange() = default;
+    constexpr CompactTaggedRange(Type type, size_t begin, size_t end) noexcept
+        : begin_(static_cast<uint32_t>(begin)),
+          length_and_type_(
+              static_cast<uint32_t>(end - begin) | (static_cast<uint32_t>(std::bit_cast<uint8_t>(type)) << 24))
+    {
+        assert(begin <= end);
+        assert(begin <= kMaxOffset);
+        assert(end - begin <= kMaxLength);
+    }
+
+    [[nodiscard]] constexpr bool operator==(const CompactTaggedRange&) const noexcept = default;
+
+    [[nodiscard]] constexpr Type GetType() const noexcept
+    {
+        return std::bit_cast<Type>(static_cast<uint8_t>(length_and_type_ >> 24));
+    }
+    [[nodiscard]] constexpr size_t GetBegin() const noexcept { return begin_; }
+    [[nodiscard]] constexpr size_t GetLength() const noexcept { return length_and_type_ & kMaxLength; }
+    [[nodiscard]] constexpr size_t GetEnd() const noexcept { return GetBegin() + GetLength(); }
+
+private:
+    uint32_t begin_ = 0;
+    uint32_t length_and_type_ = static_cast<uint32_t>(std::bit_cast<uint8_t>(kDefaultType)) << 24;
+};
+
+// Same interface as CompactTaggedRange but without limits on offsets and lengths
+template <typename Type, Type kDefaultType = Type{}>
+class WideTaggedRange
+{
+public:
+    static constexpr size_t kMaxOffset = std::numeric_limits<size_t>::max();
+    static constexpr size_t kMaxLength = std::numeric_limits<size_t>::max();
+
+    constexpr WideTaggedRange() = default;
+    constexpr WideTaggedRange(Type type, size_t begin, size_t end) noexcept : type_(type), begin_(begin), end_(end)
+    {
+        assert(begin <= end);
+    }
+
+    [[nodiscard]] constexpr bool operator==(const WideTaggedRange&) const noexcept = default;
+
+    [[nodiscard]] constexpr Type GetType() const noexcept { return type_; }
+    [[nodiscard]] constexpr size_t GetBegin() const noexcept { return begin_; }
+    [[nodiscard]] constexpr size_t GetLength() const noexcept { return end_ - begin_; }
+    [[nodiscard]] constexpr size_t GetEnd() const noexcept { return end_; }
+
+private:
+    Type type_ = kDefaultType;
+    size_t begin_ = 0;
+    size_t end_ = 0;
+};
+
+// Default-constructed tokens are EndOfFile
+using LexerToken = CompactTaggedRange<TokenType, TokenType::EndOfFile>;
+using LexerError = CompactTaggedRange<LexerErrorType>;
+
+// Tokens for sources larger than 4 GiB or with tokens longer than 16 MiB
+using LargeLexerToken = WideTaggedRange<TokenType, TokenType::EndOfFile>;
+using LargeLexerError = WideTaggedRange<LexerErrorType>;
+
+static_assert(sizeof(LexerToken) == 8);
+static_assert(sizeof(LexerError) == 8);
+
+}  // namespace kaleidoscope
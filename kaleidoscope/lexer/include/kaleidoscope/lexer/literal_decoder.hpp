@@ -0,0 +1,161 @@
+#pragma once
+
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <expected>
+#include <optional>
+#include <string_view>
+#include <variant>
+
+#include "bytes.hpp"
+#include "checked_arithmetic.hpp"
+#include "lexer_enums.hpp"
+
+namespace kaleidoscope
+{
+
+// Value of a numeric literal token. Literals never have a sign, minus is a separate token.
+using LiteralValue = std::variant<uint64_t, double>;
+
+// Converts 8 decimal digits at once. The first digit is the most significant one.
+[[nodiscard]] constexpr uint32_t ParseEightDecimalDigits(uint64_t chars) noexcept
+{
+    constexpr uint64_t kMask = 0x000000FF000000FF;
+    constexpr uint64_t kMul1 = 100 + (1'000'000ull << 32);
+    constexpr uint64_t kMul2 = 1 + (10'000ull << 32);
+
+    chars -= 0x3030303030303030;
+    chars = (chars * 10) + (chars >> 8);  // pairs of digits
+    chars = (((chars & kMask) * kMul1) + (((chars >> 16) & kMask) * kMul2)) >> 32;
+    return static_cast<uint32_t>(chars);
+}
+
+// Joins 8 digit values of bits_per_digit bits each (one per byte) into one number.
+// The first digit is the most significant one.
+template <size_t bits_per_digit>
+[[nodiscard]] constexpr uint32_t PackEightDigits(uint64_t digits) noexcept
+{
+    digits = ((digits << bits_per_digit) | (digits >> 8)) & 0x00FF00FF00FF00FF;
+    digits = ((digits << (2 * bits_per_digit)) | (digits >> 16)) & 0x0000FFFF0000FFFF;
+    digits = ((digits << (4 * bits_per_digit)) | (digits >> 32)) & 0x00000000FFFFFFFF;
+    return static_cast<uint32_t>(digits);
+}
+
+// Value of one digit (or 8 digits in separate bytes) of a literal in base 2^bits_per_digit
+template <size_t bits_per_digit>
+[[nodiscard]] constexpr uint64_t GetDigitValues(uint64_t chars) noexcept
+{
+    if constexpr (bits_per_digit == 4)
+    {
+        // Letters have 0x40 bit set and their low nibble is 1 for 'a' and 'A'
+        return (chars & 0x0F0F0F0F0F0F0F0F) + ((chars >> 6) & 0x0101010101010101) * 9;
+    }
+    else
+    {
+        constexpr uint64_t kDigitMask = ((uint64_t{1} << bits_per_digit) - 1) * 0x0101010101010101;
+        return chars & kDigitMask;
+    }
+}
+
+[[nodiscard]] constexpr std::expected<uint64_t, LexerErrorType> DecodeDecimalDigits(std::string_view digits) noexcept
+{
+    uint64_t value = 0;
+    size_t i = 0;
+
+    for (; i + 8 <= digits.size(); i += 8)
+    {
+        const uint32_t chunk = ParseEightDecimalDigits(LoadEightChars(digits.data() + i));
+        const std::optional<uint64_t> next = CheckedMultiplyAdd(value, 100'000'000, chunk);
+        if (!next.has_value()) return std::unexpected(LexerErrorType::IntegerLiteralOverflow);
+        value = *next;
+    }
+
+    for (; i != digits.size(); ++i)
+    {
+        const auto digit = static_cast<uint64_t>(digits[i] - '0');
+        const std::optional<uint64_t> next = CheckedMultiplyAdd(value, 10, digit);
+        if (!next.has_value()) return std::unexpected(LexerErrorType::IntegerLiteralOverflow);
+        value = *next;
+    }
+
+    return value;
+}
+
+// Digits of hexadecimal, octal and binary literals
+template <size_t bits_per_digit>
+[[nodiscard]] constexpr std::expected<uint64_t, LexerErrorType> DecodePowerOfTwoBaseDigits(
+    std::string_view digits) noexcept
+{
+    constexpr size_t kChunkBits = 8 * bits_per_digit;
+
+    uint64_t value = 0;
+    size_t i = 0;
+
+    for (; i + 8 <= digits.size(); i += 8)
+    {
+        if (value >> (64 - kChunkBits) != 0) return std::unexpected(LexerErrorType::IntegerLiteralOverflow);
+        value = (value << kChunkBits) | PackEightDigits<bits_per_digit>(
+                                            GetDigitValues<bits_per_digit>(LoadEightChars(digits.data() + i)));
+    }
+
+    for (; i != digits.size(); ++i)
+    {
+        if (value >> (64 - bits_per_digit) != 0) return std::unexpected(LexerErrorType::IntegerLiteralOverflow);
+        value = (value << bits_per_digit) | GetDigitValues<bits_per_digit>(std::bit_cast<uint8_t>(digits[i]));
+    }
+
+    return value;
+}
+
+// Text must be a valid literal of the specified type, i.e. the lexer reported it as a token.
+[[nodiscard]] constexpr std::expected<uint64_t, LexerErrorType> DecodeIntegerLiteral(
+    TokenType type,
+    std::string_view text) noexcept
+{
+    switch (type)
+    {
+    case TokenType::DecimalLiteral:
+        return DecodeDecimalDigits(text);
+    case TokenType::HexadecimalLiteral:
+        return DecodePowerOfTwoBaseDigits<4>(text.substr(2));
+    case TokenType::BinaryLiteral:
+        return DecodePowerOfTwoBaseDigits<1>(text.substr(2));
+    case TokenType::OctalLiteral:
+        return DecodePowerOfTwoBaseDigits<3>(text);
+    default:
+        assert(false);
+        return std::unexpected(LexerErrorType::UnexpectedSymbol);
+    }
+}
+
+// Returns FloatLiteralOutOfRange if the value does not fit into double.
+// The lexer accepts some float tokens that are not numbers (like "12a"), these are reported as UnexpectedSymbol.
+[[nodiscard]] std::expected<double, LexerErrorType> DecodeFloatLiteral(std::string_view text) noexcept;
+
+[[nodiscard]] constexpr bool IsNumericLiteral(TokenType type) noexcept
+{
+    switch (type)
+    {
+    case TokenType::FloatLiteral:
+    case TokenType::DecimalLiteral:
+    case TokenType::HexadecimalLiteral:
+    case TokenType::BinaryLiteral:
+    case TokenType::OctalLiteral:
+        return true;
+    default:
+        return false;
+    }
+}
+
+[[nodiscard]] constexpr std::expected<LiteralValue, LexerErrorType> DecodeNumericLiteral(
+    TokenType type,
+    std::string_view text) noexcept
+{
+    assert(IsNumericLiteral(type));
+
+    if (type == TokenType::FloatLiteral) return DecodeFloatLiteral(text);
+    return DecodeIntegerLiteral(type, text);
+}
+
+}  // namespace kaleidoscope
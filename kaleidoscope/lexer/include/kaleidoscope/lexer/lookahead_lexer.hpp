@@ -1,45 +1,120 @@
 #pragma once
 
 #include <array>
+#include <concepts>
+#include <string_view>
+#include <type_traits>
+#include <variant>
 
 #include "lexer.hpp"
 
 namespace kaleidoscope
 {
 
-template <size_t horizon_size>
+// Token stream with a lookahead of at least two tokens that the parser reads from:
+// LookaheadLexer or BlockLookaheadLexer over any lexer.
+// PeekLiteralValue and PeekSymbolId are there when the underlying lexer provides them.
+template <typename T>
+concept TokenLookahead = requires(T& l, const typename T::Token& token) {
+    { T::kDecodesLiteralValues } -> std::convertible_to<bool>;
+    { T::kInternsIdentifiers } -> std::convertible_to<bool>;
+    { l.Peek() } -> std::convertible_to<typename T::Result>;
+    { l.Peek(size_t{1}) } -> std::convertible_to<typename T::Result>;
+    { l.Take() } -> std::same_as<typename T::Result>;
+    { l.GetTokenView(token) } -> std::same_as<std::string_view>;
+    requires !T::kDecodesLiteralValues || requires { { l.PeekLiteralValue() } -> std::convertible_to<LiteralValue>; };
+    requires !T::kInternsIdentifiers || requires { { l.PeekSymbolId() } -> std::same_as<SymbolId>; };
+};
+
+template <size_t horizon_size, typename LexerType = Lexer>
     requires(horizon_size >= 2)
 class LookaheadLexer
 {
 public:
-    constexpr explicit LookaheadLexer(Lexer& lexer) : lexer_(&lexer)
+    using Token = typename LexerType::Token;
+    using Result = typename LexerType::Result;
+
+    static constexpr bool kDecodesLiteralValues = LexerType::kDecodesLiteralValues;
+    static constexpr bool kInternsIdentifiers = LexerType::kInternsIdentifiers;
+
+    constexpr explicit LookaheadLexer(LexerType& lexer) : lexer_(&lexer)
     {
-        for (auto& slot : tokens_)
+        for (size_t slot = 0; slot != horizon_size; ++slot)
         {
-            slot = lexer_->GetToken();
+            tokens_[slot] = ReadToken(slot);
         }
     }
 
-    [[nodiscard]] constexpr const LexerResult& Peek(size_t index = 0) noexcept
+    // The reference is valid until the next Take
+    [[nodiscard]] constexpr const Result& Peek(size_t index = 0) noexcept
     {
         return tokens_[(start_index_ + index) % tokens_.size()];
     }
 
-    [[nodiscard]] constexpr LexerResult Take() noexcept
+    [[nodiscard]] constexpr Result Take() noexcept
     {
-        LexerResult result = std::exchange(tokens_[start_index_], lexer_->GetToken());
+        Result result = tokens_[start_index_];
+        tokens_[start_index_] = ReadToken(start_index_);
         start_index_ = (start_index_ + 1) % tokens_.size();
         return result;
     }
 
-    [[nodiscard]] constexpr std::string_view GetTokenView(const LexerToken& lexer_token) const
+    [[nodiscard]] constexpr std::string_view GetTokenView(const Token& lexer_token) const
     {
         return lexer_->GetTokenView(lexer_token);
     }
 
+    // Value of the numeric literal returned by Peek(index)
+    [[nodiscard]] constexpr const LiteralValue& PeekLiteralValue(size_t index = 0) const noexcept
+        requires(LexerType::kDecodesLiteralValues)
+    {
+        return values_[(start_index_ + index) % values_.size()];
+    }
+
+    // Symbol of the identifier returned by Peek(index)
+    [[nodiscard]] constexpr SymbolId PeekSymbolId(size_t index = 0) const noexcept
+        requires(LexerType::kInternsIdentifiers)
+    {
+        return symbol_ids_[(start_index_ + index) % symbol_ids_.size()];
+    }
+
 private:
-    Lexer* lexer_ = nullptr;
-    std::array<LexerResult, horizon_size> tokens_;
+    // Reads the next token and remembers its value and symbol in the specified slot
+    [[nodiscard]] constexpr Result ReadToken([[maybe_unused]] size_t slot)
+    {
+        Result result = lexer_->GetToken();
+        if constexpr (LexerType::kDecodesLiteralValues)
+        {
+            if (result.has_value() && IsNumericLiteral(result->GetType()))
+            {
+                values_[slot] = lexer_->GetLiteralValue();
+            }
+        }
+
+        if constexpr (LexerType::kInternsIdentifiers)
+        {
+            if (result.has_value() && result->GetType() == TokenType::Identifier)
+            {
+                symbol_ids_[slot] = lexer_->GetSymbolId();
+            }
+        }
+
+        return result;
+    }
+
+    LexerType* lexer_ = nullptr;
+    std::array<Result, horizon_size> tokens_;
+    [[no_unique_address]] std::conditional_t<
+        LexerType::kDecodesLiteralValues,
+        std::array<LiteralValue, horizon_size>,
+        std::monostate> values_;
+    [[no_unique_address]] std::conditional_t<
+        LexerType::kInternsIdentifiers,
+        std::array<SymbolId, horizon_size>,
+        std::monostate> symbol_ids_;
     size_t start_index_ = 0;
 };
+
+static_assert(TokenLookahead<LookaheadLexer<2>>);
+
 }  // namespace kaleidoscope
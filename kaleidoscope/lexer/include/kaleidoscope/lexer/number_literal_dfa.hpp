@@ -0,0 +1,222 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <expected>
+#include <optional>
+
+#include "lexer_data.hpp"
+#include "lexer_enums.hpp"
+
+namespace kaleidoscope
+{
+
+// States of the number literal automaton. The automaton starts at the first character of a literal
+// (a digit or a dot) and consumes one character per transition until it reaches a final state.
+enum class NumberDfaState : uint8_t
+{
+    Start,
+    Zero,               // "0"
+    Decimal,            // [1-9][0-9]*
+    Float,              // float literal without a dot so far
+    Dot,                // "."
+    FloatWithDot,       // float literal with a dot and at least one more character
+    ExponentStart,      // after 'e' or 'E'
+    ExponentSign,       // after '+' or '-' that follows the exponent indicator
+    ExponentDigits,     // at least one digit of the exponent
+    HexadecimalPrefix,  // "0x"
+    Hexadecimal,        // "0x" and at least one hex digit
+    Binary,             // "0b" and binary digits
+    Octal,              // "0" and at least one octal digit
+
+    // Final states. The character that led to a final state is not consumed.
+    AcceptDecimal,
+    AcceptFloat,
+    AcceptHexadecimal,
+    AcceptBinary,
+    AcceptOctal,
+    UnexpectedSymbol,
+    ZeroLengthExponent,
+    NoDigitsAroundDot,
+    MultipleDots,
+};
+
+inline constexpr size_t kNumberDfaIntermediateStateCount = static_cast<size_t>(NumberDfaState::AcceptDecimal);
+
+[[nodiscard]] constexpr bool IsFinalNumberDfaState(NumberDfaState state) noexcept
+{
+    return static_cast<size_t>(state) >= kNumberDfaIntermediateStateCount;
+}
+
+// Transition function. std::nullopt means the end of input.
+// Mirrors the hand-written readers in BasicLexer: the states track every reader that may still succeed,
+// so the literal is recognized in one pass instead of trying the readers one after another.
+[[nodiscard]] constexpr NumberDfaState GetNextNumberDfaState(NumberDfaState state, std::optional<char> next)
+{
+    using enum NumberDfaState;
+
+    auto is = [&](const ass::FixedBitset<256>& chars)
+    {
+        return next.has_value() && chars.Get(std::bit_cast<uint8_t>(*next));
+    };
+
+    auto is_char = [&](char a, char b = '\0')
+    {
+        return next.has_value() && (*next == a || (b != '\0' && *next == b));
+    };
+
+    // Characters that end float, hexadecimal, binary and octal literals
+    const bool is_terminator = !next.has_value() || is(kSpaceChars) || is_char('_');
+
+    // Decimal literals can also be followed by an operator
+    const bool is_decimal_terminator = is_terminator || (next.has_value() && kOperatorSymbolLookup.Contains(*next));
+
+    const bool is_exponent = is_char('e', 'E');
+
+    switch (state)
+    {
+    case Start:
+        if (is_char('0')) return Zero;
+        if (is(kDigits)) return Decimal;
+        if (is_char('.')) return Dot;
+        return UnexpectedSymbol;
+
+    case Zero:
+        if (is_decimal_terminator) return AcceptDecimal;
+        if (is_char('x', 'X')) return HexadecimalPrefix;
+        if (is_char('b', 'B')) return Binary;
+        if (is(kOctalDigits)) return Octal;
+        if (is(kDigits)) return UnexpectedSymbol;
+        if (is_char('.')) return FloatWithDot;
+        if (is_exponent) return ExponentStart;
+        return Float;
+
+    case Decimal:
+        if (is(kDigits)) return Decimal;
+        if (is_decimal_terminator) return AcceptDecimal;
+        if (is_char('.')) return FloatWithDot;
+        if (is_exponent) return ExponentStart;
+        return Float;
+
+    case Float:
+        if (is_terminator) return AcceptFloat;
+        if (is_exponent) return ExponentStart;
+        if (is_char('.')) return FloatWithDot;
+        return Float;
+
+    case Dot:
+        if (is_terminator || is_exponent) return NoDigitsAroundDot;
+        if (is_char('.')) return MultipleDots;
+        return FloatWithDot;
+
+    case FloatWithDot:
+        if (is_terminator) return AcceptFloat;
+        if (is_exponent) return ExponentStart;
+        if (is_char('.')) return MultipleDots;
+        return FloatWithDot;
+
+    case ExponentStart:
+        if (is_char('+', '-')) return ExponentSign;
+        if (is(kDigits)) return ExponentDigits;
+        return ZeroLengthExponent;
+
+    case ExponentSign:
+        if (is(kDigits)) return ExponentDigits;
+        return ZeroLengthExponent;
+
+    case ExponentDigits:
+        if (is(kDigits)) return ExponentDigits;
+        if (is_terminator) return AcceptFloat;
+        return UnexpectedSymbol;
+
+    case HexadecimalPrefix:
+        if (is(kHexDigits)) return Hexadecimal;
+        return UnexpectedSymbol;
+
+    case Hexadecimal:
+        if (is(kHexDigits)) return Hexadecimal;
+        if (is_terminator) return AcceptHexadecimal;
+        return UnexpectedSymbol;
+
+    case Binary:
+        if (is_char('0', '1')) return Binary;
+        if (is_terminator) return AcceptBinary;
+        return UnexpectedSymbol;
+
+    case Octal:
+        if (is(kOctalDigits)) return Octal;
+        if (is_terminator) return AcceptOctal;
+        return UnexpectedSymbol;
+
+    default:
+        return state;
+    }
+}
+
+// What the lexer reports when the automaton stops in the final state
+[[nodiscard]] constexpr std::expected<TokenType, LexerErrorType> GetNumberDfaOutcome(NumberDfaState state)
+{
+    using enum NumberDfaState;
+
+    switch (state)
+    {
+    case AcceptDecimal:
+        return TokenType::DecimalLiteral;
+    case AcceptFloat:
+        return TokenType::FloatLiteral;
+    case AcceptHexadecimal:
+        return TokenType::HexadecimalLiteral;
+    case AcceptBinary:
+        return TokenType::BinaryLiteral;
+    case AcceptOctal:
+        return TokenType::OctalLiteral;
+    case ZeroLengthExponent:
+        return std::unexpected(LexerErrorType::ZeroLengthExponentInScientificNotation);
+    case NoDigitsAroundDot:
+        return std::unexpected(LexerErrorType::NeedAtLeastOneDigitAroundDotInFloatLiteral);
+    case MultipleDots:
+        return std::unexpected(LexerErrorType::MultipleDotsInFloatingPointLiteral);
+    default:
+        return std::unexpected(LexerErrorType::UnexpectedSymbol);
+    }
+}
+
+// Transition table of the number literal automaton: one row of 256 entries per intermediate state
+// plus the transitions taken at the end of input.
+class NumberLiteralDfa
+{
+public:
+    consteval NumberLiteralDfa()
+    {
+        for (size_t state_index = 0; state_index != kNumberDfaIntermediateStateCount; ++state_index)
+        {
+            const auto state = static_cast<NumberDfaState>(state_index);
+            for (size_t c = 0; c != 256; ++c)
+            {
+                const char next = std::bit_cast<char>(static_cast<uint8_t>(c));
+                transitions_[state_index][c] = GetNextNumberDfaState(state, next);
+            }
+
+            end_transitions_[state_index] = GetNextNumberDfaState(state, std::nullopt);
+        }
+    }
+
+    [[nodiscard]] constexpr NumberDfaState GetNextState(NumberDfaState state, char c) const noexcept
+    {
+        return transitions_[static_cast<size_t>(state)][std::bit_cast<uint8_t>(c)];
+    }
+
+    [[nodiscard]] constexpr NumberDfaState GetEndState(NumberDfaState state) const noexcept
+    {
+        return end_transitions_[static_cast<size_t>(state)];
+    }
+
+private:
+    std::array<std::array<NumberDfaState, 256>, kNumberDfaIntermediateStateCount> transitions_{};
+    std::array<NumberDfaState, kNumberDfaIntermediateStateCount> end_transitions_{};
+};
+
+inline constexpr NumberLiteralDfa kNumberLiteralDfa;
+
+}  // namespace kaleidoscope
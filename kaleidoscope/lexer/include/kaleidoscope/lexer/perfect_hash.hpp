@@ -0,0 +1,155 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace kaleidoscope
+{
+
+[[nodiscard]] constexpr uint64_t PerfectHashMix(uint64_t hash, uint64_t value) noexcept
+{
+    return (hash ^ value) * 0x9E3779B97F4A7C15;
+}
+
+// Hashes the length and three sampled bytes of a string.
+// That is enough to tell keywords apart and keeps the cost independent of the identifier length.
+struct SampledStringHasher
+{
+    [[nodiscard]] static constexpr uint64_t Hash(std::string_view s, uint64_t seed) noexcept
+    {
+        uint64_t hash = PerfectHashMix(seed, s.size());
+        [[likely]] if (!s.empty())
+        {
+            hash = PerfectHashMix(hash, std::bit_cast<uint8_t>(s.front()));
+            hash = PerfectHashMix(hash, std::bit_cast<uint8_t>(s[s.size() / 2]));
+            hash = PerfectHashMix(hash, std::bit_cast<uint8_t>(s.back()));
+        }
+        return hash;
+    }
+};
+
+struct CharHasher
+{
+    [[nodiscard]] static constexpr uint64_t Hash(char c, uint64_t seed) noexcept
+    {
+        return PerfectHashMix(seed, std::bit_cast<uint8_t>(c));
+    }
+};
+
+// Open table of 2^size_bits slots where every key has its own slot.
+// Lookup is one hash, one slot load and one key comparison.
+template <typename Key, typename Value, typename Hasher, size_t size_bits>
+class PerfectHashMap
+{
+public:
+    static constexpr size_t kSize = size_t{1} << size_bits;
+
+    constexpr explicit PerfectHashMap(uint64_t seed) noexcept : seed_(seed) {}
+
+    [[nodiscard]] static constexpr size_t GetSlot(const Key& key, uint64_t seed) noexcept
+    {
+        if constexpr (size_bits == 0)
+        {
+            return 0;
+        }
+        else
+        {
+            return static_cast<size_t>(Hasher::Hash(key, seed) >> (64 - size_bits));
+        }
+    }
+
+    // Returns false if the slot is already taken
+    [[nodiscard]] constexpr bool TryAdd(const Key& key, const Value& value) noexcept
+    {
+        const size_t slot = GetSlot(key, seed_);
+        if (occupied_[slot]) return false;
+
+        occupied_[slot] = true;
+        keys_[slot] = key;
+        values_[slot] = value;
+        return true;
+    }
+
+    [[nodiscard]] constexpr const Value* Find(const Key& key) const noexcept
+    {
+        const size_t slot = GetSlot(key, seed_);
+        return occupied_[slot] && keys_[slot] == key ? &values_[slot] : nullptr;
+    }
+
+    [[nodiscard]] constexpr bool Contains(const Key& key) const noexcept { return Find(key) != nullptr; }
+
+    [[nodiscard]] constexpr uint64_t GetSeed() const noexcept { return seed_; }
+
+private:
+    uint64_t seed_ = 0;
+    std::array<Key, kSize> keys_{};
+    std::array<Value, kSize> values_{};
+    std::array<bool, kSize> occupied_{};
+};
+
+template <typename Hasher, typename Key, typename Value, size_t count>
+[[nodiscard]] constexpr bool IsPerfectHash(
+    const std::array<std::pair<Key, Value>, count>& entries,
+    uint64_t seed,
+    size_t size_bits) noexcept
+{
+    std::array<uint64_t, count> slots{};
+    for (size_t i = 0; i != count; ++i)
+    {
+        const uint64_t hash = Hasher::Hash(entries[i].first, seed);
+        slots[i] = size_bits == 0 ? 0 : hash >> (64 - size_bits);
+
+        for (size_t j = 0; j != i; ++j)
+        {
+            if (slots[j] == slots[i]) return false;
+        }
+    }
+
+    return true;
+}
+
+// Searches for the smallest table and the first seed which map all keys to distinct slots.
+// entries is a reference to a constexpr std::array of key-value pairs.
+template <typename Hasher, const auto& entries>
+[[nodiscard]] consteval auto MakePerfectHashMap()
+{
+    using Entry = typename std::remove_cvref_t<decltype(entries)>::value_type;
+    using Key = decltype(Entry::first);
+    using Value = decltype(Entry::second);
+
+    constexpr size_t kMaxSizeBits = 12;
+    constexpr uint64_t kMaxSeeds = 1 << 12;
+
+    constexpr auto params = []
+    {
+        const size_t min_size_bits = static_cast<size_t>(std::bit_width(entries.size() - 1));
+        for (size_t size_bits = min_size_bits; size_bits <= kMaxSizeBits; ++size_bits)
+        {
+            for (uint64_t seed = 0; seed != kMaxSeeds; ++seed)
+            {
+                if (IsPerfectHash<Hasher>(entries, seed, size_bits))
+                {
+                    return std::pair{size_bits, seed};
+                }
+            }
+        }
+
+        throw std::logic_error("Could not find a perfect hash. Check the keys for duplicates.");
+    }();
+
+    PerfectHashMap<Key, Value, Hasher, params.first> map(params.second);
+    for (const auto& [key, value] : entries)
+    {
+        [[maybe_unused]] const bool added = map.TryAdd(key, value);
+    }
+
+    return map;
+}
+
+}  // namespace kaleidoscope
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <memory>
+#include <stop_token>
+#include <thread>
+#include <type_traits>
+#include <variant>
+
+#include "lexer.hpp"
+#include "spsc_queue.hpp"
+
+namespace kaleidoscope
+{
+
+// Runs LexerType on its own thread. Results are passed to the consuming thread in batches through
+// a bounded SPSC queue, so lexing of the next batches overlaps with parsing of the current one.
+// Has the same interface as the lexer, so it can be wrapped into LookaheadLexer.
+//
+// The lexer thread stops after it produces EndOfFile. After that GetToken keeps returning EndOfFile,
+// as the lexer does. Destroying the object before the end (e.g. the parser gave up after an error)
+// stops the lexer thread: it is not blocked even if the queue is full.
+// Use LexerErrorMode::FastFail in the traits to stop lexing at the first error.
+template <typename LexerType = Lexer, size_t batch_size = 256, size_t queue_capacity = 16>
+    requires(batch_size >= 1)
+class PipelinedLexer
+{
+public:
+    using Token = typename LexerType::Token;
+    using Result = typename LexerType::Result;
+
+    static constexpr bool kDecodesLiteralValues = LexerType::kDecodesLiteralValues;
+
+    // The lexer is constructed on its own thread from the text alone
+    static constexpr bool kInternsIdentifiers = false;
+    static_assert(!LexerType::kInternsIdentifiers);
+
+    explicit PipelinedLexer(std::string_view text)
+        : text_(text),
+          queue_(std::make_unique<Queue>()),
+          producer_([this](std::stop_token stop_token) { Produce(stop_token); })
+    {
+    }
+
+    PipelinedLexer(const PipelinedLexer&) = delete;
+    PipelinedLexer& operator=(const PipelinedLexer&) = delete;
+
+    [[nodiscard]] Result GetToken() noexcept
+    {
+        if (index_ == available_) [[unlikely]]
+        {
+            if (finished_) return end_of_file_;
+            NextBatch();
+        }
+
+        const size_t i = index_++;
+        if constexpr (kDecodesLiteralValues)
+        {
+            literal_value_ = batch_->values[i];
+        }
+
+        const Result& result = batch_->results[i];
+        if (result.has_value() && result->GetType() == TokenType::EndOfFile)
+        {
+            finished_ = true;
+            end_of_file_ = result;
+        }
+
+        return result;
+    }
+
+    [[nodiscard]] constexpr std::string_view GetTokenView(const Token& lexer_token) const
+    {
+        [[unlikely]] if (lexer_token.GetType() == TokenType::EndOfFile)
+        {
+            return "";
+        }
+
+        return text_.substr(lexer_token.GetBegin(), lexer_token.GetLength());
+    }
+
+    // Value of the last numeric literal returned by GetToken
+    [[nodiscard]] constexpr const LiteralValue& GetLiteralValue() const noexcept
+        requires(kDecodesLiteralValues)
+    {
+        return literal_value_;
+    }
+
+private:
+    class Batch
+    {
+    public:
+        std::array<Result, batch_size> results;
+        [[no_unique_address]] std::conditional_t<
+            kDecodesLiteralValues,
+            std::array<LiteralValue, batch_size>,
+            std::monostate> values;
+        size_t size = 0;
+    };
+
+    using Queue = SpscQueue<Batch, queue_capacity>;
+
+    // Runs on the lexer thread
+    void Produce(const std::stop_token& stop_token)
+    {
+        LexerType lexer(text_);
+        bool end_of_file = false;
+        while (!end_of_file)
+        {
+            Batch* batch = queue_->TryGetWriteSlot();
+            while (batch == nullptr)
+            {
+                if (stop_token.stop_requested()) return;
+                std::this_thread::yield();
+                batch = queue_->TryGetWriteSlot();
+            }
+
+            size_t size = 0;
+            while (size != batch_size && !end_of_file)
+            {
+                const Result& result = batch->results[size] = lexer.GetToken();
+                if constexpr (kDecodesLiteralValues)
+                {
+                    if (result.has_value() && IsNumericLiteral(result->GetType()))
+                    {
+                        batch->values[size] = lexer.GetLiteralValue();
+                    }
+                }
+
+                end_of_file = result.has_value() && result->GetType() == TokenType::EndOfFile;
+                ++size;
+            }
+
+            batch->size = size;
+            queue_->Publish();
+        }
+    }
+
+    // Gives the current batch back to the lexer thread and waits for the next one
+    void NextBatch() noexcept
+    {
+        if (batch_ != nullptr) queue_->Release();
+
+        batch_ = queue_->TryGetReadSlot();
+        while (batch_ == nullptr)
+        {
+            std::this_thread::yield();
+            batch_ = queue_->TryGetReadSlot();
+        }
+
+        index_ = 0;
+        available_ = batch_->size;
+    }
+
+private:
+    std::string_view text_;
+
+    // Consumer state
+    const Batch* batch_ = nullptr;
+    size_t index_ = 0;
+    size_t available_ = 0;
+    bool finished_ = false;
+    Result end_of_file_;
+    [[no_unique_address]] std::conditional_t<kDecodesLiteralValues, LiteralValue, std::monostate> literal_value_;
+
+    std::unique_ptr<Queue> queue_;
+
+    // The last member: the thread is stopped and joined before the queue is destroyed
+    std::jthread producer_;
+};
+
+}  // namespace kaleidoscope
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace kaleidoscope
+{
+
+// One-based line and column of a character. Columns count bytes.
+class LineColumn
+{
+public:
+    [[nodiscard]] constexpr bool operator==(const LineColumn&) const noexcept = default;
+
+    size_t line = 1;
+    size_t column = 1;
+};
+
+// Maps byte offsets of one text to lines and columns.
+// Offsets of line beginnings are collected lazily: only the part of the text up to the largest
+// queried offset is scanned, so an index that is never queried costs nothing.
+class LineIndex
+{
+public:
+    LineIndex() = default;
+    explicit LineIndex(std::string_view text) : text_(text), size_(text.size()) { assert(size_ <= UINT32_MAX); }
+
+    // Replaces the text with a longer one that starts with the previous text.
+    // Lines found so far are kept, so a growing input can be indexed as it arrives.
+    void ExtendText(std::string_view text)
+    {
+        assert(text_.size() == size_);  // Not after AppendChunk
+        assert(text.size() >= size_ && text.size() <= UINT32_MAX);
+        text_ = text;
+        size_ = text.size();
+    }
+
+    // Appends text that follows everything given before. The chunk is indexed right away and is not kept,
+    // so a stream can be indexed without holding all of it. The index has no text after this.
+    void AppendChunk(std::string_view chunk);
+
+    // offset may be equal to the text size: that is where EndOfFile is reported
+    [[nodiscard]] LineColumn GetLineColumn(size_t offset);
+
+    // Offset of the first character of the one-based line
+    [[nodiscard]] size_t GetLineBegin(size_t line);
+
+    [[nodiscard]] std::string_view GetText() const noexcept { return text_; }
+    [[nodiscard]] size_t GetSize() const noexcept { return size_; }
+
+private:
+    // Scans the text up to end (at least) for line breaks
+    void IndexUntil(size_t end);
+
+private:
+    std::string_view text_;
+    size_t size_ = 0;
+
+    // Offsets where lines begin, in ascending order. Lines that begin after indexed_end_ are not here yet.
+    std::vector<uint32_t> line_begins_{0};
+    size_t indexed_end_ = 0;
+};
+
+using SourceFileId = uint32_t;
+
+// Location of a character in one of the files of SourceIndex packed into 32 bits.
+// Files occupy consecutive ranges of the location space, one extra location per file points past its end.
+class SourceLocation
+{
+public:
+    [[nodiscard]] constexpr bool operator==(const SourceLocation&) const noexcept = default;
+    [[nodiscard]] constexpr auto operator<=>(const SourceLocation&) const noexcept = default;
+
+    uint32_t raw = 0;
+};
+
+static_assert(sizeof(SourceLocation) == 4);
+
+// Source location in a form suitable for diagnostics
+class PresumedLocation
+{
+public:
+    std::string_view file_name;
+    LineColumn line_column;
+};
+
+// Owns line indices of all files of a compilation and converts compact locations back to file, line and column
+class SourceIndex
+{
+public:
+    // Texts must outlive the index
+    [[nodiscard]] SourceFileId AddFile(std::string name, std::string_view text);
+
+    [[nodiscard]] SourceLocation GetLocation(SourceFileId file, size_t offset) const noexcept
+    {
+        assert(offset <= files_[file].lines.GetSize());
+        return {.raw = static_cast<uint32_t>(files_[file].base + offset)};
+    }
+
+    [[nodiscard]] SourceFileId GetFileId(SourceLocation location) const noexcept;
+
+    [[nodiscard]] size_t GetOffset(SourceLocation location) const noexcept
+    {
+        return location.raw - files_[GetFileId(location)].base;
+    }
+
+    [[nodiscard]] PresumedLocation GetPresumedLocation(SourceLocation location);
+
+    [[nodiscard]] std::string_view GetFileName(SourceFileId file) const noexcept { return files_[file].name; }
+    [[nodiscard]] std::string_view GetFileText(SourceFileId file) const noexcept
+    {
+        return files_[file].lines.GetText();
+    }
+
+private:
+    class File
+    {
+    public:
+        std::string name;
+        LineIndex lines;
+        size_t base = 0;
+    };
+
+    std::vector<File> files_;
+    size_t next_base_ = 0;
+};
+
+}  // namespace kaleidoscope
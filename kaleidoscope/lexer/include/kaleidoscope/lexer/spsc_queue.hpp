@@ -0,0 +1,70 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+
+namespace kaleidoscope
+{
+
+// Not std::hardware_destructive_interference_size: its value may differ between translation units
+inline constexpr size_t kCacheLineSize = 64;
+
+// Bounded lock-free queue for exactly one producer thread and one consumer thread.
+// Elements are written and read in place: the producer fills the slot returned by TryGetWriteSlot
+// and then publishes it, the consumer reads the slot returned by TryGetReadSlot and then releases it.
+// Each side keeps its own index and a cached copy of the other side's index on a separate cache line,
+// so the shared indices are only read when the cached copy says the queue is full or empty.
+template <typename T, size_t capacity>
+    requires(std::has_single_bit(capacity))
+class SpscQueue
+{
+public:
+    // Producer side. Returns nullptr if the queue is full.
+    [[nodiscard]] T* TryGetWriteSlot() noexcept
+    {
+        if (producer_.index - producer_.cached_other_index == capacity)
+        {
+            producer_.cached_other_index = read_index_.load(std::memory_order_acquire);
+            if (producer_.index - producer_.cached_other_index == capacity) return nullptr;
+        }
+
+        return &slots_[producer_.index & (capacity - 1)];
+    }
+
+    // Producer side. Makes the slot returned by TryGetWriteSlot visible to the consumer.
+    void Publish() noexcept { write_index_.store(++producer_.index, std::memory_order_release); }
+
+    // Consumer side. Returns nullptr if the queue is empty.
+    [[nodiscard]] const T* TryGetReadSlot() noexcept
+    {
+        if (consumer_.index == consumer_.cached_other_index)
+        {
+            consumer_.cached_other_index = write_index_.load(std::memory_order_acquire);
+            if (consumer_.index == consumer_.cached_other_index) return nullptr;
+        }
+
+        return &slots_[consumer_.index & (capacity - 1)];
+    }
+
+    // Consumer side. Gives the slot returned by TryGetReadSlot back to the producer.
+    void Release() noexcept { read_index_.store(++consumer_.index, std::memory_order_release); }
+
+private:
+    // State owned by one side
+    class SideState
+    {
+    public:
+        size_t index = 0;
+        size_t cached_other_index = 0;
+    };
+
+    alignas(kCacheLineSize) std::atomic<size_t> write_index_ = 0;
+    alignas(kCacheLineSize) std::atomic<size_t> read_index_ = 0;
+    alignas(kCacheLineSize) SideState producer_;
+    alignas(kCacheLineSize) SideState consumer_;
+    alignas(kCacheLineSize) std::array<T, capacity> slots_{};
+};
+
+}  // namespace kaleidoscope
@@ -0,0 +1,410 @@
+#pragma once
+
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "lexer.hpp"
+
+namespace kaleidoscope
+{
+
+// Lexes input that arrives in chunks and produces the same tokens as BasicLexer over the concatenated input.
+//
+// A token is reported only when it cannot be extended by the next chunk. The unfinished token (identifier,
+// number, string literal, comment, error) stays in the internal buffer together with the state of its scanner,
+// and scanning resumes where it stopped once more input arrives, so every byte is scanned about once however
+// the input is split. Consumed input is dropped when it takes at least half of the buffer, so the memory is
+// bounded by about twice the longest token plus the chunk size, and the bytes moved are linear in the input size.
+//
+// Supports the traits of Lexer and LargeFileLexer, with or without trivia.
+template <typename Traits>
+class BasicStreamingLexer
+{
+public:
+    using Token = typename Traits::Token;
+    using Error = typename Traits::Error;
+    using Result = std::expected<Token, Error>;
+
+    static_assert(Traits::kNumberLiteralEngine == NumberLiteralEngine::Dfa);
+    static_assert(!Traits::kDecodeLiteralValues && !Traits::kTrackLineColumn);
+    static_assert(Traits::kErrorMode == LexerErrorMode::Report);
+    static_assert(std::is_void_v<typename Traits::SymbolTableType>);
+
+    constexpr void Feed(std::string_view chunk)
+    {
+        assert(!finished_);
+
+        if (scan_pos_ >= buffer_.size() - scan_pos_)
+        {
+            buffer_.erase(0, scan_pos_);
+            buffer_offset_ += scan_pos_;
+            resume_pos_ -= std::min(resume_pos_, scan_pos_);
+            scan_pos_ = 0;
+        }
+
+        buffer_.append(chunk);
+        assert(buffer_offset_ + buffer_.size() <= Token::kMaxOffset);
+    }
+
+    // Marks the end of input. After that GetToken always returns a value and finally EndOfFile.
+    constexpr void Finish() noexcept { finished_ = true; }
+
+    // Returns std::nullopt if the next token may continue in the next chunk
+    [[nodiscard]] constexpr std::optional<Result> GetToken()
+    {
+        while (true)
+        {
+            if (partial_ == PartialToken::None)
+            {
+                // Spaces before the unfinished token can be dropped right away
+                scan_pos_ = Scan(scan_pos_, CharClass::Space);
+                if (scan_pos_ == buffer_.size())
+                {
+                    if (!finished_) return std::nullopt;
+                    return MakeToken(TokenType::EndOfFile, scan_pos_, scan_pos_);
+                }
+
+                if (std::optional<Result> result = StartToken()) return result;
+            }
+
+            if (std::optional<Result> result = ContinueToken()) return result;
+
+            // Otherwise the token waits for more input or a comment was skipped
+            if (partial_ != PartialToken::None) return std::nullopt;
+        }
+    }
+
+    // The view is valid until the next call to Feed
+    [[nodiscard]] constexpr std::string_view GetTokenView(const Token& token) const
+    {
+        [[unlikely]] if (token.GetType() == TokenType::EndOfFile)
+        {
+            return "";
+        }
+
+        return GetRangeView(token.GetBegin(), token.GetLength());
+    }
+
+    // The view is valid until the next call to Feed
+    [[nodiscard]] constexpr std::string_view GetErrorView(const Error& error) const
+    {
+        return GetRangeView(error.GetBegin(), error.GetLength());
+    }
+
+    // Number of bytes of the unfinished token and the input after it
+    [[nodiscard]] constexpr size_t GetBufferedSize() const noexcept { return buffer_.size() - scan_pos_; }
+
+    // Number of bytes examined so far. Close to the input size, however small the chunks are.
+    [[nodiscard]] constexpr size_t GetScannedSize() const noexcept { return scanned_size_; }
+
+private:
+    using Lexer = BasicLexer<Traits>;
+
+    // Token that has been started but may continue in the next chunk
+    enum class PartialToken : uint8_t
+    {
+        None,
+        Identifier,
+        Number,
+        StringLiteral,
+
+        // '/' that may start a comment
+        Slash,
+        Comment,
+        BlockComment,
+
+        // Characters up to the next space that belong to an error (see error_type_)
+        ErrorTail,
+    };
+
+    [[nodiscard]] static constexpr bool IsOneOf(char c, const ass::FixedBitset<256>& chars) noexcept
+    {
+        return chars.Get(std::bit_cast<uint8_t>(c));
+    }
+
+    [[nodiscard]] constexpr std::string_view GetRangeView(size_t begin, size_t length) const
+    {
+        assert(begin >= buffer_offset_);
+        return std::string_view{buffer_}.substr(begin - buffer_offset_, length);
+    }
+
+    // Results take positions in buffer_
+    [[nodiscard]] constexpr Result MakeToken(TokenType type, size_t begin, size_t end) const noexcept
+    {
+        return Lexer::MakeToken(type, buffer_offset_ + begin, buffer_offset_ + end);
+    }
+
+    [[nodiscard]] constexpr Result MakeError(LexerErrorType type, size_t begin, size_t end) const noexcept
+    {
+        return Lexer::MakeError(type, buffer_offset_ + begin, buffer_offset_ + end);
+    }
+
+    [[nodiscard]] constexpr size_t Scan(size_t pos, CharClass char_class) noexcept
+    {
+        const size_t end = ScanCharClass(buffer_, pos, char_class);
+        scanned_size_ += end - pos;
+        return end;
+    }
+
+    // The partial token ends at end
+    [[nodiscard]] constexpr std::optional<Result> Complete(size_t end, const Result& result) noexcept
+    {
+        partial_ = PartialToken::None;
+        scan_pos_ = end;
+        return result;
+    }
+
+    // The partial token is a comment that is not reported
+    [[nodiscard]] constexpr std::optional<Result> Skip(size_t end) noexcept
+    {
+        partial_ = PartialToken::None;
+        scan_pos_ = end;
+        return std::nullopt;
+    }
+
+    // The partial token needs more input. Scanning resumes at pos.
+    [[nodiscard]] constexpr std::optional<Result> Wait(size_t pos) noexcept
+    {
+        resume_pos_ = pos;
+        return std::nullopt;
+    }
+
+    // Picks the token kind by the character at scan_pos_ in the same order as BasicLexer.
+    // Operators are returned right away, other tokens become partial.
+    [[nodiscard]] constexpr std::optional<Result> StartToken() noexcept
+    {
+        const size_t begin = scan_pos_;
+        const char c = buffer_[begin];
+
+        resume_pos_ = begin + 1;
+        if (IsOneOf(c, kIdentifierHeadChars))
+        {
+            partial_ = PartialToken::Identifier;
+        }
+        else if (IsOneOf(c, kDigits) || c == '.')
+        {
+            partial_ = PartialToken::Number;
+            number_state_ = NumberDfaState::Start;
+            resume_pos_ = begin;
+        }
+        else if (c == '"')
+        {
+            partial_ = PartialToken::StringLiteral;
+        }
+        else if (c == '/')
+        {
+            partial_ = PartialToken::Slash;
+        }
+        else if (const TokenType* op_type = kOperatorSymbolLookup.Find(c))
+        {
+            return Complete(begin + 1, MakeToken(*op_type, begin, begin + 1));
+        }
+        else
+        {
+            partial_ = PartialToken::ErrorTail;
+            error_type_ = LexerErrorType::UnexpectedSymbol;
+            resume_pos_ = begin;
+        }
+
+        return std::nullopt;
+    }
+
+    [[nodiscard]] constexpr std::optional<Result> ContinueToken() noexcept
+    {
+        switch (partial_)
+        {
+        case PartialToken::Identifier:
+            return ContinueIdentifier();
+        case PartialToken::Number:
+            return ContinueNumber();
+        case PartialToken::StringLiteral:
+            return ContinueStringLiteral();
+        case PartialToken::Slash:
+            return ContinueSlash();
+        case PartialToken::Comment:
+            return ContinueComment();
+        case PartialToken::BlockComment:
+            return ContinueBlockComment();
+        case PartialToken::ErrorTail:
+            return ContinueErrorTail();
+        case PartialToken::None:
+            break;
+        }
+
+        assert(false);
+        return std::nullopt;
+    }
+
+    [[nodiscard]] constexpr std::optional<Result> ContinueIdentifier() noexcept
+    {
+        const size_t end = Scan(resume_pos_, CharClass::IdentifierTail);
+        if (end == buffer_.size() && !finished_) return Wait(end);
+
+        const std::string_view name = std::string_view{buffer_}.substr(scan_pos_, end - scan_pos_);
+        const TokenType* keyword_type = kKeywordLookup.Find(name);
+        const TokenType type = keyword_type != nullptr ? *keyword_type : TokenType::Identifier;
+        return Complete(end, MakeToken(type, scan_pos_, end));
+    }
+
+    // Runs the number literal automaton over the new characters, from the state where it stopped
+    [[nodiscard]] constexpr std::optional<Result> ContinueNumber() noexcept
+    {
+        size_t pos = resume_pos_;
+        for (; pos != buffer_.size(); ++pos)
+        {
+            number_state_ = kNumberLiteralDfa.GetNextState(number_state_, buffer_[pos]);
+            if (IsFinalNumberDfaState(number_state_)) break;
+        }
+
+        scanned_size_ += pos - resume_pos_;
+        if (!IsFinalNumberDfaState(number_state_))
+        {
+            if (!finished_) return Wait(pos);
+            number_state_ = kNumberLiteralDfa.GetEndState(number_state_);
+        }
+
+        const auto outcome = GetNumberDfaOutcome(number_state_);
+        if (outcome.has_value()) return Complete(pos, MakeToken(*outcome, scan_pos_, pos));
+
+        partial_ = PartialToken::ErrorTail;
+        error_type_ = outcome.error();
+        resume_pos_ = pos;
+        return ContinueErrorTail();
+    }
+
+    [[nodiscard]] constexpr std::optional<Result> ContinueStringLiteral() noexcept
+    {
+        constexpr LexerErrorType kUnterminated = LexerErrorType::MissingTerminatingCharacterForStringLiteral;
+
+        size_t pos = resume_pos_;
+        while (true)
+        {
+            pos = Scan(pos, CharClass::StringLiteralBody);
+            if (pos == buffer_.size())
+            {
+                if (!finished_) return Wait(pos);
+                return Complete(pos, MakeError(kUnterminated, scan_pos_, pos));
+            }
+
+            switch (buffer_[pos])
+            {
+            case '\n':
+                return Complete(pos, MakeError(kUnterminated, scan_pos_, pos));
+            case '\\':
+                // The backslash is scanned again when the next character arrives
+                if (pos + 1 == buffer_.size() && !finished_) return Wait(pos);
+                pos += (pos + 1 != buffer_.size() && buffer_[pos + 1] == '"') ? 2uz : 1uz;
+                break;
+            case '"':
+                return Complete(pos + 1, MakeToken(TokenType::StringLiteral, scan_pos_, pos + 1));
+            }
+        }
+    }
+
+    [[nodiscard]] constexpr std::optional<Result> ContinueSlash() noexcept
+    {
+        const size_t next = scan_pos_ + 1;
+        if (next == buffer_.size() && !finished_) return Wait(next);
+
+        if (next != buffer_.size() && buffer_[next] == '/')
+        {
+            partial_ = PartialToken::Comment;
+            resume_pos_ = next + 1;
+            return ContinueComment();
+        }
+
+        if (next != buffer_.size() && buffer_[next] == '*')
+        {
+            partial_ = PartialToken::BlockComment;
+            resume_pos_ = next + 1;
+            return ContinueBlockComment();
+        }
+
+        return Complete(next, MakeToken(TokenType::ForwardSlash, scan_pos_, next));
+    }
+
+    [[nodiscard]] constexpr std::optional<Result> ContinueComment() noexcept
+    {
+        const size_t end = Scan(resume_pos_, CharClass::LineCommentBody);
+        if (end == buffer_.size() && !finished_) return Wait(end);
+
+        if constexpr (Lexer::kEmitsTrivia)
+        {
+            return Complete(end, MakeToken(TokenType::Comment, scan_pos_, end));
+        }
+        else
+        {
+            return Skip(end);
+        }
+    }
+
+    // Jumps from one '*' to another until it is followed by '/'
+    [[nodiscard]] constexpr std::optional<Result> ContinueBlockComment() noexcept
+    {
+        size_t pos = resume_pos_;
+        while (true)
+        {
+            pos = Scan(pos, CharClass::BlockCommentBody);
+            if (pos == buffer_.size() || pos + 1 == buffer_.size())
+            {
+                // The last '*' is scanned again when the next character arrives
+                if (!finished_) return Wait(pos);
+                const size_t end = buffer_.size();
+                return Complete(end, MakeError(LexerErrorType::UnterminatedBlockComment, scan_pos_, end));
+            }
+
+            ++pos;
+            if (buffer_[pos] == '/') break;
+        }
+
+        const size_t end = pos + 1;
+        if constexpr (Lexer::kEmitsTrivia)
+        {
+            return Complete(end, MakeToken(TokenType::BlockComment, scan_pos_, end));
+        }
+        else
+        {
+            return Skip(end);
+        }
+    }
+
+    [[nodiscard]] constexpr std::optional<Result> ContinueErrorTail() noexcept
+    {
+        size_t pos = resume_pos_;
+        while (pos != buffer_.size() && !IsOneOf(buffer_[pos], kSpaceChars)) ++pos;
+
+        scanned_size_ += pos - resume_pos_;
+        if (pos == buffer_.size() && !finished_) return Wait(pos);
+        return Complete(pos, MakeError(error_type_, scan_pos_, pos));
+    }
+
+private:
+    std::string buffer_;
+
+    // Offset of buffer_[0] in the whole input
+    size_t buffer_offset_ = 0;
+
+    // Position in buffer_ where the next token (or the partial one) begins
+    size_t scan_pos_ = 0;
+
+    // Position in buffer_ where scanning of the partial token continues
+    size_t resume_pos_ = 0;
+
+    size_t scanned_size_ = 0;
+
+    PartialToken partial_ = PartialToken::None;
+    NumberDfaState number_state_ = NumberDfaState::Start;
+    LexerErrorType error_type_ = LexerErrorType::UnexpectedSymbol;
+
+    bool finished_ = false;
+};
+
+using StreamingLexer = BasicStreamingLexer<CompactLexerTraits>;
+using LargeFileStreamingLexer = BasicStreamingLexer<LargeFileLexerTraits>;
+
+}  // namespace kaleidoscope
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "bytes.hpp"
+
+namespace kaleidoscope
+{
+
+// Dense index of an interned string: symbols get ids 0, 1, 2, ... in the order they are interned
+using SymbolId = uint32_t;
+
+// Hash of an identifier, 8 bytes per step. Identifiers are short and the lexer hashes each one
+// right after scanning it, while its bytes are still in L1.
+[[nodiscard]] constexpr uint64_t HashIdentifier(std::string_view name) noexcept
+{
+    constexpr uint64_t kMul = 0x9E3779B97F4A7C15;
+
+    uint64_t hash = name.size() * kMul;
+    size_t i = 0;
+    for (; i + 8 <= name.size(); i += 8)
+    {
+        hash = (hash ^ LoadEightChars(name.data() + i)) * kMul;
+        hash ^= hash >> 32;
+    }
+
+    if (i != name.size())
+    {
+        uint64_t tail = 0;
+        for (size_t j = i; j != name.size(); ++j)
+        {
+            tail |= uint64_t{std::bit_cast<uint8_t>(name[j])} << ((j - i) * 8);
+        }
+
+        hash = (hash ^ tail) * kMul;
+        hash ^= hash >> 32;
+    }
+
+    return hash;
+}
+
+// Copies strings into large blocks, so interned names do not depend on the lifetime of sources
+// and are not allocated one by one. Strings never move.
+class StringArena
+{
+public:
+    [[nodiscard]] std::string_view Store(std::string_view s);
+
+private:
+    static constexpr size_t kBlockSize = size_t{1} << 16;
+
+    std::vector<std::unique_ptr<char[]>> blocks_;  // NOLINT
+    size_t block_used_ = kBlockSize;
+};
+
+// Slot of the open-addressed index of symbol tables. Keeps the lower half of the hash:
+// it gives the position on rehash and lets probes compare strings only on a likely match.
+class SymbolSlot
+{
+public:
+    // 0 is an empty slot, otherwise SymbolId + 1
+    uint32_t id_plus_one = 0;
+    uint32_t hash = 0;
+};
+
+// Maps identifiers to dense SymbolIds. Open addressing with linear probing over a power-of-two table.
+class SymbolTable
+{
+public:
+    SymbolTable();
+
+    [[nodiscard]] SymbolId Intern(std::string_view name) { return Intern(name, HashIdentifier(name)); }
+
+    // hash must be HashIdentifier(name)
+    [[nodiscard]] SymbolId Intern(std::string_view name, uint64_t hash);
+
+    [[nodiscard]] std::string_view GetName(SymbolId id) const noexcept { return names_[id]; }
+    [[nodiscard]] size_t Size() const noexcept { return names_.size(); }
+
+private:
+    std::vector<SymbolSlot> slots_;
+    std::vector<std::string_view> names_;
+    StringArena arena_;
+};
+
+// SymbolTable that can be shared by parallel lexing and parsing workers.
+// Symbols are distributed over shards by hash, each shard has its own lock, so workers only wait
+// for each other when they intern names of the same shard at the same time. GetName takes no lock.
+class ConcurrentSymbolTable
+{
+public:
+    ConcurrentSymbolTable();
+    ~ConcurrentSymbolTable();
+
+    ConcurrentSymbolTable(const ConcurrentSymbolTable&) = delete;
+    ConcurrentSymbolTable& operator=(const ConcurrentSymbolTable&) = delete;
+
+    [[nodiscard]] SymbolId Intern(std::string_view name) { return Intern(name, HashIdentifier(name)); }
+    [[nodiscard]] SymbolId Intern(std::string_view name, uint64_t hash);
+
+    // The id must come from Intern on this thread or be passed from the interning thread
+    // with proper synchronization (like joining the thread)
+    [[nodiscard]] std::string_view GetName(SymbolId id) const noexcept;
+
+    [[nodiscard]] size_t Size() const noexcept { return next_id_.load(std::memory_order_acquire); }
+
+private:
+    static constexpr size_t kShardCount = 64;
+
+    // Names are stored in segments that double in size, so existing entries never move
+    static constexpr size_t kFirstSegmentSize = 1024;
+    static constexpr size_t kSegmentCount = 23;
+
+    class Shard;
+
+    [[nodiscard]] static std::pair<size_t, size_t> GetSegmentAndOffset(SymbolId id) noexcept;
+    void StoreName(SymbolId id, std::string_view name);
+
+private:
+    std::unique_ptr<Shard[]> shards_;  // NOLINT
+    std::array<std::atomic<std::string_view*>, kSegmentCount> segments_{};
+    std::atomic<SymbolId> next_id_ = 0;
+};
+
+}  // namespace kaleidoscope
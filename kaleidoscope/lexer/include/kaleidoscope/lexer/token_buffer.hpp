@@ -0,0 +1,146 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "lexer.hpp"
+
+namespace kaleidoscope
+{
+
+class TokenBufferError
+{
+public:
+    [[nodiscard]] constexpr bool operator==(const TokenBufferError&) const noexcept = default;
+
+    LexerError error;
+
+    // Index of the token that follows this error in the token stream
+    uint32_t token_index = 0;
+};
+
+// Replacement of removed_length bytes at offset with inserted_length bytes
+class TextEdit
+{
+public:
+    size_t offset = 0;
+    size_t removed_length = 0;
+    size_t inserted_length = 0;
+};
+
+// Lexes the whole source at once and stores tokens as struct-of-arrays.
+// Errors do not occupy token slots, they are kept in a separate list.
+// The last token is always EndOfFile.
+class TokenBuffer
+{
+public:
+    constexpr TokenBuffer() = default;
+    constexpr explicit TokenBuffer(std::string_view text) { Tokenize(text); }
+
+    // Replaces the contents with tokens of the text.
+    // Keeps already allocated memory, so the same buffer can be reused for many sources.
+    constexpr void Tokenize(std::string_view text)
+    {
+        assert(text.size() <= LexerToken::kMaxOffset);
+
+        Clear();
+        text_ = text;
+        [[maybe_unused]] const size_t end_pos = LexRange(0, text.size());
+    }
+
+    // Same result as Tokenize but the text is split into chunks which are lexed on separate threads.
+    // Chunk boundaries may land inside tokens, string literals or comments. Chunks are lexed speculatively
+    // and then merged in order: the tokens of a chunk are accepted starting from the first one that begins
+    // where the true token stream continues. Until such a token is found the text is lexed sequentially.
+    void TokenizeParallel(std::string_view text, size_t thread_count);
+
+    // Updates tokens after the text was edited. new_text is the whole text with the edit applied.
+    // Lexing restarts after the last token that ends before the edit and stops as soon as a new token begins
+    // where an old token began after the edit. Old tokens from that point on are kept, only their offsets
+    // are shifted. The result is the same as Tokenize(new_text).
+    void ApplyEdit(std::string_view new_text, const TextEdit& edit);
+
+    constexpr void Clear() noexcept
+    {
+        text_ = {};
+        types_.clear();
+        begins_.clear();
+        lengths_.clear();
+        errors_.clear();
+    }
+
+    [[nodiscard]] constexpr size_t Size() const noexcept { return types_.size(); }
+
+    [[nodiscard]] constexpr TokenType GetType(size_t index) const noexcept { return types_[index]; }
+    [[nodiscard]] constexpr uint32_t GetBegin(size_t index) const noexcept { return begins_[index]; }
+    [[nodiscard]] constexpr uint32_t GetLength(size_t index) const noexcept { return lengths_[index]; }
+
+    [[nodiscard]] constexpr LexerToken GetToken(size_t index) const noexcept
+    {
+        return LexerToken(types_[index], begins_[index], size_t{begins_[index]} + lengths_[index]);
+    }
+
+    [[nodiscard]] constexpr std::string_view GetTokenView(size_t index) const noexcept
+    {
+        return text_.substr(begins_[index], lengths_[index]);
+    }
+
+    [[nodiscard]] constexpr std::span<const TokenType> GetTypes() const noexcept { return types_; }
+    [[nodiscard]] constexpr std::span<const uint32_t> GetBegins() const noexcept { return begins_; }
+    [[nodiscard]] constexpr std::span<const uint32_t> GetLengths() const noexcept { return lengths_; }
+    [[nodiscard]] constexpr std::span<const TokenBufferError> GetErrors() const noexcept { return errors_; }
+    [[nodiscard]] constexpr std::string_view GetText() const noexcept { return text_; }
+
+private:
+    constexpr void AppendResult(const LexerResult& result)
+    {
+        if (!result.has_value())
+        {
+            errors_.push_back({
+                .error = result.error(),
+                .token_index = static_cast<uint32_t>(types_.size()),
+            });
+            return;
+        }
+
+        const LexerToken& token = *result;
+        types_.push_back(token.GetType());
+        begins_.push_back(static_cast<uint32_t>(token.GetBegin()));
+        lengths_.push_back(static_cast<uint32_t>(token.GetLength()));
+    }
+
+    // Lexes text_ starting at begin and appends results until one begins at or after end.
+    // EndOfFile is always appended. Returns the lexer position after the last appended result.
+    constexpr size_t LexRange(size_t begin, size_t end)
+    {
+        Lexer lexer(text_, begin);
+        size_t pos = begin;
+        while (true)
+        {
+            const LexerResult result = lexer.GetToken();
+            const bool is_eof = result.has_value() && result->GetType() == TokenType::EndOfFile;
+            const size_t result_begin = result.has_value() ? result->GetBegin() : result.error().GetBegin();
+            if (result_begin >= end && !is_eof) return pos;
+
+            AppendResult(result);
+            pos = lexer.GetPosition();
+
+            if (is_eof) return pos;
+        }
+    }
+
+    // Appends tokens of another buffer starting at first_token together with errors that follow them
+    void AppendTokens(const TokenBuffer& other, size_t first_token);
+
+private:
+    std::string_view text_;
+    std::vector<TokenType> types_;
+    std::vector<uint32_t> begins_;
+    std::vector<uint32_t> lengths_;
+    std::vector<TokenBufferError> errors_;
+};
+
+}  // namespace kaleidoscope
@@ -0,0 +1,244 @@
+#include "kaleidoscope/lexer/char_class_scan.hpp"
+
+#if KALEIDOSCOPE_LEXER_X86_SIMD
+#include <immintrin.h>
+#endif
+
+namespace kaleidoscope
+{
+
+#if KALEIDOSCOPE_LEXER_X86_SIMD
+
+namespace
+{
+
+// The vector classifiers below encode character classes as byte ranges.
+// Make sure they describe exactly the same sets as the lexer bitsets.
+[[nodiscard]] constexpr bool IsSpaceByRanges(uint8_t c)
+{
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+[[nodiscard]] constexpr bool IsIdentifierTailByRanges(uint8_t c)
+{
+    const auto lower = static_cast<uint8_t>(c | 0x20);
+    return (lower >= 'a' && lower <= 'z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+// Classes that contain everything except a few delimiters are classified by comparing against each delimiter
+template <CharClass char_class>
+inline constexpr std::string_view kDelimiters = "";
+
+template <>
+inline constexpr std::string_view kDelimiters<CharClass::LineCommentBody> = "\n";
+
+template <>
+inline constexpr std::string_view kDelimiters<CharClass::BlockCommentBody> = "*";
+
+template <>
+inline constexpr std::string_view kDelimiters<CharClass::StringLiteralBody> = "\"\\\n";
+
+template <CharClass char_class>
+[[nodiscard]] constexpr bool IsBodyByDelimiters(uint8_t c)
+{
+    return !kDelimiters<char_class>.contains(std::bit_cast<char>(c));
+}
+
+static_assert(
+    []
+    {
+        for (size_t i = 0; i != 256; ++i)
+        {
+            const auto c = static_cast<uint8_t>(i);
+            if (IsSpaceByRanges(c) != kSpaceChars.Get(i)) return false;
+            if (IsIdentifierTailByRanges(c) != kIdentifierTailChars.Get(i)) return false;
+            if (IsBodyByDelimiters<CharClass::LineCommentBody>(c) != kLineCommentBodyChars.Get(i)) return false;
+            if (IsBodyByDelimiters<CharClass::BlockCommentBody>(c) != kBlockCommentBodyChars.Get(i)) return false;
+            if (IsBodyByDelimiters<CharClass::StringLiteralBody>(c) != kStringLiteralBodyChars.Get(i)) return false;
+        }
+        return true;
+    }());
+
+// Sets all bits of a lane if first <= lane <= last (unsigned comparison)
+[[nodiscard]] inline __m128i InRange128(__m128i chars, char first, char last)
+{
+    const __m128i shifted = _mm_sub_epi8(chars, _mm_set1_epi8(first));
+    return _mm_cmpeq_epi8(_mm_min_epu8(shifted, _mm_set1_epi8(static_cast<char>(last - first))), shifted);
+}
+
+template <CharClass char_class>
+[[nodiscard]] inline __m128i NotDelimiter128(__m128i chars)
+{
+    __m128i delimiters = _mm_setzero_si128();
+    for (const char delimiter : kDelimiters<char_class>)
+    {
+        delimiters = _mm_or_si128(delimiters, _mm_cmpeq_epi8(chars, _mm_set1_epi8(delimiter)));
+    }
+
+    return _mm_xor_si128(delimiters, _mm_set1_epi8(-1));
+}
+
+template <CharClass char_class>
+[[nodiscard]] inline __m128i Classify128(__m128i chars)
+{
+    if constexpr (!kDelimiters<char_class>.empty())
+    {
+        return NotDelimiter128<char_class>(chars);
+    }
+    else if constexpr (char_class == CharClass::Space)
+    {
+        return _mm_or_si128(_mm_cmpeq_epi8(chars, _mm_set1_epi8(' ')), InRange128(chars, '\t', '\r'));
+    }
+    else
+    {
+        const __m128i letters = InRange128(_mm_or_si128(chars, _mm_set1_epi8(0x20)), 'a', 'z');
+        const __m128i digits = InRange128(chars, '0', '9');
+        return _mm_or_si128(_mm_or_si128(letters, digits), _mm_cmpeq_epi8(chars, _mm_set1_epi8('_')));
+    }
+}
+
+template <CharClass char_class>
+[[nodiscard]] size_t Scan128(std::string_view text, size_t pos)
+{
+    constexpr size_t kWidth = 16;
+    while (text.size() - pos >= kWidth)
+    {
+        const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text.data() + pos));  // NOLINT
+        const auto mask = static_cast<uint32_t>(_mm_movemask_epi8(Classify128<char_class>(chars)));
+        if (mask != 0xFFFF)
+        {
+            return pos + static_cast<size_t>(std::countr_one(mask));
+        }
+
+        pos += kWidth;
+    }
+
+    return ScanCharClassScalar(text, pos, char_class);
+}
+
+// AVX2 versions of the functions above. Every function on this path carries the target attribute
+// so that the compiler can inline them into each other without enabling AVX2 for the whole binary.
+[[nodiscard]] __attribute__((target("avx2"))) inline __m256i InRange256(__m256i chars, char first, char last)
+{
+    const __m256i shifted = _mm256_sub_epi8(chars, _mm256_set1_epi8(first));
+    return _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, _mm256_set1_epi8(static_cast<char>(last - first))), shifted);
+}
+
+template <CharClass char_class>
+[[nodiscard]] __attribute__((target("avx2"))) inline __m256i NotDelimiter256(__m256i chars)
+{
+    __m256i delimiters = _mm256_setzero_si256();
+    for (const char delimiter : kDelimiters<char_class>)
+    {
+        delimiters = _mm256_or_si256(delimiters, _mm256_cmpeq_epi8(chars, _mm256_set1_epi8(delimiter)));
+    }
+
+    return _mm256_xor_si256(delimiters, _mm256_set1_epi8(-1));
+}
+
+template <CharClass char_class>
+[[nodiscard]] __attribute__((target("avx2"))) inline __m256i Classify256(__m256i chars)
+{
+    if constexpr (!kDelimiters<char_class>.empty())
+    {
+        return NotDelimiter256<char_class>(chars);
+    }
+    else if constexpr (char_class == CharClass::Space)
+    {
+        return _mm256_or_si256(_mm256_cmpeq_epi8(chars, _mm256_set1_epi8(' ')), InRange256(chars, '\t', '\r'));
+    }
+    else
+    {
+        const __m256i letters = InRange256(_mm256_or_si256(chars, _mm256_set1_epi8(0x20)), 'a', 'z');
+        const __m256i digits = InRange256(chars, '0', '9');
+        const __m256i underscore = _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('_'));
+        return _mm256_or_si256(_mm256_or_si256(letters, digits), underscore);
+    }
+}
+
+template <CharClass char_class>
+[[nodiscard]] __attribute__((target("avx2"))) size_t Scan256(std::string_view text, size_t pos)
+{
+    constexpr size_t kWidth = 32;
+    while (text.size() - pos >= kWidth)
+    {
+        const __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text.data() + pos));  // NOLINT
+        const auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(Classify256<char_class>(chars)));
+        if (mask != 0xFFFFFFFF)
+        {
+            return pos + static_cast<size_t>(std::countr_one(mask));
+        }
+
+        pos += kWidth;
+    }
+
+    return ScanCharClassScalar(text, pos, char_class);
+}
+
+}  // namespace
+
+size_t ScanCharClassSSE2(std::string_view text, size_t pos, CharClass char_class) noexcept
+{
+    switch (char_class)
+    {
+    case CharClass::Space:
+        return Scan128<CharClass::Space>(text, pos);
+    case CharClass::IdentifierTail:
+        return Scan128<CharClass::IdentifierTail>(text, pos);
+    case CharClass::LineCommentBody:
+        return Scan128<CharClass::LineCommentBody>(text, pos);
+    case CharClass::BlockCommentBody:
+        return Scan128<CharClass::BlockCommentBody>(text, pos);
+    case CharClass::StringLiteralBody:
+        return Scan128<CharClass::StringLiteralBody>(text, pos);
+    }
+
+    return ScanCharClassScalar(text, pos, char_class);
+}
+
+__attribute__((target("avx2"))) size_t
+ScanCharClassAVX2(std::string_view text, size_t pos, CharClass char_class) noexcept
+{
+    switch (char_class)
+    {
+    case CharClass::Space:
+        return Scan256<CharClass::Space>(text, pos);
+    case CharClass::IdentifierTail:
+        return Scan256<CharClass::IdentifierTail>(text, pos);
+    case CharClass::LineCommentBody:
+        return Scan256<CharClass::LineCommentBody>(text, pos);
+    case CharClass::BlockCommentBody:
+        return Scan256<CharClass::BlockCommentBody>(text, pos);
+    case CharClass::StringLiteralBody:
+        return Scan256<CharClass::StringLiteralBody>(text, pos);
+    }
+
+    return ScanCharClassScalar(text, pos, char_class);
+}
+
+bool IsAVX2Supported() noexcept
+{
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+
+size_t ScanCharClassVectorized(std::string_view text, size_t pos, CharClass char_class) noexcept
+{
+    if (IsAVX2Supported())
+    {
+        return ScanCharClassAVX2(text, pos, char_class);
+    }
+
+    return ScanCharClassSSE2(text, pos, char_class);
+}
+
+#else
+
+size_t ScanCharClassVectorized(std::string_view text, size_t pos, CharClass char_class) noexcept
+{
+    return ScanCharClassScalar(text, pos, char_class);
+}
+
+#endif
+
+}  // namespace kaleidoscope
@@ -0,0 +1,29 @@
+#include "kaleidoscope/lexer/literal_decoder.hpp"
+
+#include <cmath>
+
+#include "fast_float/fast_float.h"
+
+namespace kaleidoscope
+{
+
+std::expected<double, LexerErrorType> DecodeFloatLiteral(std::string_view text) noexcept
+{
+    double value = 0.0;
+    const auto [ptr, ec] = fast_float::from_chars(text.data(), text.data() + text.size(), value);
+
+    if (ec == std::errc::invalid_argument || ptr != text.data() + text.size())
+    {
+        return std::unexpected(LexerErrorType::UnexpectedSymbol);
+    }
+
+    // Values that are too small to be represented are rounded to zero which is fine for a literal
+    if (ec == std::errc::result_out_of_range && std::isinf(value))
+    {
+        return std::unexpected(LexerErrorType::FloatLiteralOutOfRange);
+    }
+
+    return value;
+}
+
+}  // namespace kaleidoscope
@@ -0,0 +1,136 @@
+#include "kaleidoscope/lexer/source_index.hpp"
+
+#include <algorithm>
+#include <bit>
+
+#include "kaleidoscope/lexer/char_class_scan.hpp"
+
+#if KALEIDOSCOPE_LEXER_X86_SIMD
+#include <immintrin.h>
+#endif
+
+namespace kaleidoscope
+{
+
+namespace
+{
+
+// Indexing a few bytes per query would make a series of ascending queries slow
+constexpr size_t kMinIndexStep = size_t{1} << 16;
+
+// Appends offsets that follow line breaks in [begin, end). base is the offset of the text.
+void AppendLineBegins(
+    std::string_view text,
+    size_t begin,
+    size_t end,
+    size_t base,
+    std::vector<uint32_t>& line_begins)
+{
+    size_t pos = begin;
+
+#if KALEIDOSCOPE_LEXER_X86_SIMD
+    // Line breaks are rare, so most blocks produce an empty mask
+    constexpr size_t kWidth = 16;
+    const __m128i newline = _mm_set1_epi8('\n');
+    for (; end - pos >= kWidth; pos += kWidth)
+    {
+        const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text.data() + pos));  // NOLINT
+        auto mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chars, newline)));
+        for (; mask != 0; mask &= mask - 1)
+        {
+            const size_t offset = base + pos + static_cast<size_t>(std::countr_zero(mask));
+            line_begins.push_back(static_cast<uint32_t>(offset + 1));
+        }
+    }
+#endif
+
+    for (; pos != end; ++pos)
+    {
+        if (text[pos] == '\n') line_begins.push_back(static_cast<uint32_t>(base + pos + 1));
+    }
+}
+
+}  // namespace
+
+void LineIndex::IndexUntil(size_t end)
+{
+    if (end <= indexed_end_) return;
+
+    end = std::min(text_.size(), std::max(end, indexed_end_ + kMinIndexStep));
+    AppendLineBegins(text_, indexed_end_, end, 0, line_begins_);
+    indexed_end_ = end;
+}
+
+void LineIndex::AppendChunk(std::string_view chunk)
+{
+    assert(size_ + chunk.size() <= UINT32_MAX);
+
+    // The text given before is not needed once it is indexed
+    IndexUntil(size_);
+    AppendLineBegins(chunk, 0, chunk.size(), size_, line_begins_);
+    text_ = {};
+    size_ += chunk.size();
+    indexed_end_ = size_;
+}
+
+LineColumn LineIndex::GetLineColumn(size_t offset)
+{
+    assert(offset <= size_);
+
+    // A line that begins at offset is known once the line break before it is indexed
+    IndexUntil(offset);
+
+    const auto it = std::ranges::upper_bound(line_begins_, offset);
+    const auto line = static_cast<size_t>(std::distance(line_begins_.begin(), it));
+    return {
+        .line = line,
+        .column = offset - line_begins_[line - 1] + 1,
+    };
+}
+
+size_t LineIndex::GetLineBegin(size_t line)
+{
+    assert(line != 0);
+
+    while (line_begins_.size() < line && indexed_end_ != size_)
+    {
+        IndexUntil(indexed_end_ + 1);
+    }
+
+    assert(line <= line_begins_.size());
+    return line_begins_[line - 1];
+}
+
+SourceFileId SourceIndex::AddFile(std::string name, std::string_view text)
+{
+    const auto id = static_cast<SourceFileId>(files_.size());
+    files_.push_back({
+        .name = std::move(name),
+        .lines = LineIndex(text),
+        .base = next_base_,
+    });
+
+    // One more location for the end of file
+    next_base_ += text.size() + 1;
+    assert(next_base_ <= size_t{UINT32_MAX} + 1);
+
+    return id;
+}
+
+SourceFileId SourceIndex::GetFileId(SourceLocation location) const noexcept
+{
+    const auto it = std::ranges::upper_bound(files_, size_t{location.raw}, std::less{}, &File::base);
+    assert(it != files_.begin());
+    return static_cast<SourceFileId>(std::distance(files_.begin(), it) - 1);
+}
+
+PresumedLocation SourceIndex::GetPresumedLocation(SourceLocation location)
+{
+    File& file = files_[GetFileId(location)];
+    return {
+        .file_name = file.name,
+        .line_column = file.lines.GetLineColumn(location.raw - file.base),
+    };
+}
+
+}  // namespace kaleidoscope
@@ -0,0 +1,176 @@
+#include "kaleidoscope/lexer/symbol_table.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace kaleidoscope
+{
+
+namespace
+{
+
+constexpr size_t kInitialSlotCount = 1024;
+
+// Grow when the table is 3/4 full
+[[nodiscard]] constexpr bool NeedsGrow(size_t size, size_t slot_count) noexcept
+{
+    return (size + 1) * 4 > slot_count * 3;
+}
+
+// Returns the slot that holds the name or the empty slot where it should be inserted
+template <typename GetName>
+[[nodiscard]] SymbolSlot& FindSlot(std::vector<SymbolSlot>& slots, std::string_view name, uint32_t hash, GetName get_name)
+{
+    const size_t mask = slots.size() - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask)
+    {
+        SymbolSlot& slot = slots[i];
+        if (slot.id_plus_one == 0) return slot;
+        if (slot.hash == hash && get_name(slot.id_plus_one - 1) == name) return slot;
+    }
+}
+
+void Rehash(std::vector<SymbolSlot>& slots)
+{
+    std::vector<SymbolSlot> new_slots(slots.size() * 2);
+    const size_t mask = new_slots.size() - 1;
+    for (const SymbolSlot& slot : slots)
+    {
+        if (slot.id_plus_one == 0) continue;
+
+        size_t i = slot.hash & mask;
+        while (new_slots[i].id_plus_one != 0) i = (i + 1) & mask;
+        new_slots[i] = slot;
+    }
+
+    slots = std::move(new_slots);
+}
+
+}  // namespace
+
+std::string_view StringArena::Store(std::string_view s)
+{
+    // Long strings get their own block so that the current one is not wasted.
+    // It goes before the current block, which stays the last one.
+    if (s.size() > kBlockSize / 4)
+    {
+        auto block = std::make_unique_for_overwrite<char[]>(s.size());  // NOLINT
+        std::ranges::copy(s, block.get());
+        const std::string_view stored{block.get(), s.size()};
+        blocks_.push_back(std::move(block));
+        if (blocks_.size() > 1) std::swap(blocks_.back(), blocks_[blocks_.size() - 2]);
+        return stored;
+    }
+
+    if (s.size() > kBlockSize - block_used_)
+    {
+        blocks_.push_back(std::make_unique_for_overwrite<char[]>(kBlockSize));  // NOLINT
+        block_used_ = 0;
+    }
+
+    char* data = blocks_.back().get() + block_used_;
+    std::ranges::copy(s, data);
+    block_used_ += s.size();
+    return {data, s.size()};
+}
+
+SymbolTable::SymbolTable() : slots_(kInitialSlotCount) {}
+
+SymbolId SymbolTable::Intern(std::string_view name, uint64_t hash)
+{
+    const auto short_hash = static_cast<uint32_t>(hash);
+    SymbolSlot* slot = &FindSlot(slots_, name, short_hash, [&](SymbolId id) { return names_[id]; });
+    if (slot->id_plus_one != 0) return slot->id_plus_one - 1;
+
+    if (NeedsGrow(names_.size(), slots_.size()))
+    {
+        Rehash(slots_);
+        slot = &FindSlot(slots_, name, short_hash, [&](SymbolId id) { return names_[id]; });
+    }
+
+    const auto id = static_cast<SymbolId>(names_.size());
+    names_.push_back(arena_.Store(name));
+    *slot = {.id_plus_one = id + 1, .hash = short_hash};
+    return id;
+}
+
+class ConcurrentSymbolTable::Shard
+{
+public:
+    std::mutex mutex;
+    std::vector<SymbolSlot> slots = std::vector<SymbolSlot>(kInitialSlotCount / kShardCount);
+    size_t size = 0;
+    StringArena arena;
+};
+
+ConcurrentSymbolTable::ConcurrentSymbolTable() : shards_(std::make_unique<Shard[]>(kShardCount)) {}  // NOLINT
+
+ConcurrentSymbolTable::~ConcurrentSymbolTable()
+{
+    for (auto& segment : segments_) delete[] segment.load(std::memory_order_relaxed);
+}
+
+std::pair<size_t, size_t> ConcurrentSymbolTable::GetSegmentAndOffset(SymbolId id) noexcept
+{
+    // Segment s holds kFirstSegmentSize << s entries and starts at kFirstSegmentSize * (2^s - 1)
+    const size_t segment = static_cast<size_t>(std::bit_width(id / kFirstSegmentSize + 1)) - 1;
+    const size_t offset = id - kFirstSegmentSize * ((size_t{1} << segment) - 1);
+    return {segment, offset};
+}
+
+void ConcurrentSymbolTable::StoreName(SymbolId id, std::string_view name)
+{
+    const auto [segment_index, offset] = GetSegmentAndOffset(id);
+    auto& segment = segments_[segment_index];
+
+    std::string_view* names = segment.load(std::memory_order_acquire);
+    if (names == nullptr)
+    {
+        // Workers of different shards may need the same segment at once: only one allocation survives
+        auto* allocated = new std::string_view[kFirstSegmentSize << segment_index];
+        if (segment.compare_exchange_strong(names, allocated, std::memory_order_acq_rel))
+        {
+            names = allocated;
+        }
+        else
+        {
+            delete[] allocated;
+        }
+    }
+
+    names[offset] = name;
+}
+
+std::string_view ConcurrentSymbolTable::GetName(SymbolId id) const noexcept
+{
+    const auto [segment, offset] = GetSegmentAndOffset(id);
+    return segments_[segment].load(std::memory_order_acquire)[offset];
+}
+
+SymbolId ConcurrentSymbolTable::Intern(std::string_view name, uint64_t hash)
+{
+    // Upper bits select the shard, lower bits the slot within it
+    Shard& shard = shards_[hash >> 58];
+    static_assert(kShardCount == 64);
+
+    const auto short_hash = static_cast<uint32_t>(hash);
+    auto get_name = [&](SymbolId id) { return GetName(id); };
+
+    std::lock_guard lock(shard.mutex);
+    SymbolSlot* slot = &FindSlot(shard.slots, name, short_hash, get_name);
+    if (slot->id_plus_one != 0) return slot->id_plus_one - 1;
+
+    if (NeedsGrow(shard.size, shard.slots.size()))
+    {
+        Rehash(shard.slots);
+        slot = &FindSlot(shard.slots, name, short_hash, get_name);
+    }
+
+    const SymbolId id = next_id_.fetch_add(1, std::memory_order_relaxed);
+    StoreName(id, shard.arena.Store(name));
+    *slot = {.id_plus_one = id + 1, .hash = short_hash};
+    ++shard.size;
+    return id;
+}
+
+}  // namespace kaleidoscope
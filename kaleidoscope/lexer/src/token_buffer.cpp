@@ -0,0 +1,204 @@
+#include "kaleidoscope/lexer/token_buffer.hpp"
+
+#include <algorithm>
+#include <ranges>
+#include <thread>
+
+namespace kaleidoscope
+{
+
+namespace
+{
+
+// Smaller chunks are not worth a thread
+constexpr size_t kMinParallelChunkSize = size_t{1} << 16;
+
+// Replaces elements [first, last) of `to` with all elements of `from`
+template <typename T>
+void Splice(std::vector<T>& to, size_t first, size_t last, const std::vector<T>& from)
+{
+    const auto it = to.erase(
+        std::next(to.begin(), static_cast<ptrdiff_t>(first)),
+        std::next(to.begin(), static_cast<ptrdiff_t>(last)));
+    to.insert(it, from.begin(), from.end());
+}
+
+}  // namespace
+
+void TokenBuffer::AppendTokens(const TokenBuffer& other, size_t first_token)
+{
+    // Errors with index equal to first_token precede the first appended token, so they are not part of the stream
+    for (const TokenBufferError& error : other.errors_)
+    {
+        if (error.token_index > first_token)
+        {
+            errors_.push_back({
+                .error = error.error,
+                .token_index = static_cast<uint32_t>(types_.size() + (error.token_index - first_token)),
+            });
+        }
+    }
+
+    const auto first = static_cast<ptrdiff_t>(first_token);
+    types_.insert(types_.end(), std::next(other.types_.begin(), first), other.types_.end());
+    begins_.insert(begins_.end(), std::next(other.begins_.begin(), first), other.begins_.end());
+    lengths_.insert(lengths_.end(), std::next(other.lengths_.begin(), first), other.lengths_.end());
+}
+
+void TokenBuffer::TokenizeParallel(std::string_view text, size_t thread_count)
+{
+    const size_t chunk_count = std::min(thread_count, text.size() / kMinParallelChunkSize);
+    if (chunk_count <= 1)
+    {
+        Tokenize(text);
+        return;
+    }
+
+    assert(text.size() <= LexerToken::kMaxOffset);
+
+    Clear();
+    text_ = text;
+
+    std::vector<size_t> bounds(chunk_count + 1);
+    for (size_t i = 0; i != chunk_count; ++i) bounds[i] = i * (text.size() / chunk_count);
+    bounds.back() = text.size();
+
+    // The first chunk starts where the true token stream starts, so it is lexed right into this buffer
+    std::vector<TokenBuffer> chunks(chunk_count);
+    std::vector<size_t> end_positions(chunk_count);
+    {
+        std::vector<std::jthread> workers;
+        workers.reserve(chunk_count - 1);
+        for (size_t i = 1; i != chunk_count; ++i)
+        {
+            workers.emplace_back(
+                [&, i]
+                {
+                    chunks[i].text_ = text;
+                    end_positions[i] = chunks[i].LexRange(bounds[i], bounds[i + 1]);
+                });
+        }
+
+        end_positions[0] = LexRange(0, bounds[1]);
+    }
+
+    size_t pos = end_positions[0];
+    for (size_t i = 1; i != chunk_count; ++i)
+    {
+        // A token, literal or comment that runs until the end of text may end the stream in any chunk
+        if (!types_.empty() && types_.back() == TokenType::EndOfFile) return;
+
+        const TokenBuffer& chunk = chunks[i];
+        const bool is_last_chunk = i + 1 == chunk_count;
+
+        while (true)
+        {
+            const size_t start = ScanCharClass(text, pos, CharClass::Space);
+            if (start >= bounds[i + 1] && !is_last_chunk) break;
+
+            // In sync with the speculative result: take the rest of the chunk as is
+            const auto it = std::ranges::lower_bound(chunk.begins_, start);
+            if (it != chunk.begins_.end() && *it == start)
+            {
+                AppendTokens(chunk, static_cast<size_t>(std::distance(chunk.begins_.begin(), it)));
+                pos = end_positions[i];
+                break;
+            }
+
+            // Not in sync yet: the chunk boundary split a token, a string literal or a comment
+            Lexer lexer(text, pos);
+            const LexerResult result = lexer.GetToken();
+            AppendResult(result);
+            pos = lexer.GetPosition();
+
+            if (result.has_value() && result->GetType() == TokenType::EndOfFile) return;
+        }
+    }
+}
+
+void TokenBuffer::ApplyEdit(std::string_view new_text, const TextEdit& edit)
+{
+    assert(edit.offset + edit.removed_length <= text_.size());
+    assert(new_text.size() + edit.removed_length == text_.size() + edit.inserted_length);
+    assert(new_text.size() <= LexerToken::kMaxOffset);
+
+    if (types_.empty())
+    {
+        Tokenize(new_text);
+        return;
+    }
+
+    const size_t old_edit_end = edit.offset + edit.removed_length;
+    const size_t new_edit_end = edit.offset + edit.inserted_length;
+
+    // The lexer looks at most one character past the end of a token,
+    // so tokens that end before the edit and everything before them stay the same
+    const size_t first_token = *std::ranges::partition_point(
+        std::views::iota(0uz, Size()),
+        [&](size_t index) { return size_t{begins_[index]} + lengths_[index] < edit.offset; });
+    const size_t restart_pos = first_token == 0 ? 0 : size_t{begins_[first_token - 1]} + lengths_[first_token - 1];
+
+    // Lex until a token begins at the same place where some old token began. Old EndOfFile guarantees that.
+    TokenBuffer relexed;
+    size_t sync_token = 0;
+    Lexer lexer(new_text, restart_pos);
+    while (true)
+    {
+        const LexerResult result = lexer.GetToken();
+        if (result.has_value() && result->GetBegin() >= new_edit_end)
+        {
+            const size_t old_begin = result->GetBegin() - new_edit_end + old_edit_end;
+            const auto old_begins = std::span{begins_}.subspan(first_token);
+            const auto it = std::ranges::lower_bound(old_begins, old_begin);
+            if (it != old_begins.end() && *it == old_begin)
+            {
+                sync_token = first_token + static_cast<size_t>(std::distance(old_begins.begin(), it));
+                break;
+            }
+        }
+
+        relexed.AppendResult(result);
+    }
+
+    // Errors before first_token are kept as is, errors after sync_token are shifted
+    const size_t new_sync_token = first_token + relexed.Size();
+    std::vector<TokenBufferError> old_errors = std::move(errors_);
+    errors_.clear();
+    for (const TokenBufferError& error : old_errors)
+    {
+        if (error.token_index >= first_token) break;
+        errors_.push_back(error);
+    }
+
+    for (const TokenBufferError& error : relexed.errors_)
+    {
+        errors_.push_back({
+            .error = error.error,
+            .token_index = static_cast<uint32_t>(first_token + error.token_index),
+        });
+    }
+
+    for (const TokenBufferError& error : old_errors)
+    {
+        if (error.token_index <= sync_token) continue;
+        errors_.push_back({
+            .error = LexerError(
+                error.error.GetType(),
+                error.error.GetBegin() - old_edit_end + new_edit_end,
+                error.error.GetEnd() - old_edit_end + new_edit_end),
+            .token_index = static_cast<uint32_t>(error.token_index - sync_token + new_sync_token),
+        });
+    }
+
+    Splice(types_, first_token, sync_token, relexed.types_);
+    Splice(begins_, first_token, sync_token, relexed.begins_);
+    Splice(lengths_, first_token, sync_token, relexed.lengths_);
+
+    // Unsigned wrap around makes this work for both growing and shrinking edits
+    const auto shift = static_cast<uint32_t>(new_edit_end - old_edit_end);
+    for (uint32_t& begin : std::span{begins_}.subspan(new_sync_token)) begin += shift;
+
+    text_ = new_text;
+}
+
+}  // namespace kaleidoscope
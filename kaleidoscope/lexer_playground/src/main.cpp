@@ -1,45 +1,66 @@
+#include <array>
+#include <format>
 #include <iostream>
-#include <string>
+#include <print>
+#include <string_view>
 
-#include "kaleidoscope/lexer/lexer.hpp"
+#include "kaleidoscope/lexer/source_index.hpp"
+#include "kaleidoscope/lexer/streaming_lexer.hpp"
 #include "magic_enum/magic_enum.hpp"
 
 int main()
 {
-    std::string s;
+    kaleidoscope::StreamingLexer lexer;
 
-    std::getline(std::cin, s);
-
-    kaleidoscope::Lexer lexer(s);
-
-    while (true)
+    // The lexer forgets consumed input, so line breaks are indexed as chunks arrive
+    kaleidoscope::LineIndex lines;
+    auto format_location = [&](size_t offset)
     {
-        auto t = lexer.GetToken();
+        const kaleidoscope::LineColumn lc = lines.GetLineColumn(offset);
+        return std::format("{}:{}", lc.line, lc.column);
+    };
 
-        if (t.has_value())
+    // Prints tokens that are complete so far
+    auto print_tokens = [&]
+    {
+        while (auto t = lexer.GetToken())
         {
-            std::println(
-                "{}, [{}, {}) = {}",
-                magic_enum::enum_name(t->type),
-                t->begin,
-                t->end,
-                std::string_view{s}.substr(t->begin, t->end - t->begin));
+            if (t->has_value())
+            {
+                const auto& token = t->value();
+                std::println(
+                    "{}, {} = {}",
+                    magic_enum::enum_name(token.GetType()),
+                    format_location(token.GetBegin()),
+                    lexer.GetTokenView(token));
 
-            if (t->type == kaleidoscope::TokenType::EndOfFile)
+                if (token.GetType() == kaleidoscope::TokenType::EndOfFile)
+                {
+                    std::println("EOF");
+                    return;
+                }
+            }
+            else
             {
-                std::println("EOF");
-                break;
+                const auto& err = t->error();
+                std::println(
+                    "{}, {} = {}",
+                    magic_enum::enum_name(err.GetType()),
+                    format_location(err.GetBegin()),
+                    lexer.GetErrorView(err));
             }
         }
-        else
-        {
-            auto& err = t.error();
-            std::println(
-                "{}, [{}, {}) = {}",
-                magic_enum::enum_name(err.type),
-                err.begin,
-                err.end,
-                std::string_view{s}.substr(err.begin, err.end - err.begin));
-        }
+    };
+
+    std::array<char, 4096> chunk{};
+    while (std::cin.read(chunk.data(), std::ssize(chunk)) || std::cin.gcount() != 0)
+    {
+        const std::string_view chunk_view(chunk.data(), static_cast<size_t>(std::cin.gcount()));
+        lines.AppendChunk(chunk_view);
+        lexer.Feed(chunk_view);
+        print_tokens();
     }
+
+    lexer.Finish();
+    print_tokens();
 }
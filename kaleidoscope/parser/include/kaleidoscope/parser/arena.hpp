@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+namespace kaleidoscope
+{
+
+// Monotonic memory resource for data that lives for one compilation (AST, parser stacks, codegen scratch).
+// Allocation is a pointer bump, deallocation does nothing. Reset makes all memory available again
+// but keeps it, so once the arena has grown to the size a compilation needs, the following
+// compilations do not touch the upstream resource.
+class Arena final : public std::pmr::memory_resource
+{
+public:
+    // initial_capacity bytes are allocated upfront
+    explicit Arena(size_t initial_capacity = 0, std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+    ~Arena() override;
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    // Everything allocated before is released at once.
+    // If the previous compilation did not fit into one block, the blocks are merged into one of their total size.
+    void Reset();
+
+    // Bytes handed out since the last reset, including alignment padding
+    [[nodiscard]] size_t GetUsedSize() const noexcept;
+
+    // Total size of the blocks owned by the arena
+    [[nodiscard]] size_t GetCapacity() const noexcept;
+
+private:
+    class Block
+    {
+    public:
+        std::byte* data = nullptr;
+        size_t size = 0;
+    };
+
+    static constexpr size_t kMinBlockSize = size_t{1} << 12;
+    static constexpr size_t kBlockAlignment = alignof(std::max_align_t);
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    // Continues in a new block that fits the allocation. Blocks grow geometrically.
+    void NextBlock(size_t bytes, size_t alignment);
+    void AddBlock(size_t size);
+    void FreeBlocks() noexcept;
+
+private:
+    std::pmr::memory_resource* upstream_ = nullptr;
+    std::vector<Block> blocks_;
+    size_t current_ = 0;
+    size_t used_in_current_ = 0;
+
+    // Used bytes of blocks before the current one
+    size_t used_before_current_ = 0;
+};
+
+}  // namespace kaleidoscope
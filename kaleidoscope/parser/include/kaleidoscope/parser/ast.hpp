@@ -0,0 +1,218 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace kaleidoscope
+{
+
+template <typename... Types>
+class TypeList
+{
+public:
+    static constexpr size_t kSize = sizeof...(Types);
+};
+
+template <typename T, typename List>
+inline constexpr size_t kTypeListIndex = 0;
+
+// Index of T in the list. Fails to compile if T is not there.
+template <typename T, typename... Types>
+inline constexpr size_t kTypeListIndex<T, TypeList<Types...>> = []
+{
+    static_assert((std::is_same_v<T, Types> || ...), "T is not in the list");
+    constexpr std::array<bool, sizeof...(Types)> matches{std::is_same_v<T, Types>...};
+    size_t index = 0;
+    while (index != matches.size() && !matches[index]) ++index;
+    return index;
+}();
+
+template <size_t index, typename List>
+class TypeListElement;
+
+template <size_t index, typename... Types>
+class TypeListElement<index, TypeList<Types...>>
+{
+public:
+    using Type = std::tuple_element_t<index, std::tuple<Types...>>;
+};
+
+template <size_t index, typename List>
+using TypeListElementT = typename TypeListElement<index, List>::Type;
+
+enum class BuiltinType : uint8_t
+{
+    SignedInteger,
+    UnsignedInteger,
+    FloatingPoint
+};
+
+class BuiltinTypeInfo
+{
+public:
+    [[nodiscard]] constexpr bool operator==(const BuiltinTypeInfo&) const noexcept = default;
+
+    BuiltinType type = BuiltinType::SignedInteger;
+    uint8_t bits = 32;
+};
+
+class IntegralLiteralExprAST;
+class BinaryOperatorExpression;
+
+// All expression node kinds. Storage and dispatch by ExprId are generated from this list.
+using ExprNodeTypes = TypeList<IntegralLiteralExprAST, BinaryOperatorExpression>;
+
+// Names of node kinds. Values are indices in ExprNodeTypes, so they can't get out of sync with the list.
+enum class ExprType : uint8_t
+{
+    IntegralLiteral = kTypeListIndex<IntegralLiteralExprAST, ExprNodeTypes>,
+    BinaryOperator = kTypeListIndex<BinaryOperatorExpression, ExprNodeTypes>,
+};
+
+template <typename Node>
+inline constexpr ExprType kExprType = static_cast<ExprType>(kTypeListIndex<Node, ExprNodeTypes>);
+
+class ExprId
+{
+public:
+    [[nodiscard]] constexpr bool operator==(const ExprId&) const noexcept = default;
+
+    ExprType type;
+    uint32_t index;
+};
+
+enum class BinaryOperatorType : uint8_t
+{
+    Plus,
+    Minus,
+    Multiply,
+    Divide
+};
+
+// AST nodes are trivially copyable structs without a common base.
+// Children are referenced by ExprId, so a whole AST can be copied or serialized with memcpy.
+// Nodes are equal when they are structurally identical, given that their children are hash-consed.
+// GetFields lists the fields that take part in the comparison, hash-consing hashes them.
+
+class IntegralLiteralExprAST
+{
+public:
+    [[nodiscard]] constexpr bool operator==(const IntegralLiteralExprAST&) const noexcept = default;
+
+    // Signed values are stored in two's complement
+    [[nodiscard]] constexpr int64_t GetSignedValue() const noexcept { return static_cast<int64_t>(value); }
+
+    [[nodiscard]] constexpr auto GetFields() const noexcept { return std::tie(value, type); }
+
+    uint64_t value = 0;
+    BuiltinTypeInfo type{};
+};
+
+class BinaryOperatorExpression
+{
+public:
+    [[nodiscard]] constexpr bool operator==(const BinaryOperatorExpression&) const noexcept = default;
+
+    [[nodiscard]] constexpr auto GetFields() const noexcept { return std::tie(left, right, type); }
+
+    ExprId left;
+    ExprId right;
+    BinaryOperatorType type;
+};
+
+template <typename List>
+class ExprStorage;
+
+// One array per node kind
+template <typename... Nodes>
+class ExprStorage<TypeList<Nodes...>>
+{
+public:
+    static_assert((std::is_trivially_copyable_v<Nodes> && ...));
+
+    template <ExprType type>
+    using NodeType = TypeListElementT<static_cast<size_t>(type), TypeList<Nodes...>>;
+
+    explicit ExprStorage(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : nodes_(std::pmr::vector<Nodes>(resource)...)
+    {
+    }
+
+    template <typename Node>
+    ExprId Add(const Node& node)
+    {
+        auto& nodes = GetNodesMutable<Node>();
+        const auto index = static_cast<uint32_t>(nodes.size());
+        nodes.push_back(node);
+        return ExprId{.type = static_cast<ExprType>(kTypeListIndex<Node, TypeList<Nodes...>>), .index = index};
+    }
+
+    template <typename Node>
+    [[nodiscard]] const std::pmr::vector<Node>& GetNodes() const noexcept
+    {
+        return std::get<kTypeListIndex<Node, TypeList<Nodes...>>>(nodes_);
+    }
+
+    // Nodes can be modified in place, but not added or removed
+    template <typename Node>
+    [[nodiscard]] std::span<Node> GetNodes() noexcept
+    {
+        return GetNodesMutable<Node>();
+    }
+
+    // Returns nullptr if there is no node with this index
+    template <ExprType type>
+    [[nodiscard]] const NodeType<type>* Get(uint32_t index) const noexcept
+    {
+        const auto& nodes = GetNodes<NodeType<type>>();
+        return index < nodes.size() ? &nodes[index] : nullptr;
+    }
+
+    // Calls visitor with the node referenced by id. Overloads for all node types must return the same type.
+    template <typename Visitor>
+    decltype(auto) Visit(ExprId id, Visitor&& visitor) const
+    {
+        using Result = std::invoke_result_t<Visitor&&, const TypeListElementT<0, TypeList<Nodes...>>&>;
+        using Function = Result (*)(const ExprStorage&, uint32_t, Visitor&&);
+        static constexpr std::array<Function, sizeof...(Nodes)> kFunctions{
+            [](const ExprStorage& storage, uint32_t index, Visitor&& v) -> Result
+            {
+                return std::forward<Visitor>(v)(storage.GetNodes<Nodes>()[index]);
+            }...};
+
+        assert(static_cast<size_t>(id.type) < sizeof...(Nodes));
+        return kFunctions[static_cast<size_t>(id.type)](*this, id.index, std::forward<Visitor>(visitor));
+    }
+
+    [[nodiscard]] size_t Size() const noexcept { return (GetNodes<Nodes>().size() + ...); }
+
+    void Clear() noexcept { (GetNodesMutable<Nodes>().clear(), ...); }
+
+private:
+    template <typename Node>
+    [[nodiscard]] std::pmr::vector<Node>& GetNodesMutable() noexcept
+    {
+        return std::get<kTypeListIndex<Node, TypeList<Nodes...>>>(nodes_);
+    }
+
+private:
+    std::tuple<std::pmr::vector<Nodes>...> nodes_;
+};
+
+using ExprAstStorage = ExprStorage<ExprNodeTypes>;
+
+// Binary expressions have the type of their operands
+[[nodiscard]] inline BuiltinTypeInfo GetResultType(const ExprAstStorage& exprs, ExprId id) noexcept
+{
+    while (id.type == ExprType::BinaryOperator) id = exprs.GetNodes<BinaryOperatorExpression>()[id.index].left;
+    return exprs.GetNodes<IntegralLiteralExprAST>()[id.index].type;
+}
+
+}  // namespace kaleidoscope
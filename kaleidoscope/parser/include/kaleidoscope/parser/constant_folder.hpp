@@ -0,0 +1,83 @@
+#pragma once
+
+#include <memory_resource>
+#include <optional>
+#include <vector>
+
+#include "ast.hpp"
+
+namespace kaleidoscope
+{
+
+enum class FoldingErrorType : uint8_t
+{
+    IntegerOverflow,
+    DivisionByZero,
+};
+
+class FoldingError
+{
+public:
+    [[nodiscard]] constexpr bool operator==(const FoldingError&) const noexcept = default;
+
+    // Binary expression that could not be folded
+    ExprId expr;
+    FoldingErrorType type;
+};
+
+// Optimization pass that runs between parsing and codegen:
+// - binary expressions with constant operands are replaced with literals;
+// - identities x + 0, 0 + x, x - 0, x * 1, 1 * x, x / 1, x * 0, 0 * x and x - x are applied.
+// x - x needs both operands to have the same ExprId, which hash-consing gives for equal subtrees.
+// Expressions that overflow or divide by zero are left as they are and reported.
+//
+// The tree is not rebuilt: children of binary expressions are redirected to the folded nodes in place
+// and new literals are appended to the storage. Children are always created before their parents,
+// so one pass over binary expressions in index order sees folded children and needs no recursion.
+class ConstantFolder
+{
+public:
+    explicit ConstantFolder(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : folded_(resource),
+          errors_(resource)
+    {
+    }
+
+    // Folds the expressions added since the previous call and returns what root is replaced with
+    [[nodiscard]] ExprId Fold(ExprAstStorage& exprs, ExprId root);
+
+    // Forgets folded expressions and errors. Call when the storage is cleared.
+    void Clear() noexcept
+    {
+        folded_.clear();
+        errors_.clear();
+    }
+
+    // Errors in the order of expressions
+    [[nodiscard]] const std::pmr::vector<FoldingError>& GetErrors() const noexcept { return errors_; }
+
+private:
+    [[nodiscard]] ExprId GetFolded(ExprId id) const noexcept
+    {
+        return id.type == ExprType::BinaryOperator ? folded_[id.index] : id;
+    }
+
+    [[nodiscard]] ExprId FoldBinaryOperator(ExprAstStorage& exprs, uint32_t index);
+
+    // Returns nullopt if the expression can't be evaluated
+    [[nodiscard]] std::optional<ExprId> Evaluate(
+        ExprAstStorage& exprs,
+        uint32_t index,
+        const IntegralLiteralExprAST& left,
+        const IntegralLiteralExprAST& right);
+
+    // Applies an identity if one matches
+    [[nodiscard]] static std::optional<ExprId> Simplify(ExprAstStorage& exprs, uint32_t index);
+
+private:
+    // Replacement of each binary expression
+    std::pmr::vector<ExprId> folded_;
+    std::pmr::vector<FoldingError> errors_;
+};
+
+}  // namespace kaleidoscope
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstdint>
+#include <memory_resource>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "ast.hpp"
+
+namespace kaleidoscope
+{
+
+[[nodiscard]] constexpr uint64_t HashCombine(uint64_t hash, uint64_t value) noexcept
+{
+    constexpr uint64_t kMul = 0x9E3779B97F4A7C15;
+    hash = (hash ^ value) * kMul;
+    return hash ^ (hash >> 32);
+}
+
+[[nodiscard]] constexpr uint64_t HashExprId(ExprId id) noexcept
+{
+    return (uint64_t{static_cast<uint8_t>(id.type)} << 32) | id.index;
+}
+
+[[nodiscard]] constexpr uint64_t HashExprField(ExprId id) noexcept
+{
+    return HashExprId(id);
+}
+
+[[nodiscard]] constexpr uint64_t HashExprField(BuiltinTypeInfo type) noexcept
+{
+    return (uint64_t{static_cast<uint8_t>(type.type)} << 8) | type.bits;
+}
+
+template <typename T>
+    requires(std::is_integral_v<T> || std::is_enum_v<T>)
+[[nodiscard]] constexpr uint64_t HashExprField(T value) noexcept
+{
+    return static_cast<uint64_t>(value);
+}
+
+// Hashes the kind of the node and its fields, so any node kind in ExprNodeTypes can be interned
+template <typename Node>
+[[nodiscard]] constexpr uint64_t HashExprNode(const Node& node) noexcept
+{
+    return std::apply(
+        [](const auto&... fields)
+        {
+            uint64_t hash = static_cast<uint64_t>(kExprType<Node>);
+            ((hash = HashCombine(hash, HashExprField(fields))), ...);
+            return hash;
+        },
+        node.GetFields());
+}
+
+// Hash-consing of expression nodes: a node that is structurally identical to one added before is not
+// stored again, its ExprId is returned instead. Children of nodes are already interned, so comparing
+// their ExprIds compares subtrees, and the AST becomes a DAG where every distinct subexpression exists once.
+class ExprInterner
+{
+public:
+    explicit ExprInterner(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : slots_(resource)
+    {
+    }
+
+    template <typename Node>
+    [[nodiscard]] ExprId Intern(ExprAstStorage& exprs, const Node& node)
+    {
+        if (NeedsGrow()) Grow();
+
+        const auto hash = static_cast<uint32_t>(HashExprNode(node));
+        const auto& nodes = exprs.GetNodes<Node>();
+        const size_t mask = slots_.size() - 1;
+        for (size_t i = hash & mask;; i = (i + 1) & mask)
+        {
+            Slot& slot = slots_[i];
+            if (slot.index_plus_one == 0)
+            {
+                const ExprId id = exprs.Add(node);
+                slot = {.hash = hash, .index_plus_one = id.index + 1, .type = kExprType<Node>};
+                ++size_;
+                return id;
+            }
+
+            if (slot.hash == hash && slot.type == kExprType<Node> && nodes[slot.index_plus_one - 1] == node)
+            {
+                return {.type = kExprType<Node>, .index = slot.index_plus_one - 1};
+            }
+        }
+    }
+
+    // Forgets all nodes. Call when the storage is cleared.
+    void Clear() noexcept;
+
+private:
+    class Slot
+    {
+    public:
+        uint32_t hash = 0;
+
+        // 0 is an empty slot
+        uint32_t index_plus_one = 0;
+        ExprType type{};
+    };
+
+    // Grow when the table is 3/4 full
+    [[nodiscard]] bool NeedsGrow() const noexcept { return (size_ + 1) * 4 > slots_.size() * 3; }
+    void Grow();
+
+private:
+    std::pmr::vector<Slot> slots_;
+    size_t size_ = 0;
+};
+
+}  // namespace kaleidoscope
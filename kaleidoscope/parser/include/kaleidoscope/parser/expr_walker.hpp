@@ -0,0 +1,89 @@
+#pragma once
+
+#include <array>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+#include "ast.hpp"
+
+namespace kaleidoscope
+{
+
+// Children of a node in evaluation order
+[[nodiscard]] constexpr std::array<ExprId, 0> GetOperands(const IntegralLiteralExprAST&) noexcept
+{
+    return {};
+}
+
+[[nodiscard]] constexpr std::array<ExprId, 2> GetOperands(const BinaryOperatorExpression& expr) noexcept
+{
+    return {expr.left, expr.right};
+}
+
+// Walks expressions in post-order (operands before the node) with an explicit stack,
+// so the native stack depth does not depend on the depth of the expression.
+class ExprPostOrderWalker
+{
+public:
+    explicit ExprPostOrderWalker(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : stack_(resource)
+    {
+    }
+
+    // should_visit(ExprId) returning false skips the node with its operands, e.g. when a shared
+    // subexpression has been visited already. visitor(ExprId, const Node&) returns false to stop the walk.
+    // Returns false if the walk was stopped.
+    template <typename ShouldVisit, typename Visitor>
+    [[nodiscard]] bool Walk(const ExprAstStorage& exprs, ExprId root, ShouldVisit&& should_visit, Visitor&& visitor)
+    {
+        stack_.clear();
+        stack_.push_back({.id = root});
+        while (!stack_.empty())
+        {
+            const PendingExpr expr = stack_.back();
+            stack_.pop_back();
+
+            if (expr.operands_visited)
+            {
+                const bool proceed =
+                    exprs.Visit(expr.id, [&](const auto& node) -> bool { return visitor(expr.id, node); });
+                if (!proceed) return false;
+                continue;
+            }
+
+            if (!should_visit(expr.id)) continue;
+
+            stack_.push_back({.id = expr.id, .operands_visited = true});
+            exprs.Visit(
+                expr.id,
+                [&](const auto& node)
+                {
+                    // Reversed, so that the first operand is on top
+                    const auto operands = GetOperands(node);
+                    for (auto it = operands.rbegin(); it != operands.rend(); ++it) stack_.push_back({.id = *it});
+                });
+        }
+
+        return true;
+    }
+
+    // Visits every node reachable from root, shared ones once per parent
+    template <typename Visitor>
+    [[nodiscard]] bool Walk(const ExprAstStorage& exprs, ExprId root, Visitor&& visitor)
+    {
+        return Walk(exprs, root, [](ExprId) { return true; }, std::forward<Visitor>(visitor));
+    }
+
+private:
+    class PendingExpr
+    {
+    public:
+        ExprId id;
+        bool operands_visited = false;
+    };
+
+    std::pmr::vector<PendingExpr> stack_;
+};
+
+}  // namespace kaleidoscope
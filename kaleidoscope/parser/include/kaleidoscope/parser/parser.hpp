@@ -1,82 +1,219 @@
-#include <variant>
+#pragma once
 
+#include <cassert>
+#include <memory_resource>
+#include <optional>
+#include <vector>
+
+#include "ast.hpp"
+#include "expr_interner.hpp"
 #include "kaleidoscope/lexer/lexer.hpp"
+#include "kaleidoscope/lexer/lookahead_lexer.hpp"
 
 namespace kaleidoscope
 {
 
-class TypeInfo
+enum class ParserErrorType : uint8_t
 {
-public:
+    UnexpectedToken,
+    IntegerLiteralOverflow,
 };
 
-enum class BuiltinType : uint8_t
-{
-    SignedInteger,
-    UnsignedInteger,
-    FloatingPoint
-};
+using ExprASTResult = std::expected<ExprId, ParserErrorType>;
 
-class BuiltinTypeInfo : public TypeInfo
+class ParserOptions
 {
 public:
-    BuiltinType type = BuiltinType::SignedInteger;
-    uint8_t bits = 32;
+    // Structurally identical expressions get the same ExprId, so the AST is a DAG (see ExprInterner)
+    bool hash_consing = false;
 };
 
-class ExprAST
+[[nodiscard]] constexpr std::optional<BinaryOperatorType> GetBinaryOperatorType(TokenType token_type) noexcept
 {
-public:
-    constexpr virtual ~ExprAST() = default;
-};
+    switch (token_type)
+    {
+    case TokenType::Plus:
+        return BinaryOperatorType::Plus;
+    case TokenType::Minus:
+        return BinaryOperatorType::Minus;
+    case TokenType::Asterisk:
+        return BinaryOperatorType::Multiply;
+    case TokenType::ForwardSlash:
+        return BinaryOperatorType::Divide;
+    default:
+        return std::nullopt;
+    }
+}
 
-enum class ExprType : uint8_t
+// Operators with higher precedence bind tighter. All binary operators are left-associative.
+[[nodiscard]] constexpr uint8_t GetBinaryOperatorPrecedence(BinaryOperatorType type) noexcept
 {
-    IntegralLiteral,
-    BinaryOperator,
-};
+    switch (type)
+    {
+    case BinaryOperatorType::Plus:
+    case BinaryOperatorType::Minus:
+        return 1;
+    case BinaryOperatorType::Multiply:
+    case BinaryOperatorType::Divide:
+        return 2;
+    }
 
-enum class ParserErrorType : uint8_t
-{
-    UnexpectedToken
-};
+    assert(false);
+    return 0;
+}
 
-class ExprId
+// Builds expressions from tokens of LookaheadLexer, BlockLookaheadLexer or another TokenLookahead.
+// Expressions are parsed by operator precedence with explicit operand and operator stacks instead of
+// recursion, so the native stack depth does not depend on the input and the time is linear in its length.
+class Parser
 {
 public:
-    ExprType type;
-    uint32_t index;
-};
+    // AST nodes and parser stacks are allocated from resource
+    explicit Parser(
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource(),
+        ParserOptions options = {})
+        : options_(options),
+          exprs_(resource),
+          interner_(resource),
+          operands_(resource),
+          operators_(resource)
+    {
+    }
 
-using ExprASTResult = std::expected<ExprId, ParserErrorType>;
+    // Parses the longest expression at the current position.
+    // The token that ends the expression (EndOfFile, an unmatched ')', ...) is not consumed.
+    template <TokenLookahead Lookahead>
+    [[nodiscard]] ExprASTResult ParseExpression(Lookahead& l)
+    {
+        operands_.clear();
+        operators_.clear();
+        open_parens_ = 0;
 
-class IntegralLiteralExprAST : public ExprAST
-{
-public:
-    uint64_t value = 0;
-    BuiltinTypeInfo type{};
-};
+        while (true)
+        {
+            // An operand, possibly after any number of opening parentheses
+            while (l.Peek().has_value() && l.Peek()->GetType() == TokenType::OpenParen)
+            {
+                std::ignore = l.Take();
+                operators_.push_back(PendingOperator::OpenParen);
+                ++open_parens_;
+            }
 
-class FloatingPointLiteralExprAST : public ExprAST
-{
-public:
-    std::variant<float, double> value;
-};
+            // Lexers that decode literal values report overflowing literals as errors
+            if (!l.Peek().has_value() && l.Peek().error().GetType() == LexerErrorType::IntegerLiteralOverflow)
+            {
+                return std::unexpected(ParserErrorType::IntegerLiteralOverflow);
+            }
 
-enum class BinaryOperatorType : uint8_t
-{
-    Plus,
-    Minus,
-    Multiply,
-    Divide
-};
+            if (!l.Peek().has_value() || l.Peek()->GetType() != TokenType::DecimalLiteral)
+            {
+                return std::unexpected(ParserErrorType::UnexpectedToken);
+            }
 
-class BinaryOperatorExpression : public ExprAST
-{
-public:
-    ExprId left;
-    ExprId right;
-    BinaryOperatorType type;
+            const ExprASTResult literal = ParseDecimalIntegralLiteral(l);
+            if (!literal.has_value()) return literal;
+            operands_.push_back(*literal);
+
+            // Closing parentheses that match the opening ones of this expression
+            while (l.Peek().has_value() && l.Peek()->GetType() == TokenType::CloseParen)
+            {
+                if (!ReduceParenthesized()) break;
+                std::ignore = l.Take();
+            }
+
+            // An operator or the end of expression
+            const std::optional<BinaryOperatorType> op =
+                l.Peek().has_value() ? GetBinaryOperatorType(l.Peek()->GetType()) : std::nullopt;
+            if (!op.has_value()) return FinishExpression();
+
+            std::ignore = l.Take();
+            PushOperator(*op);
+        }
+    }
+
+    template <TokenLookahead Lookahead>
+    [[nodiscard]] ExprASTResult ParseDecimalIntegralLiteral(Lookahead& l)
+    {
+        uint64_t value = 0;
+        if constexpr (Lookahead::kDecodesLiteralValues)
+        {
+            // The lexer has already decoded the value and reported overflow
+            value = std::get<uint64_t>(l.PeekLiteralValue());
+        }
+
+        const auto ra = l.Take();
+        assert(ra.has_value());
+
+        const auto& ta = *ra;
+        assert(ta.GetType() == TokenType::DecimalLiteral);
+
+        if constexpr (!Lookahead::kDecodesLiteralValues)
+        {
+            const auto decoded = DecodeIntegerLiteral(ta.GetType(), l.GetTokenView(ta));
+            if (!decoded.has_value()) return std::unexpected(ParserErrorType::IntegerLiteralOverflow);
+            value = *decoded;
+        }
+
+        return AddIntegralLiteral(value);
+    }
+
+    // Returns nullptr if there is no node with this index
+    template <ExprType type>
+    [[nodiscard]] const auto* GetExprAst(uint32_t index) const noexcept
+    {
+        return exprs_.Get<type>(index);
+    }
+
+    [[nodiscard]] const ExprAstStorage& GetExprs() const noexcept { return exprs_; }
+
+    // For passes that modify the AST in place (see ConstantFolder)
+    [[nodiscard]] ExprAstStorage& GetExprs() noexcept { return exprs_; }
+
+private:
+    // Binary operator waiting for its right operand or an opening parenthesis
+    enum class PendingOperator : uint8_t
+    {
+        Plus,
+        Minus,
+        Multiply,
+        Divide,
+        OpenParen,
+    };
+
+    static_assert(static_cast<uint8_t>(PendingOperator::Plus) == static_cast<uint8_t>(BinaryOperatorType::Plus));
+    static_assert(static_cast<uint8_t>(PendingOperator::Minus) == static_cast<uint8_t>(BinaryOperatorType::Minus));
+    static_assert(
+        static_cast<uint8_t>(PendingOperator::Multiply) == static_cast<uint8_t>(BinaryOperatorType::Multiply));
+    static_assert(static_cast<uint8_t>(PendingOperator::Divide) == static_cast<uint8_t>(BinaryOperatorType::Divide));
+
+    [[nodiscard]] ExprId AddIntegralLiteral(uint64_t value);
+
+    template <typename Node>
+    [[nodiscard]] ExprId AddNode(const Node& node)
+    {
+        return options_.hash_consing ? interner_.Intern(exprs_, node) : exprs_.Add(node);
+    }
+
+    // Pops two operands and one operator and pushes the binary expression made of them
+    void ReduceTop();
+
+    // Reduces operators that bind at least as tight as op (all are left-associative) and pushes op
+    void PushOperator(BinaryOperatorType op);
+
+    // Reduces the operators after the innermost opening parenthesis and removes it.
+    // Returns false if there is no opening parenthesis, i.e. ')' belongs to the enclosing context.
+    [[nodiscard]] bool ReduceParenthesized();
+
+    // Reduces the remaining operators. Fails if some parentheses were not closed.
+    [[nodiscard]] ExprASTResult FinishExpression();
+
+private:
+    ParserOptions options_;
+    ExprAstStorage exprs_;
+    ExprInterner interner_;
+    std::pmr::vector<ExprId> operands_;
+    std::pmr::vector<PendingOperator> operators_;
+    size_t open_parens_ = 0;
 };
 
 }  // namespace kaleidoscope
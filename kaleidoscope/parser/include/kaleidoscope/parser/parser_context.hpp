@@ -0,0 +1,46 @@
+#pragma once
+
+#include <optional>
+
+#include "arena.hpp"
+#include "parser.hpp"
+
+namespace kaleidoscope
+{
+
+// Memory of consecutive compilations. Everything a compilation allocates (AST, parser stacks, token buffers,
+// codegen scratch) should come from GetResource(). StartCompilation drops the previous compilation
+// and reuses its memory, so in the steady state compilations make no heap allocations.
+class ParserContext
+{
+public:
+    // initial_capacity bytes are allocated upfront
+    explicit ParserContext(
+        size_t initial_capacity = 0,
+        std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+        : arena_(initial_capacity, upstream)
+    {
+    }
+
+    ParserContext(const ParserContext&) = delete;
+    ParserContext& operator=(const ParserContext&) = delete;
+
+    // Invalidates the parser and everything else allocated for the previous compilation
+    [[nodiscard]] Parser& StartCompilation(ParserOptions options = {})
+    {
+        parser_.reset();
+        arena_.Reset();
+        return parser_.emplace(&arena_, options);
+    }
+
+    [[nodiscard]] std::pmr::memory_resource* GetResource() noexcept { return &arena_; }
+    [[nodiscard]] const Arena& GetArena() const noexcept { return arena_; }
+
+private:
+    Arena arena_;
+
+    // Destroyed before the arena
+    std::optional<Parser> parser_;
+};
+
+}  // namespace kaleidoscope
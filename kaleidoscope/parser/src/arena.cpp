@@ -0,0 +1,104 @@
+#include "kaleidoscope/parser/arena.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <memory>
+
+namespace kaleidoscope
+{
+
+Arena::Arena(size_t initial_capacity, std::pmr::memory_resource* upstream)
+    : upstream_(upstream)
+{
+    if (initial_capacity != 0) AddBlock(initial_capacity);
+}
+
+Arena::~Arena()
+{
+    FreeBlocks();
+}
+
+void Arena::Reset()
+{
+    if (blocks_.size() > 1)
+    {
+        const size_t capacity = GetCapacity();
+        FreeBlocks();
+        AddBlock(capacity);
+    }
+
+    current_ = 0;
+    used_in_current_ = 0;
+    used_before_current_ = 0;
+}
+
+size_t Arena::GetUsedSize() const noexcept
+{
+    return used_before_current_ + used_in_current_;
+}
+
+size_t Arena::GetCapacity() const noexcept
+{
+    size_t capacity = 0;
+    for (const Block& block : blocks_) capacity += block.size;
+    return capacity;
+}
+
+void* Arena::do_allocate(size_t bytes, size_t alignment)
+{
+    if (!blocks_.empty())
+    {
+        const Block& block = blocks_[current_];
+        void* p = block.data + used_in_current_;
+        size_t space = block.size - used_in_current_;
+        if (std::align(alignment, bytes, p, space) != nullptr)
+        {
+            used_in_current_ = block.size - space + bytes;
+            return p;
+        }
+    }
+
+    NextBlock(bytes, alignment);
+
+    const Block& block = blocks_[current_];
+    void* p = block.data;
+    size_t space = block.size;
+    [[maybe_unused]] const void* aligned = std::align(alignment, bytes, p, space);
+    assert(aligned != nullptr);
+    used_in_current_ = block.size - space + bytes;
+    return p;
+}
+
+void Arena::do_deallocate(void*, size_t, size_t) {}
+
+bool Arena::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+void Arena::NextBlock(size_t bytes, size_t alignment)
+{
+    AddBlock(std::max({kMinBlockSize, GetCapacity(), bytes + alignment}));
+
+    if (blocks_.size() > 1)
+    {
+        used_before_current_ += used_in_current_;
+        current_ = blocks_.size() - 1;
+    }
+
+    used_in_current_ = 0;
+}
+
+void Arena::AddBlock(size_t size)
+{
+    auto* data = static_cast<std::byte*>(upstream_->allocate(size, kBlockAlignment));
+    blocks_.push_back({.data = data, .size = size});
+}
+
+void Arena::FreeBlocks() noexcept
+{
+    for (const Block& block : blocks_) upstream_->deallocate(block.data, block.size, kBlockAlignment);
+    blocks_.clear();
+}
+
+}  // namespace kaleidoscope
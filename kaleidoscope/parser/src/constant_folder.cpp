@@ -0,0 +1,140 @@
+#include "kaleidoscope/parser/constant_folder.hpp"
+
+#include <cassert>
+#include <limits>
+
+#include "kaleidoscope/lexer/checked_arithmetic.hpp"
+
+namespace kaleidoscope
+{
+
+namespace
+{
+
+[[nodiscard]] constexpr bool FitsInto(int64_t value, const BuiltinTypeInfo& type) noexcept
+{
+    if (type.bits >= 64) return true;
+    const int64_t max = (int64_t{1} << (type.bits - 1)) - 1;
+    return value >= -max - 1 && value <= max;
+}
+
+[[nodiscard]] constexpr bool IsConstant(const ExprAstStorage& exprs, ExprId id, int64_t value) noexcept
+{
+    if (id.type != ExprType::IntegralLiteral) return false;
+    return exprs.GetNodes<IntegralLiteralExprAST>()[id.index].GetSignedValue() == value;
+}
+
+}  // namespace
+
+ExprId ConstantFolder::Fold(ExprAstStorage& exprs, ExprId root)
+{
+    const size_t count = exprs.GetNodes<BinaryOperatorExpression>().size();
+    assert(folded_.size() <= count);  // The storage was cleared without Clear()
+    for (size_t i = folded_.size(); i != count; ++i)
+    {
+        folded_.push_back(FoldBinaryOperator(exprs, static_cast<uint32_t>(i)));
+    }
+
+    return GetFolded(root);
+}
+
+ExprId ConstantFolder::FoldBinaryOperator(ExprAstStorage& exprs, uint32_t index)
+{
+    BinaryOperatorExpression& expr = exprs.GetNodes<BinaryOperatorExpression>()[index];
+    expr.left = GetFolded(expr.left);
+    expr.right = GetFolded(expr.right);
+
+    if (expr.left.type == ExprType::IntegralLiteral && expr.right.type == ExprType::IntegralLiteral)
+    {
+        // Copies: evaluation appends to the storage
+        const IntegralLiteralExprAST left = exprs.GetNodes<IntegralLiteralExprAST>()[expr.left.index];
+        const IntegralLiteralExprAST right = exprs.GetNodes<IntegralLiteralExprAST>()[expr.right.index];
+        if (const auto folded = Evaluate(exprs, index, left, right)) return *folded;
+    }
+
+    return Simplify(exprs, index).value_or(ExprId{.type = ExprType::BinaryOperator, .index = index});
+}
+
+std::optional<ExprId> ConstantFolder::Evaluate(
+    ExprAstStorage& exprs,
+    uint32_t index,
+    const IntegralLiteralExprAST& left,
+    const IntegralLiteralExprAST& right)
+{
+    if (left.type != right.type || left.type.type != BuiltinType::SignedInteger) return std::nullopt;
+
+    const ExprId self{.type = ExprType::BinaryOperator, .index = index};
+    const int64_t a = left.GetSignedValue();
+    const int64_t b = right.GetSignedValue();
+    if (!FitsInto(a, left.type) || !FitsInto(b, right.type))
+    {
+        errors_.push_back({.expr = self, .type = FoldingErrorType::IntegerOverflow});
+        return std::nullopt;
+    }
+
+    std::optional<int64_t> result;
+    switch (exprs.GetNodes<BinaryOperatorExpression>()[index].type)
+    {
+    case BinaryOperatorType::Plus:
+        result = CheckedAdd(a, b);
+        break;
+    case BinaryOperatorType::Minus:
+        result = CheckedSubtract(a, b);
+        break;
+    case BinaryOperatorType::Multiply:
+        result = CheckedMultiply(a, b);
+        break;
+    case BinaryOperatorType::Divide:
+        if (b == 0)
+        {
+            errors_.push_back({.expr = self, .type = FoldingErrorType::DivisionByZero});
+            return std::nullopt;
+        }
+
+        if (a != std::numeric_limits<int64_t>::min() || b != -1) result = a / b;
+        break;
+    }
+
+    if (!result.has_value() || !FitsInto(*result, left.type))
+    {
+        errors_.push_back({.expr = self, .type = FoldingErrorType::IntegerOverflow});
+        return std::nullopt;
+    }
+
+    return exprs.Add(IntegralLiteralExprAST{.value = static_cast<uint64_t>(*result), .type = left.type});
+}
+
+std::optional<ExprId> ConstantFolder::Simplify(ExprAstStorage& exprs, uint32_t index)
+{
+    const BinaryOperatorExpression expr = exprs.GetNodes<BinaryOperatorExpression>()[index];
+    const ExprId left = expr.left;
+    const ExprId right = expr.right;
+
+    switch (expr.type)
+    {
+    case BinaryOperatorType::Plus:
+        if (IsConstant(exprs, right, 0)) return left;
+        if (IsConstant(exprs, left, 0)) return right;
+        break;
+    case BinaryOperatorType::Minus:
+        if (IsConstant(exprs, right, 0)) return left;
+        if (left == right)
+        {
+            return exprs.Add(IntegralLiteralExprAST{.value = 0, .type = GetResultType(exprs, left)});
+        }
+        break;
+    case BinaryOperatorType::Multiply:
+        if (IsConstant(exprs, right, 1)) return left;
+        if (IsConstant(exprs, left, 1)) return right;
+        if (IsConstant(exprs, right, 0)) return right;
+        if (IsConstant(exprs, left, 0)) return left;
+        break;
+    case BinaryOperatorType::Divide:
+        if (IsConstant(exprs, right, 1)) return left;
+        break;
+    }
+
+    return std::nullopt;
+}
+
+}  // namespace kaleidoscope
@@ -0,0 +1,32 @@
+#include "kaleidoscope/parser/expr_interner.hpp"
+
+#include <algorithm>
+
+namespace kaleidoscope
+{
+
+void ExprInterner::Clear() noexcept
+{
+    std::ranges::fill(slots_, Slot{});
+    size_ = 0;
+}
+
+void ExprInterner::Grow()
+{
+    constexpr size_t kInitialSlotCount = 256;
+
+    std::pmr::vector<Slot> new_slots(std::max(kInitialSlotCount, slots_.size() * 2), slots_.get_allocator());
+    const size_t mask = new_slots.size() - 1;
+    for (const Slot& slot : slots_)
+    {
+        if (slot.index_plus_one == 0) continue;
+
+        size_t i = slot.hash & mask;
+        while (new_slots[i].index_plus_one != 0) i = (i + 1) & mask;
+        new_slots[i] = slot;
+    }
+
+    slots_ = std::move(new_slots);
+}
+
+}  // namespace kaleidoscope
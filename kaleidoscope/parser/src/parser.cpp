@@ -0,0 +1,62 @@
+#include "kaleidoscope/parser/parser.hpp"
+
+namespace kaleidoscope
+{
+
+ExprId Parser::AddIntegralLiteral(uint64_t value)
+{
+    return AddNode(IntegralLiteralExprAST{
+        .value = value,
+        .type = {.type = BuiltinType::SignedInteger, .bits = 32},
+    });
+}
+
+void Parser::ReduceTop()
+{
+    assert(operands_.size() >= 2 && !operators_.empty() && operators_.back() != PendingOperator::OpenParen);
+
+    const ExprId right = operands_.back();
+    operands_.pop_back();
+    const auto type = static_cast<BinaryOperatorType>(operators_.back());
+    operators_.pop_back();
+
+    operands_.back() = AddNode(BinaryOperatorExpression{
+        .left = operands_.back(),
+        .right = right,
+        .type = type,
+    });
+}
+
+void Parser::PushOperator(BinaryOperatorType op)
+{
+    const uint8_t precedence = GetBinaryOperatorPrecedence(op);
+    while (!operators_.empty() && operators_.back() != PendingOperator::OpenParen &&
+           GetBinaryOperatorPrecedence(static_cast<BinaryOperatorType>(operators_.back())) >= precedence)
+    {
+        ReduceTop();
+    }
+
+    operators_.push_back(static_cast<PendingOperator>(op));
+}
+
+bool Parser::ReduceParenthesized()
+{
+    if (open_parens_ == 0) return false;
+
+    while (operators_.back() != PendingOperator::OpenParen) ReduceTop();
+    operators_.pop_back();
+    --open_parens_;
+    return true;
+}
+
+ExprASTResult Parser::FinishExpression()
+{
+    if (open_parens_ != 0) return std::unexpected(ParserErrorType::UnexpectedToken);
+
+    while (!operators_.empty()) ReduceTop();
+
+    assert(operands_.size() == 1);
+    return operands_.back();
+}
+
+}  // namespace kaleidoscope